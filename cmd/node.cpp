@@ -30,6 +30,7 @@
 #include <infra/common/stopwatch.hpp>
 #include <infra/concurrency/context.hpp>
 #include <infra/database/access_layer.hpp>
+#include <infra/database/header_index.hpp>
 #include <infra/database/mdbx_tables.hpp>
 #include <infra/network/time.hpp>
 #include <infra/os/signals.hpp>
@@ -147,6 +148,21 @@ int main(int argc, char* argv[]) {
         prepare_chaindata_env(settings, true);
         auto chaindata_env{db::open_env(settings.chaindata_env_config)};
 
+        // Load the in memory index of headers
+        boost::timer::cpu_timer header_index_timer;
+        db::HeaderIndex header_index((*settings.data_directory)[DataDirectory::kChainDataName].path() / "headers.idx");
+        {
+            const auto genesis_hash{h256::from_hex(settings.chain_config->genesis_hash_, /*reverse=*/true)};
+            success_or_throw(genesis_hash);
+            db::ROTxn txn(chaindata_env);
+            header_index.load(*txn, genesis_hash.value());
+        }
+        header_index_timer.stop();
+        std::ignore = log::Message(
+            "Loaded headers index",
+            {"headers", std::to_string(header_index.size()), "mapped", std::to_string(header_index.mapped_size()),
+             "elapsed", boost::replace_all_copy(std::string(header_index_timer.format()), "\n", "")});
+
         // Start boost asio with the number of threads specified by the concurrency hint
         con::Context context("main", settings.asio_concurrency);  // Initialize asio context
         context.start();
@@ -179,6 +195,8 @@ int main(int argc, char* argv[]) {
 
         // 1) Instantiate and start a new NodeHub
         net::NodeHub node_hub{settings, *context};
+        node_hub.set_headers_server(
+            std::make_unique<net::HeadersServer>(chaindata_env, header_index, settings.chain_config->magic_));
         node_hub.start();
 
         // Keep waiting till sync_loop stops
@@ -233,6 +251,7 @@ int main(int argc, char* argv[]) {
 
         node_hub.stop();  // 1) Stop networking server
 
+        header_index.save();
         std::ignore = log::Message("Closing database", {"path", chaindata_dir.path().string()});
         chaindata_env.close();
         // sync_loop.rethrow();  // Eventually throws the exception which caused the stop
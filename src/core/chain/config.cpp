@@ -17,10 +17,14 @@
 
 #include "config.hpp"
 
+#include <utility>
+
 #include <absl/strings/str_cat.h>
 #include <boost/algorithm/string/predicate.hpp>
 #include <magic_enum.hpp>
 
+#include <core/crypto/equihash.hpp>
+
 namespace znode {
 
 namespace {
@@ -42,8 +46,10 @@ nlohmann::json ChainConfig::to_json() const noexcept {
     auto consensus_name{std::string(magic_enum::enum_name(seal_engine_type_))};
     consensus_name.erase(consensus_name.find('k'), 1);
     consensus_object[consensus_name] = nlohmann::json::object();
-    consensus_object[consensus_name]["K"] = 200U;  // TODO: this is not constant
-    consensus_object[consensus_name]["N"] = 9U;    // TODO: this is not constant
+    if (seal_engine_type_ == SealEngineType::kEquihash) {
+        consensus_object[consensus_name]["N"] = equihash_n_;
+        consensus_object[consensus_name]["K"] = equihash_k_;
+    }
 
     ret["consensus"] = consensus_object;
     return ret;
@@ -60,17 +66,38 @@ std::optional<ChainConfig> ChainConfig::from_json(const nlohmann::json& json) no
     config.default_port_ = json["defaultPort"].get<uint16_t>();
 
     if (json.contains("consensus")) {
-        auto consensus_object{json["consensus"].get<nlohmann::json>()};
+        // https://github.com/nlohmann/json/issues/2204 (brace initialization would wrap the object into an array)
+        const auto consensus_object = json["consensus"];
         if (consensus_object.is_object()) {
             for (const auto& [key, value] : consensus_object.items()) {
                 if (value.is_object()) {
                     const auto consensus_name{absl::StrCat("k", key)};
-                    config.seal_engine_type_ = magic_enum::enum_cast<SealEngineType>(consensus_name).value();
+                    const auto seal_engine_type{magic_enum::enum_cast<SealEngineType>(consensus_name)};
+                    if (not seal_engine_type.has_value()) return std::nullopt;
+                    config.seal_engine_type_ = seal_engine_type.value();
+                    if (value.contains("N") and value.contains("K")) {
+                        config.equihash_n_ = value["N"].get<uint32_t>();
+                        config.equihash_k_ = value["K"].get<uint32_t>();
+                    }
                 }
             }
         }
     }
 
+    // Former versions persisted Equihash parameters swapped (N=9 K=200) : never hand out invalid ones
+    if (config.seal_engine_type_ == SealEngineType::kEquihash and
+        not crypto::Equihash::is_valid_parameters(config.equihash_n_, config.equihash_k_)) {
+        if (const auto known_chain{lookup_known_chain(config.identifier_)};
+            known_chain.has_value() and known_chain->second->seal_engine_type_ == SealEngineType::kEquihash) {
+            config.equihash_n_ = known_chain->second->equihash_n_;
+            config.equihash_k_ = known_chain->second->equihash_k_;
+        } else if (crypto::Equihash::is_valid_parameters(config.equihash_k_, config.equihash_n_)) {
+            std::swap(config.equihash_n_, config.equihash_k_);
+        } else {
+            return std::nullopt;
+        }
+    }
+
     return config;
 }
 
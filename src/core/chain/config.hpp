@@ -41,6 +41,8 @@ class ChainConfig {
     std::array<uint8_t, 4> magic_{0};  // The magic bytes to identify the chain on messages
     uint16_t default_port_{0};         // The default port to use for peer-to-peer communication
     SealEngineType seal_engine_type_{SealEngineType::kNoProof};  // The type of seal engine used by the chain
+    uint32_t equihash_n_{0};                                     // Equihash N parameter (if seal engine is Equihash)
+    uint32_t equihash_k_{0};                                     // Equihash K parameter (if seal engine is Equihash)
     std::string_view genesis_hash_;                              // The hash of the genesis block
     std::string_view merkle_root_hash_;                          // The hash of the merkle root of the genesis block
 
@@ -59,6 +61,8 @@ inline constexpr ChainConfig kMainNetConfig{
     .magic_ = {0x63U, 0x61U, 0x73U, 0x68U},
     .default_port_ = 9033U,
     .seal_engine_type_ = SealEngineType::kEquihash,
+    .equihash_n_ = 200U,
+    .equihash_k_ = 9U,
     // TODO : are those reversed ?
     .genesis_hash_ = "0x0007104ccda289427919efc39dc9e4d499804b7bebc22df55f8b834301260602",
     .merkle_root_hash_ = "0x19612bcf00ea7611d315d7f43554fa983c6e8c30cba17e52c679e0e80abf7d42"};
@@ -68,6 +72,8 @@ inline constexpr ChainConfig kTestNetConfig{
     .magic_ = {0xbfU, 0xf2U, 0xcdU, 0xe6U},
     .default_port_ = 19033U,
     .seal_engine_type_ = SealEngineType::kEquihash,
+    .equihash_n_ = 200U,
+    .equihash_k_ = 9U,
     // TODO : are those reversed ?
     .genesis_hash_ = "0x03e1c4bb705c871bf9bfda3e74b7f8f86bff267993c215a89d5795e3708e5e1f",
     .merkle_root_hash_ = "0x19612bcf00ea7611d315d7f43554fa983c6e8c30cba17e52c679e0e80abf7d42"};
@@ -77,6 +83,8 @@ inline constexpr ChainConfig kRegTestConfig{
     .magic_ = {0x2fU, 0x54U, 0xccU, 0x9dU},
     .default_port_ = 19133U,
     .seal_engine_type_ = SealEngineType::kEquihash,
+    .equihash_n_ = 48U,
+    .equihash_k_ = 5U,
     // TODO : are those reversed ?
     .genesis_hash_ = "0x0da5ee723b7923feb580518541c6f098206330dbc711a6678922c11f2ccf1abb",
     .merkle_root_hash_ = "0x19612bcf00ea7611d315d7f43554fa983c6e8c30cba17e52c679e0e80abf7d42"};
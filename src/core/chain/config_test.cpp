@@ -0,0 +1,64 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <core/chain/config.hpp>
+
+namespace znode {
+
+TEST_CASE("Chain config from json", "[chain]") {
+    SECTION("Round trip") {
+        const auto config{ChainConfig::from_json(kMainNetConfig.to_json())};
+        REQUIRE(config.has_value());
+        CHECK(config->identifier_ == kMainNetConfig.identifier_);
+        CHECK(config->magic_ == kMainNetConfig.magic_);
+        CHECK(config->seal_engine_type_ == SealEngineType::kEquihash);
+        CHECK(config->equihash_n_ == 200U);
+        CHECK(config->equihash_k_ == 9U);
+    }
+
+    // As persisted by former versions
+    auto json = kMainNetConfig.to_json();
+    json["consensus"]["Equihash"]["N"] = 9U;
+    json["consensus"]["Equihash"]["K"] = 200U;
+
+    SECTION("Invalid parameters of a known chain") {
+        const auto config{ChainConfig::from_json(json)};
+        REQUIRE(config.has_value());
+        CHECK(config->equihash_n_ == kMainNetConfig.equihash_n_);
+        CHECK(config->equihash_k_ == kMainNetConfig.equihash_k_);
+
+        json["consensus"]["Equihash"].erase("N");
+        CHECK(ChainConfig::from_json(json)->equihash_n_ == kMainNetConfig.equihash_n_);
+    }
+
+    json["chainId"] = 1'000U;  // Unknown chain
+
+    SECTION("Swapped parameters of an unknown chain") {
+        const auto config{ChainConfig::from_json(json)};
+        REQUIRE(config.has_value());
+        CHECK(config->equihash_n_ == 200U);
+        CHECK(config->equihash_k_ == 9U);
+    }
+
+    SECTION("Invalid parameters of an unknown chain") {
+        json["consensus"]["Equihash"]["N"] = 7U;
+        json["consensus"]["Equihash"]["K"] = 7U;
+        CHECK_FALSE(ChainConfig::from_json(json).has_value());
+    }
+}
+}  // namespace znode
@@ -0,0 +1,108 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "pow.hpp"
+
+#include <algorithm>
+
+#include <core/common/assert.hpp>
+
+namespace znode {
+
+PowVerifier::PowVerifier(const ChainConfig& chain_config, std::optional<size_t> concurrency) {
+    if (chain_config.seal_engine_type_ == SealEngineType::kEquihash) {
+        ASSERT(crypto::Equihash::is_valid_parameters(chain_config.equihash_n_, chain_config.equihash_k_));
+        equihash_.emplace(chain_config.equihash_n_, chain_config.equihash_k_);
+    }
+    const size_t threads{std::max<size_t>(concurrency.value_or(std::thread::hardware_concurrency()), 1U)};
+    workers_.reserve(threads - 1U);
+    for (size_t i{1}; i < threads; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+PowVerifier::~PowVerifier() {
+    {
+        std::scoped_lock lock(mutex_);
+        stopping_ = true;
+    }
+    batch_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::vector<PowVerifier::Result> PowVerifier::verify(std::span<const BlockHeader> headers) {
+    std::vector<Result> results(headers.size(), Result::kValid);
+    if (headers.empty() or not equihash_.has_value()) return results;
+    if (headers.size() == 1U or workers_.empty()) {
+        std::ranges::transform(headers, results.begin(), [this](const auto& header) { return verify(header); });
+        return results;
+    }
+
+    std::scoped_lock submit_lock(submit_mutex_);
+    auto batch{std::make_shared<Batch>()};
+    batch->headers = headers;
+    batch->results = results;
+    {
+        std::scoped_lock lock(mutex_);
+        batch_ = batch;
+        ++batch_sequence_;
+    }
+    batch_cv_.notify_all();
+
+    process(*batch);
+
+    std::unique_lock lock(mutex_);
+    completed_cv_.wait(lock, [&batch] { return batch->processed_items == batch->headers.size(); });
+    batch_.reset();  // Workers still holding a reference will find nothing to claim
+    return results;
+}
+
+PowVerifier::Result PowVerifier::verify(const BlockHeader& header) const {
+    if (not equihash_.has_value()) return Result::kValid;
+    ser::SDataStream stream(ser::Scope::kHash, 0);
+    if (header.serialize_pow_input(stream).has_error()) return Result::kSerializationError;
+    return equihash_->verify(stream.contents(), header.solution) ? Result::kValid : Result::kInvalidSolution;
+}
+
+void PowVerifier::worker_loop() {
+    uint64_t last_sequence{0};
+    while (true) {
+        std::shared_ptr<Batch> batch;
+        {
+            std::unique_lock lock(mutex_);
+            batch_cv_.wait(lock, [this, &last_sequence] { return stopping_ or batch_sequence_ not_eq last_sequence; });
+            if (stopping_) return;
+            last_sequence = batch_sequence_;
+            batch = batch_;
+        }
+        if (batch) process(*batch);
+    }
+}
+
+void PowVerifier::process(Batch& batch) {
+    const size_t items{batch.headers.size()};
+    for (size_t i{batch.next_item++}; i < items; i = batch.next_item++) {
+        batch.results[i] = verify(batch.headers[i]);
+        if (++batch.processed_items == items) {
+            std::scoped_lock lock(mutex_);
+            completed_cv_.notify_all();
+        }
+    }
+}
+
+}  // namespace znode
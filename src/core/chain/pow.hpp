@@ -0,0 +1,92 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <core/chain/config.hpp>
+#include <core/crypto/equihash.hpp>
+#include <core/types/block.hpp>
+
+namespace znode {
+
+//! \brief Verifies the proof of work (i.e. the Equihash solution) of block headers in parallel
+//! \details Verification is CPU bound and independent for each header hence a batch is spread over a pool of
+//! threads (sized after the machine by default) the submitting thread takes part into. Idle threads claim the
+//! next unverified header of the batch, so that the load balances without any per thread queue.
+//! Batches are served one at a time: concurrent submitters wait their turn.
+class PowVerifier {
+  public:
+    enum class Result : uint8_t {
+        kValid,
+        kInvalidSolution,
+        kSerializationError,
+    };
+
+    //! \brief Instantiates a verifier for the seal engine of the provided chain
+    //! \param concurrency The overall number of verifying threads (the submitting one included). When not provided
+    //! hardware concurrency is used
+    explicit PowVerifier(const ChainConfig& chain_config, std::optional<size_t> concurrency = std::nullopt);
+    ~PowVerifier();
+
+    // Not copyable nor movable
+    PowVerifier(const PowVerifier& other) = delete;
+    PowVerifier(PowVerifier&& other) = delete;
+    PowVerifier& operator=(const PowVerifier& other) = delete;
+    PowVerifier& operator=(PowVerifier&& other) = delete;
+
+    //! \brief Verifies the proof of work of a batch of headers
+    //! \returns The result for each header in the same order of the input
+    //! \remarks Blocks until the whole batch has been verified
+    [[nodiscard]] std::vector<Result> verify(std::span<const BlockHeader> headers);
+
+    //! \brief Verifies the proof of work of a single header (on the calling thread)
+    [[nodiscard]] Result verify(const BlockHeader& header) const;
+
+    //! \brief Returns the overall number of verifying threads (the submitting one included)
+    [[nodiscard]] size_t concurrency() const noexcept { return workers_.size() + 1U; }
+
+  private:
+    struct Batch {
+        std::span<const BlockHeader> headers;
+        std::span<Result> results;
+        std::atomic_size_t next_item{0};        // Index of the next header to be claimed
+        std::atomic_size_t processed_items{0};  // Number of headers already verified
+    };
+
+    void worker_loop();
+    void process(Batch& batch);
+
+    std::optional<crypto::Equihash> equihash_;  // Not set when the chain has no proof of work
+    std::vector<std::thread> workers_;
+
+    std::mutex submit_mutex_;                // Serializes submitters
+    std::mutex mutex_;                       // Guards the members below
+    std::condition_variable batch_cv_;       // Signals workers a new batch is available (or stop)
+    std::condition_variable completed_cv_;   // Signals the submitter the batch is complete
+    std::shared_ptr<Batch> batch_{nullptr};  // The batch being processed
+    uint64_t batch_sequence_{0};             // Increments on every new batch
+    bool stopping_{false};
+};
+
+}  // namespace znode
@@ -0,0 +1,61 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <core/chain/pow.hpp>
+#include <core/crypto/equihash_test.hpp>
+#include <core/encoding/hex.hpp>
+
+namespace znode {
+
+static constexpr size_t kBatchSize{256};
+
+//! \brief Verifies batches of valid headers with the given overall concurrency (i.e. verifying threads)
+//! \details Reports verifications per second overall and per verifying thread
+template <size_t VectorIndex>
+void bench_pow_verifier(benchmark::State& state) {
+    const auto& vector{crypto::kEquihashTestVectors[VectorIndex]};
+    ChainConfig chain_config{kMainNetConfig};
+    chain_config.equihash_n_ = vector.n;
+    chain_config.equihash_k_ = vector.k;
+
+    std::vector<BlockHeader> headers(kBatchSize, crypto::make_equihash_test_header(vector.nonce));
+    const auto solution{enc::hex::decode(vector.solution).value()};
+    std::ranges::for_each(headers, [&solution](auto& header) { header.solution = solution; });
+
+    const auto concurrency{static_cast<size_t>(state.range(0))};
+    PowVerifier verifier(chain_config, concurrency);
+    for ([[maybe_unused]] auto _ : state) {
+        auto results{verifier.verify(headers)};
+        benchmark::DoNotOptimize(results);
+    }
+
+    const auto verifications{static_cast<double>(state.iterations()) * static_cast<double>(kBatchSize)};
+    state.counters["verifications/s"] = benchmark::Counter(verifications, benchmark::Counter::kIsRate);
+    state.counters["verifications/s/core"] =
+        benchmark::Counter(verifications / static_cast<double>(concurrency), benchmark::Counter::kIsRate);
+}
+
+static const auto kMaxThreads{static_cast<int64_t>(std::max(1U, std::thread::hardware_concurrency()))};
+BENCHMARK_TEMPLATE(bench_pow_verifier, 0)->RangeMultiplier(2)->Range(1, kMaxThreads)->UseRealTime();  // 200,9
+BENCHMARK_TEMPLATE(bench_pow_verifier, 1)->RangeMultiplier(2)->Range(1, kMaxThreads)->UseRealTime();  // 192,7
+
+}  // namespace znode
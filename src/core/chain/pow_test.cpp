@@ -0,0 +1,73 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <core/chain/pow.hpp>
+#include <core/crypto/equihash_test.hpp>
+#include <core/encoding/hex.hpp>
+
+namespace znode {
+
+namespace {
+    //! \brief Returns a batch of headers alternating valid and invalid ones
+    std::vector<BlockHeader> make_headers_batch(const crypto::EquihashTestVector& vector, size_t size) {
+        std::vector<BlockHeader> ret;
+        for (size_t i{0}; i < size; ++i) {
+            auto& header{ret.emplace_back(crypto::make_equihash_test_header(vector.nonce))};
+            header.solution = enc::hex::decode(vector.solution).value();
+            if (i % 2U not_eq 0U) header.nonce += 1;
+        }
+        return ret;
+    }
+}  // namespace
+
+TEST_CASE("PowVerifier", "[chain]") {
+    const auto& vector{crypto::kEquihashTestVectors[0]};
+    ChainConfig chain_config{kMainNetConfig};
+    REQUIRE(chain_config.equihash_n_ == vector.n);
+    REQUIRE(chain_config.equihash_k_ == vector.k);
+
+    const auto headers{make_headers_batch(vector, 33)};
+    for (const size_t concurrency : {1U, 2U, 4U}) {
+        PowVerifier verifier(chain_config, concurrency);
+        CHECK(verifier.concurrency() == concurrency);
+        CHECK(verifier.verify(headers.front()) == PowVerifier::Result::kValid);
+        CHECK(verifier.verify(headers.back()) == PowVerifier::Result::kValid);
+        CHECK(verifier.verify(headers[1]) == PowVerifier::Result::kInvalidSolution);
+
+        // Subsequent batches reuse the same pool
+        for (int run{0}; run < 3; ++run) {
+            const auto results{verifier.verify(headers)};
+            REQUIRE(results.size() == headers.size());
+            for (size_t i{0}; i < results.size(); ++i) {
+                CHECK(results[i] == (i % 2U == 0U ? PowVerifier::Result::kValid
+                                                  : PowVerifier::Result::kInvalidSolution));
+            }
+        }
+        CHECK(verifier.verify(std::span<const BlockHeader>{}).empty());
+    }
+
+    // No proof of work to verify
+    chain_config.seal_engine_type_ = SealEngineType::kNoProof;
+    PowVerifier verifier(chain_config, 2U);
+    const auto results{verifier.verify(headers)};
+    CHECK(std::ranges::all_of(results, [](const auto result) { return result == PowVerifier::Result::kValid; }));
+}
+
+}  // namespace znode
@@ -0,0 +1,93 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <vector>
+
+#include <core/common/assert.hpp>
+
+namespace znode {
+
+//! \brief A binary indexed (Fenwick) tree of non negative weights
+//! \details Updating a weight, computing a prefix sum and finding which item a cumulative weight falls into all cost
+//! O(log n) : this allows drawing items with a probability proportional to their weight in O(log n) no matter how
+//! many of them weigh zero.
+//! \remarks Weights are unsigned integers : updates rely on modular arithmetic hence the sum of all the weights must
+//! fit into T. Not thread safe
+template <std::unsigned_integral T>
+class FenwickTree {
+  public:
+    explicit FenwickTree(size_t size) : tree_(size + 1U, T{0}) {}
+
+    //! \brief Returns the number of items
+    [[nodiscard]] size_t size() const noexcept { return tree_.size() - 1U; }
+
+    //! \brief Returns the sum of all the weights
+    [[nodiscard]] T total() const noexcept { return total_; }
+
+    //! \brief Returns the sum of the weights of the first count items
+    [[nodiscard]] T prefix_sum(size_t count) const noexcept {
+        ASSERT_PRE(count <= size());
+        T ret{0};
+        for (; count not_eq 0U; count &= count - 1U) ret += tree_[count];
+        return ret;
+    }
+
+    //! \brief Returns the weight of an item
+    [[nodiscard]] T weight(size_t index) const noexcept { return prefix_sum(index + 1U) - prefix_sum(index); }
+
+    //! \brief Sets the weight of an item
+    void set(size_t index, T weight) noexcept {
+        ASSERT_PRE(index < size());
+        const T delta{static_cast<T>(weight - this->weight(index))};  // Wraps around when decreasing
+        if (delta == 0U) return;
+        for (auto position{index + 1U}; position < tree_.size(); position += position & (~position + 1U)) {
+            tree_[position] += delta;
+        }
+        total_ += delta;
+    }
+
+    //! \brief Returns the index of the item the cumulative weight falls into (i.e. the first item for which
+    //! prefix_sum(index + 1) > cumulative_weight)
+    //! \remarks cumulative_weight must be lower than total() : items weighing zero are never returned
+    [[nodiscard]] size_t find(T cumulative_weight) const noexcept {
+        ASSERT_PRE(cumulative_weight < total_);
+        size_t position{0};
+        for (auto step{std::bit_floor(size())}; step not_eq 0U; step >>= 1U) {
+            if (position + step < tree_.size() and tree_[position + step] <= cumulative_weight) {
+                position += step;
+                cumulative_weight -= tree_[position];
+            }
+        }
+        return position;
+    }
+
+    //! \brief Sets all the weights to zero
+    void clear() noexcept {
+        std::fill(tree_.begin(), tree_.end(), T{0});
+        total_ = 0U;
+    }
+
+  private:
+    std::vector<T> tree_;  // Partial sums (1 based)
+    T total_{0};           // Sum of all the weights
+};
+
+}  // namespace znode
@@ -0,0 +1,85 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <cstdint>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <core/common/fenwick_tree.hpp>
+#include <core/common/random.hpp>
+
+namespace znode {
+
+TEST_CASE("Fenwick Tree", "[memory]") {
+    FenwickTree<uint32_t> tree(10);
+    CHECK(tree.size() == 10U);
+    CHECK(tree.total() == 0U);
+
+    tree.set(0, 3);
+    tree.set(4, 5);
+    tree.set(9, 2);
+    CHECK(tree.total() == 10U);
+    CHECK(tree.weight(4) == 5U);
+    CHECK(tree.weight(5) == 0U);
+    CHECK(tree.prefix_sum(0) == 0U);
+    CHECK(tree.prefix_sum(5) == 8U);
+    CHECK(tree.prefix_sum(10) == 10U);
+
+    // Cumulative weights map onto items skipping the ones weighing zero
+    CHECK(tree.find(0) == 0U);
+    CHECK(tree.find(2) == 0U);
+    CHECK(tree.find(3) == 4U);
+    CHECK(tree.find(7) == 4U);
+    CHECK(tree.find(8) == 9U);
+    CHECK(tree.find(9) == 9U);
+
+    // Decreasing a weight
+    tree.set(4, 1);
+    CHECK(tree.total() == 6U);
+    CHECK(tree.find(3) == 4U);
+    CHECK(tree.find(4) == 9U);
+
+    tree.clear();
+    CHECK(tree.total() == 0U);
+    CHECK(tree.weight(0) == 0U);
+}
+
+TEST_CASE("Fenwick Tree random updates", "[memory]") {
+    // Non power of two size to exercise the boundaries of find
+    constexpr size_t kSize{1'000};
+    FenwickTree<uint32_t> tree(kSize);
+    std::vector<uint32_t> weights(kSize, 0U);
+    for (int round{0}; round < 10'000; ++round) {
+        const auto index{randomize<size_t>(size_t{0}, kSize - 1U)};
+        weights[index] = randomize<uint32_t>(0U, 3U) == 0U ? 0U : randomize<uint32_t>(1U, 1'000U);
+        tree.set(index, weights[index]);
+    }
+
+    uint32_t sum{0};
+    for (size_t index{0}; index < kSize; ++index) {
+        CHECK(tree.weight(index) == weights[index]);
+        if (weights[index] not_eq 0U) {
+            CHECK(tree.find(sum) == index);
+            CHECK(tree.find(sum + weights[index] - 1U) == index);
+        }
+        sum += weights[index];
+        CHECK(tree.prefix_sum(index + 1U) == sum);
+    }
+    CHECK(tree.total() == sum);
+}
+
+}  // namespace znode
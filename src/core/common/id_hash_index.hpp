@@ -0,0 +1,130 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <core/common/assert.hpp>
+
+namespace znode {
+
+//! \brief A hash index of ids whose keys are held by an external storage (e.g. a vector of entries by id)
+//! \details Open addressing with linear probing over a power of two sized table storing the ids only (4 bytes per
+//! slot) : keys are retrieved through KeyOf whenever needed. The table is doubled whenever it gets half full and
+//! erasures shift back the following items so no tombstones are left behind.
+//! \remarks Id 0 marks empty slots hence can't be indexed. The key of an id must not change while the id is indexed
+//! and the storage must be able to return the key of any indexed id (also while erasing). Not thread safe
+template <class Key, class KeyOf, class Hasher = std::hash<Key>, class Allocator = std::allocator<uint32_t>>
+class IdHashIndex {
+  public:
+    explicit IdHashIndex(KeyOf key_of, Hasher hasher = Hasher{})
+        : key_of_{std::move(key_of)}, hasher_{std::move(hasher)} {}
+    ~IdHashIndex() = default;
+
+    // Not copyable nor movable (KeyOf usually refers to the owner of the index)
+    IdHashIndex(const IdHashIndex&) = delete;
+    IdHashIndex& operator=(const IdHashIndex&) = delete;
+
+    //! \brief Returns the id bound to the key or 0 if none
+    [[nodiscard]] uint32_t find(const Key& key) const noexcept {
+        if (size_ == 0U) return 0U;
+        return table_[locate(key)];
+    }
+
+    [[nodiscard]] bool contains(const Key& key) const noexcept { return find(key) not_eq 0U; }
+
+    //! \brief Indexes an id by the key KeyOf returns for it
+    //! \return false if the key is already indexed
+    bool insert(uint32_t id) {
+        ASSERT(id not_eq 0U);
+        if ((size_ + 1U) * 2U > table_.size()) grow();
+        const auto position{locate(key_of_(id))};
+        if (table_[position] not_eq 0U) return false;
+        table_[position] = id;
+        ++size_;
+        return true;
+    }
+
+    //! \brief Removes a key from the index
+    //! \return false if the key was not indexed
+    bool erase(const Key& key) noexcept {
+        if (size_ == 0U) return false;
+        auto position{locate(key)};
+        if (table_[position] == 0U) return false;
+        table_[position] = 0U;
+        --size_;
+
+        // Shift back the items of the same cluster which would otherwise become unreachable
+        const auto mask{table_.size() - 1U};
+        for (auto next{(position + 1U) & mask}; table_[next] not_eq 0U; next = (next + 1U) & mask) {
+            const auto home{hasher_(key_of_(table_[next])) & mask};
+            if (((next - home) & mask) >= ((next - position) & mask)) {
+                table_[position] = std::exchange(table_[next], 0U);
+                position = next;
+            }
+        }
+        return true;
+    }
+
+    void clear() noexcept {
+        table_.clear();
+        size_ = 0U;
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0U; }
+
+    //! \brief Returns the number of slots in the table
+    [[nodiscard]] size_t capacity() const noexcept { return table_.size(); }
+
+  private:
+    //! \brief Returns the position of the slot holding the key or of the empty slot ending its probe sequence
+    [[nodiscard]] size_t locate(const Key& key) const noexcept {
+        const auto mask{table_.size() - 1U};
+        auto position{hasher_(key) & mask};
+        while (table_[position] not_eq 0U and not(key_of_(table_[position]) == key)) position = (position + 1U) & mask;
+        return position;
+    }
+
+    void grow() {
+        const auto capacity{std::max(kMinCapacity, table_.size() * 2U)};
+        const auto previous_table{std::exchange(table_, table_type(capacity, 0U))};
+        const auto mask{table_.size() - 1U};
+        for (const auto id : previous_table) {
+            if (id == 0U) continue;
+            auto position{hasher_(key_of_(id)) & mask};
+            while (table_[position] not_eq 0U) position = (position + 1U) & mask;
+            table_[position] = id;
+        }
+    }
+
+    static constexpr size_t kMinCapacity{16};
+    static_assert(std::has_single_bit(kMinCapacity));
+
+    using table_type = std::vector<uint32_t, Allocator>;
+    KeyOf key_of_;      // Returns the key of an id
+    Hasher hasher_;     // Hashes the keys
+    table_type table_;  // Ids (0 means empty slot)
+    size_t size_{0};    // Number of indexed ids
+};
+
+}  // namespace znode
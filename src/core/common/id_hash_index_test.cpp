@@ -0,0 +1,99 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <core/common/id_hash_index.hpp>
+#include <core/common/random.hpp>
+
+namespace znode {
+
+namespace {
+//! \brief Returns the key of an id from a vector of keys by id
+struct KeyById {
+    const std::vector<std::string>* keys;
+    const std::string& operator()(uint32_t id) const { return (*keys)[id]; }
+};
+
+//! \brief A poor hasher making most of the keys collide
+struct PoorHasher {
+    size_t operator()(const std::string& key) const noexcept { return key.size() % 4U; }
+};
+}  // namespace
+
+TEST_CASE("Id Hash Index", "[memory]") {
+    std::vector<std::string> keys{""};  // Id 0 is never used
+    IdHashIndex<std::string, KeyById> index{KeyById{&keys}};
+    CHECK(index.empty());
+    CHECK(index.find("missing") == 0U);
+    CHECK_FALSE(index.erase("missing"));
+
+    for (uint32_t id{1}; id <= 100U; ++id) {
+        keys.push_back("key_" + std::to_string(id));
+        CHECK(index.insert(id));
+    }
+    CHECK(index.size() == 100U);
+    CHECK(index.capacity() >= 200U);
+    for (uint32_t id{1}; id <= 100U; ++id) {
+        CHECK(index.find(keys[id]) == id);
+    }
+
+    // Same key under another id is not indexed
+    keys.push_back(keys[1]);
+    CHECK_FALSE(index.insert(101U));
+    CHECK(index.find(keys[1]) == 1U);
+
+    CHECK(index.erase(keys[50]));
+    CHECK_FALSE(index.contains(keys[50]));
+    CHECK(index.size() == 99U);
+
+    index.clear();
+    CHECK(index.empty());
+    CHECK(index.find(keys[1]) == 0U);
+}
+
+TEST_CASE("Id Hash Index with colliding keys", "[memory]") {
+    // Random inserts and erasures checked against a reference map : erasures in long clusters must keep all the
+    // remaining keys reachable
+    std::vector<std::string> keys{""};
+    IdHashIndex<std::string, KeyById, PoorHasher> index{KeyById{&keys}};
+    std::unordered_map<std::string, uint32_t> reference;
+    for (uint32_t id{1}; id <= 500U; ++id) {
+        keys.push_back(std::string(randomize<size_t>(size_t{1}, size_t{12}), 'a') + std::to_string(id));
+    }
+
+    for (int round{0}; round < 5'000; ++round) {
+        const auto id{randomize<uint32_t>(1U, 500U)};
+        if (reference.contains(keys[id])) {
+            CHECK(index.erase(keys[id]));
+            reference.erase(keys[id]);
+        } else {
+            CHECK(index.insert(id));
+            reference.emplace(keys[id], id);
+        }
+    }
+    CHECK(index.size() == reference.size());
+    for (uint32_t id{1}; id <= 500U; ++id) {
+        const auto it{reference.find(keys[id])};
+        CHECK(index.find(keys[id]) == (it == reference.end() ? 0U : it->second));
+    }
+}
+
+}  // namespace znode
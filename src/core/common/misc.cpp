@@ -17,19 +17,41 @@
 
 #include "misc.hpp"
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <regex>
-#include <set>
+#include <span>
+#include <vector>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/format.hpp>
 #include <gsl/gsl_util>
 
+#include <core/common/assert.hpp>
+#include <core/common/endian.hpp>
 #include <core/common/random.hpp>
 
 namespace znode {
 
+namespace {
+    //! \brief A fast (non cryptographic) seeded hash of an arbitrary chunk of data
+    uint64_t hash_data_chunk(ByteView chunk, uint64_t seed) noexcept {
+        static constexpr uint64_t kMultiplier{0x9e3779b97f4a7c15ULL};
+        uint64_t ret{seed ^ (chunk.size() * kMultiplier)};
+        while (chunk.size() >= sizeof(uint64_t)) {
+            ret = (ret ^ endian::load_little_u64(chunk.data())) * kMultiplier;
+            ret ^= ret >> 32;
+            chunk.remove_prefix(sizeof(uint64_t));
+        }
+        for (const auto byte : chunk) {
+            ret = (ret ^ byte) * kMultiplier;
+        }
+        return ret ^ (ret >> 29);
+    }
+}  // namespace
+
 std::string abridge(std::string_view input, size_t length) {
     if (input.length() <= length) return std::string(input);
     std::string abridged{input.substr(0, length)};
@@ -118,20 +140,53 @@ std::string get_random_alpha_string(size_t length) {
     return ret;
 }
 
-size_t count_duplicate_data_chunks(ByteView data, const size_t chunk_size, const size_t max_count) noexcept {
+size_t count_duplicate_data_chunks(ByteView data, const size_t chunk_size, const size_t max_count) {
     if (chunk_size == 0U or data.length() < chunk_size) {
         return 0;
     }
-    std::set<ByteView, std::less<>> unique_chunks;
-    size_t count{0};
     const size_t chunks{data.length() / chunk_size};
+    if (chunks == 1U) return 0;
+    ASSERT_PRE(chunks < std::numeric_limits<uint32_t>::max() and "Too many chunks");
+
+    // Open addressing (linear probing) table of chunk indexes (1 based as 0 means empty slot)
+    // Load factor is kept at most 50%. Small tables live on stack, larger ones on a per thread
+    // buffer which is reused hence, once warm, no allocation occurs.
+    static constexpr size_t kStackTableSize{1_KiB};
+    static THREAD_LOCAL std::vector<uint32_t> heap_table;
+    std::array<uint32_t, kStackTableSize> stack_table;  // Not initialized : only the used portion is zeroed
+    const size_t table_size{std::bit_ceil(chunks * 2)};
+    std::span<uint32_t> table;
+    if (table_size <= kStackTableSize) {
+        table = std::span<uint32_t>{stack_table.data(), table_size};
+    } else {
+        if (heap_table.size() < table_size) heap_table.resize(table_size);
+        table = std::span<uint32_t>{heap_table.data(), table_size};
+    }
+    std::ranges::fill(table, 0U);
+
+    // Chunks are likely hashes hence random enough but an adversary may still craft colliding ones:
+    // the seed makes colliding sets unpredictable
+    static const uint64_t seed{randomize<uint64_t>()};
+    const size_t mask{table_size - 1};
+    size_t count{0};
     for (size_t i{0}; i < chunks; ++i) {
         const auto chunk{data.substr(i * chunk_size, chunk_size)};
-        if (not unique_chunks.insert(chunk).second) {
-            ++count;
-            if (max_count not_eq 0U and count == max_count) {
+        size_t slot{static_cast<size_t>(hash_data_chunk(chunk, seed)) & mask};
+        bool duplicate{false};
+        while (table[slot] not_eq 0U) {
+            if (data.substr((table[slot] - 1U) * chunk_size, chunk_size) == chunk) {
+                duplicate = true;
                 break;
             }
+            slot = (slot + 1U) & mask;
+        }
+        if (not duplicate) {
+            table[slot] = static_cast<uint32_t>(i + 1U);
+            continue;
+        }
+        ++count;
+        if (max_count not_eq 0U and count == max_count) {
+            break;
         }
     }
     return count;
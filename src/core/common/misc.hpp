@@ -44,6 +44,8 @@ namespace znode {
 //! \brief Provided a view of data returns the number of duplicate chunks of given size
 //! \remarks If max_count is set to zero then the function will return the total number of duplicate chunks found
 //! otherwise it will stop counting and return as soon as max_count is reached
-[[nodiscard]] size_t count_duplicate_data_chunks(ByteView data, size_t chunk_size, size_t max_count = 0) noexcept;
+//! \remarks Runs in linear time over a hash table which lives on stack for small inputs or on a per thread reused
+//! buffer for larger ones (no allocations once warm)
+[[nodiscard]] size_t count_duplicate_data_chunks(ByteView data, size_t chunk_size, size_t max_count = 0);
 
 }  // namespace znode
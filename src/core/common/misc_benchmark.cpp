@@ -0,0 +1,62 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <set>
+
+#include <benchmark/benchmark.h>
+
+#include <core/common/base.hpp>
+#include <core/common/misc.hpp>
+#include <core/common/random.hpp>
+
+namespace znode {
+
+static constexpr size_t kChunkSize{36};  // Same as an inventory item
+
+namespace {
+    //! \brief The tree based implementation count_duplicate_data_chunks used to rely on
+    size_t count_duplicate_data_chunks_with_set(ByteView data, const size_t chunk_size) {
+        std::set<ByteView, std::less<>> unique_chunks;
+        size_t count{0};
+        for (size_t i{0}; i < data.length() / chunk_size; ++i) {
+            if (not unique_chunks.insert(data.substr(i * chunk_size, chunk_size)).second) ++count;
+        }
+        return count;
+    }
+}  // namespace
+
+void bench_duplicate_chunks(benchmark::State& state) {
+    const auto chunks{static_cast<size_t>(state.range(0))};
+    const auto data{get_random_bytes(chunks * kChunkSize)};
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(count_duplicate_data_chunks(data, kChunkSize));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(chunks));
+}
+
+void bench_duplicate_chunks_with_set(benchmark::State& state) {
+    const auto chunks{static_cast<size_t>(state.range(0))};
+    const auto data{get_random_bytes(chunks * kChunkSize)};
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(count_duplicate_data_chunks_with_set(data, kChunkSize));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(chunks));
+}
+
+BENCHMARK(bench_duplicate_chunks)->RangeMultiplier(10)->Range(1, 50'000);
+BENCHMARK(bench_duplicate_chunks_with_set)->RangeMultiplier(10)->Range(1, 50'000);
+
+}  // namespace znode
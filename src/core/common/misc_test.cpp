@@ -15,6 +15,7 @@
    limitations under the License.
 */
 
+#include <cstring>
 #include <vector>
 
 #include <catch2/catch.hpp>
@@ -104,4 +105,38 @@ TEST_CASE("abridge", "[misc]") {
     CHECK(abridge("Hello World", 5) == "Hello...");
     CHECK(abridge("Hello World", 7) == "Hello W...");
 }
+
+TEST_CASE("count_duplicate_data_chunks", "[misc]") {
+    static constexpr size_t kChunkSize{36};  // Same as an inventory item
+
+    CHECK(count_duplicate_data_chunks({}, kChunkSize) == 0);
+    CHECK(count_duplicate_data_chunks(Bytes(kChunkSize - 1, 0), kChunkSize) == 0);
+    CHECK(count_duplicate_data_chunks(Bytes(kChunkSize, 0), 0) == 0);
+    CHECK(count_duplicate_data_chunks(Bytes(kChunkSize, 0), kChunkSize) == 0);
+    CHECK(count_duplicate_data_chunks(Bytes(kChunkSize * 2, 0), kChunkSize) == 1);
+    CHECK(count_duplicate_data_chunks(Bytes(kChunkSize * 5, 0), kChunkSize) == 4);
+    CHECK(count_duplicate_data_chunks(Bytes(kChunkSize * 5, 0), kChunkSize, 2) == 2);
+
+    // Both small (on stack) and large (on heap) tables
+    for (const size_t chunks : {10U, 500U, 5'000U, 50'000U}) {
+        INFO("Chunks " << chunks);
+        Bytes data(chunks * kChunkSize, 0);
+        for (size_t i{0}; i < chunks; ++i) {
+            // Chunks differing only in the trailing bytes
+            data[(i + 1) * kChunkSize - 1] = static_cast<uint8_t>(i);
+            data[(i + 1) * kChunkSize - 2] = static_cast<uint8_t>(i >> 8);
+            data[(i + 1) * kChunkSize - 3] = static_cast<uint8_t>(i >> 16);
+        }
+        CHECK(count_duplicate_data_chunks(data, kChunkSize) == 0);
+
+        // Duplicate the first chunk into the last one
+        std::memcpy(&data[(chunks - 1) * kChunkSize], data.data(), kChunkSize);
+        CHECK(count_duplicate_data_chunks(data, kChunkSize) == 1);
+
+        // Trailing partial chunk is ignored
+        data.push_back(0);
+        CHECK(count_duplicate_data_chunks(data, kChunkSize) == 1);
+    }
+}
+
 }  // namespace znode
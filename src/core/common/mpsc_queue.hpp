@@ -0,0 +1,85 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <atomic>
+#include <optional>
+#include <utility>
+
+#include <boost/noncopyable.hpp>
+
+namespace znode {
+
+//! \brief An unbounded lock-free multiple producers single consumer FIFO queue
+//! \details Producers never block each other (a push is a single atomic exchange) and items pushed by the same
+//! producer are popped in the same order they've been pushed.
+//! \remarks Based on Dmitry Vyukov's non-intrusive MPSC node-based queue
+//! \attention Only one thread at a time can pop items from the queue
+//! \attention An item whose push is still in progress might not be visible to the consumer yet. Hence producers
+//! should signal the consumer after the push has returned (e.g. posting a task).
+template <typename T>
+class MpscQueue : private boost::noncopyable {
+  public:
+    MpscQueue() = default;
+    ~MpscQueue() {
+        while (pop().has_value()) {
+        }
+        if (tail_ not_eq &stub_) delete tail_;  // Last popped node acting as stub
+    }
+
+    //! \brief Appends an item to the queue
+    //! \remarks Safe to be called concurrently by multiple threads
+    void push(T item) {
+        auto* node{new Node{.value = std::move(item)}};
+        Node* prev{head_.exchange(node, std::memory_order_acq_rel)};
+        prev->next.store(node, std::memory_order_release);
+        size_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //! \brief Removes and returns the item in front of the queue (if any)
+    //! \remarks Must be called by the single consumer
+    [[nodiscard]] std::optional<T> pop() {
+        Node* tail{tail_};
+        Node* next{tail->next.load(std::memory_order_acquire)};
+        if (next == nullptr) return std::nullopt;
+        std::optional<T> ret{std::move(next->value)};
+        next->value.reset();
+        tail_ = next;  // Popped node becomes the new stub
+        if (tail not_eq &stub_) delete tail;
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return ret;
+    }
+
+    //! \brief Whether the queue has any item available to the consumer
+    //! \remarks Must be called by the single consumer
+    [[nodiscard]] bool empty() const noexcept { return tail_->next.load(std::memory_order_acquire) == nullptr; }
+
+    //! \brief Returns the approximate number of items in the queue
+    [[nodiscard]] size_t size() const noexcept { return size_.load(std::memory_order_relaxed); }
+
+  private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value{};
+    };
+
+    Node stub_{};                     // Initial empty node
+    std::atomic<Node*> head_{&stub_};  // Last pushed node (producers side)
+    Node* tail_{&stub_};               // Last consumed node (consumer side)
+    std::atomic<size_t> size_{0};      // Approximate number of items
+};
+
+}  // namespace znode
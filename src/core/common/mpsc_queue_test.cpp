@@ -0,0 +1,86 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <core/common/mpsc_queue.hpp>
+
+namespace znode {
+TEST_CASE("MPSC Queue", "[concurrency]") {
+    SECTION("Single thread") {
+        MpscQueue<std::unique_ptr<int>> queue;
+        CHECK(queue.empty());
+        CHECK_FALSE(queue.pop().has_value());
+        for (int i{0}; i < 10; ++i) {
+            queue.push(std::make_unique<int>(i));
+        }
+        CHECK(queue.size() == 10);
+        CHECK_FALSE(queue.empty());
+        for (int i{0}; i < 10; ++i) {
+            auto item{queue.pop()};
+            REQUIRE(item.has_value());
+            CHECK(**item == i);  // FIFO
+        }
+        CHECK(queue.empty());
+        CHECK(queue.size() == 0);
+
+        // Leftovers are released on destruction
+        queue.push(std::make_unique<int>(0));
+    }
+
+    SECTION("Nodes are released on destruction") {
+        auto item{std::make_shared<int>(0)};
+        {
+            MpscQueue<std::shared_ptr<int>> queue;
+            for (int i{0}; i < 3; ++i) queue.push(item);
+            REQUIRE(queue.pop().has_value());  // Last popped node becomes the stub
+            CHECK(item.use_count() == 3);
+        }
+        CHECK(item.use_count() == 1);  // Leaks are reported by LeakSanitizer
+    }
+
+    SECTION("Multiple producers") {
+        static constexpr int kProducers{4};
+        static constexpr int kItemsPerProducer{10'000};
+        MpscQueue<std::pair<int, int>> queue;
+        std::vector<std::thread> producers;
+        for (int producer{0}; producer < kProducers; ++producer) {
+            producers.emplace_back([&queue, producer]() {
+                for (int i{0}; i < kItemsPerProducer; ++i) {
+                    queue.push({producer, i});
+                }
+            });
+        }
+
+        std::vector<int> next_expected(kProducers, 0);
+        int popped{0};
+        while (popped < kProducers * kItemsPerProducer) {
+            const auto item{queue.pop()};
+            if (not item.has_value()) continue;
+            const auto [producer, value]{*item};
+            REQUIRE(value == next_expected[static_cast<size_t>(producer)]);  // Per producer ordering
+            ++next_expected[static_cast<size_t>(producer)];
+            ++popped;
+        }
+        for (auto& producer : producers) producer.join();
+        CHECK(queue.empty());
+    }
+}
+}  // namespace znode
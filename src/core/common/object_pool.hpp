@@ -16,6 +16,7 @@
 */
 
 #pragma once
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <stack>
@@ -26,6 +27,12 @@
 
 namespace znode {
 
+//! \brief Counters of objects served by a pool (hits) or newly created for lack of recyclable ones (misses)
+struct ObjectPoolMetrics {
+    std::atomic_uint64_t hits_{0};
+    std::atomic_uint64_t misses_{0};
+};
+
 //! \brief A dynamic pool of objects usually expensive to create
 template <class T, class TDtor = std::default_delete<T>>
 class ObjectPool : private boost::noncopyable {
@@ -0,0 +1,102 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "pooled_bytes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <new>
+
+namespace znode {
+
+namespace {
+
+    constexpr size_t kSizeClassesCount{static_cast<size_t>(std::countr_zero(kPooledMaxBlockSize) -
+                                                           std::countr_zero(kPooledMinBlockSize) + 1)};
+
+    //! \brief Released blocks are chained through their own first bytes
+    struct FreeBlock {
+        FreeBlock* next{nullptr};
+    };
+
+    //! \brief Whether the cache of the current thread has already been destroyed
+    //! \remarks Blocks may be released after thread local destruction (e.g. by static objects)
+    thread_local bool blocks_cache_destroyed{false};
+
+    //! \brief Per-thread cache of released blocks indexed by size class
+    struct BlocksCache {
+        std::array<FreeBlock*, kSizeClassesCount> heads{};
+        size_t cached_bytes{0};
+
+        ~BlocksCache() {
+            blocks_cache_destroyed = true;
+            for (auto& head : heads) {
+                while (head != nullptr) {
+                    auto* next{head->next};
+                    ::operator delete(head);
+                    head = next;
+                }
+            }
+            cached_bytes = 0;
+        }
+    };
+
+    thread_local BlocksCache blocks_cache;
+
+    //! \brief Returns the rounded up block size for the requested size
+    constexpr size_t block_size(size_t size) noexcept { return std::bit_ceil(std::max(size, kPooledMinBlockSize)); }
+
+    //! \brief Returns the index of the size class for a rounded block size
+    constexpr size_t size_class(size_t block_size) noexcept {
+        return static_cast<size_t>(std::countr_zero(block_size) - std::countr_zero(kPooledMinBlockSize));
+    }
+
+    static_assert(std::has_single_bit(kPooledMinBlockSize) and std::has_single_bit(kPooledMaxBlockSize));
+    static_assert(kPooledMinBlockSize >= sizeof(FreeBlock));
+    static_assert(size_class(kPooledMaxBlockSize) == kSizeClassesCount - 1);
+
+}  // namespace
+
+void* pooled_allocate(size_t size) {
+    if (size > kPooledMaxBlockSize or blocks_cache_destroyed) return ::operator new(size);
+    const auto rounded_size{block_size(size)};
+    auto& head{blocks_cache.heads[size_class(rounded_size)]};
+    if (head != nullptr) {
+        auto* block{head};
+        head = block->next;
+        blocks_cache.cached_bytes -= rounded_size;
+        return block;
+    }
+    return ::operator new(rounded_size);
+}
+
+void pooled_deallocate(void* ptr, size_t size) noexcept {
+    if (ptr == nullptr) return;
+    const auto rounded_size{block_size(size)};
+    if (size > kPooledMaxBlockSize or blocks_cache_destroyed or
+        blocks_cache.cached_bytes + rounded_size > kPooledMaxCachedBytes) {
+        ::operator delete(ptr);
+        return;
+    }
+    auto& head{blocks_cache.heads[size_class(rounded_size)]};
+    head = ::new (ptr) FreeBlock{head};
+    blocks_cache.cached_bytes += rounded_size;
+}
+
+size_t pooled_cached_bytes() noexcept { return blocks_cache_destroyed ? 0U : blocks_cache.cached_bytes; }
+
+}  // namespace znode
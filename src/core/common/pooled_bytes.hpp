@@ -0,0 +1,72 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <core/common/base.hpp>
+
+namespace znode {
+
+//! \brief Smallest block size handed out by the pooled allocator
+inline constexpr size_t kPooledMinBlockSize{64};
+
+//! \brief Largest block size recycled by the pooled allocator
+//! \remarks Bigger requests are served (and released) directly by the system allocator
+inline constexpr size_t kPooledMaxBlockSize{1_MiB};
+
+//! \brief Maximum amount of bytes each thread keeps cached for recycling
+inline constexpr size_t kPooledMaxCachedBytes{16_MiB};
+
+//! \brief Returns a memory block of at least size bytes
+//! \remarks Sizes are rounded up to the next power of two and, when possible, served from a per-thread cache
+//! of previously released blocks. No locks are involved.
+[[nodiscard]] void* pooled_allocate(size_t size);
+
+//! \brief Releases a memory block obtained from pooled_allocate
+//! \remarks The block is kept in the calling thread's cache unless the cache is full or the block is oversized
+void pooled_deallocate(void* ptr, size_t size) noexcept;
+
+//! \brief Returns the amount of bytes cached for recycling by the calling thread
+[[nodiscard]] size_t pooled_cached_bytes() noexcept;
+
+//! \brief Allocator recycling memory blocks through lock-free per-thread caches
+//! \attention Memory is neither locked against page-out nor wiped out on deallocation: never use this for
+//! sensitive data (see secure_allocator)
+template <typename T>
+struct pooled_allocator : public std::allocator<T> {
+    using base = std::allocator<T>;
+    pooled_allocator() noexcept = default;
+    pooled_allocator(const pooled_allocator& a) noexcept = default;
+    template <typename U>
+    explicit pooled_allocator(const pooled_allocator<U>& a) noexcept : base(a) {}
+    ~pooled_allocator() noexcept = default;
+    template <typename Other>
+    struct rebind {
+        using other = pooled_allocator<Other>;
+    };
+    [[nodiscard]] T* allocate(size_t n) { return static_cast<T*>(pooled_allocate(sizeof(T) * n)); }
+
+    void deallocate(T* ptr, size_t n) noexcept { pooled_deallocate(ptr, sizeof(T) * n); }
+};
+
+//! \brief This is exactly like Bytes, but with a pooled allocator. Meant for transient buffers (e.g. network
+//! messages and serialization streams)
+using PooledBytes = std::basic_string<uint8_t, std::char_traits<uint8_t>, pooled_allocator<uint8_t>>;
+}  // namespace znode
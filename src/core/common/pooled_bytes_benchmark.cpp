@@ -0,0 +1,58 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+
+#include <benchmark/benchmark.h>
+
+#include <core/common/base.hpp>
+#include <core/common/cast.hpp>
+#include <core/common/misc.hpp>
+#include <core/common/pooled_bytes.hpp>
+#include <core/common/secure_bytes.hpp>
+
+namespace znode {
+
+static constexpr size_t kMessageHeaderSize{24};
+static constexpr size_t kPayloadChunkSize{36};  // Size of an inventory item
+static constexpr int64_t kMinPayloadSize{64};
+static constexpr int64_t kMaxPayloadSize{256_KiB};
+
+const Bytes random_payload{Bytes(string_view_to_byte_view(get_random_alpha_string(kMaxPayloadSize)))};
+
+//! \brief Mimics the lifecycle of a network message buffer: header first then payload serialized
+//! in chunks, then read back and finally disposed
+template <typename BufferType>
+void bench_message_buffer(benchmark::State& state) {
+    const auto payload_size{static_cast<size_t>(state.range())};
+    for ([[maybe_unused]] auto _ : state) {
+        BufferType buffer;
+        buffer.append(random_payload.data(), kMessageHeaderSize);
+        for (size_t offset{0}; offset < payload_size; offset += kPayloadChunkSize) {
+            buffer.append(&random_payload[offset], std::min(kPayloadChunkSize, payload_size - offset));
+        }
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(payload_size + kMessageHeaderSize));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(bench_message_buffer, Bytes)->RangeMultiplier(8)->Range(kMinPayloadSize, kMaxPayloadSize);
+BENCHMARK_TEMPLATE(bench_message_buffer, SecureBytes)->RangeMultiplier(8)->Range(kMinPayloadSize, kMaxPayloadSize);
+BENCHMARK_TEMPLATE(bench_message_buffer, PooledBytes)->RangeMultiplier(8)->Range(kMinPayloadSize, kMaxPayloadSize);
+
+}  // namespace znode
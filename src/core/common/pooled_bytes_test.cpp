@@ -0,0 +1,81 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include <core/common/base.hpp>
+#include <core/common/pooled_bytes.hpp>
+
+namespace znode {
+TEST_CASE("Pooled allocation", "[memory]") {
+    const auto initial_cached_bytes{pooled_cached_bytes()};
+
+    SECTION("Blocks are recycled") {
+        void* ptr{pooled_allocate(100)};
+        REQUIRE(ptr != nullptr);
+        pooled_deallocate(ptr, 100);
+        CHECK(pooled_cached_bytes() == initial_cached_bytes + 128);  // Rounded to next power of two
+        void* ptr2{pooled_allocate(120)};                             // Same size class
+        CHECK(ptr2 == ptr);
+        CHECK(pooled_cached_bytes() == initial_cached_bytes);
+        pooled_deallocate(ptr2, 120);
+    }
+
+    SECTION("Oversized blocks are not cached") {
+        void* ptr{pooled_allocate(kPooledMaxBlockSize + 1)};
+        REQUIRE(ptr != nullptr);
+        pooled_deallocate(ptr, kPooledMaxBlockSize + 1);
+        CHECK(pooled_cached_bytes() == initial_cached_bytes);
+    }
+
+    SECTION("Caches are per thread") {
+        void* ptr{pooled_allocate(kPooledMinBlockSize)};
+        std::thread([ptr]() {
+            const auto thread_cached_bytes{pooled_cached_bytes()};
+            pooled_deallocate(ptr, kPooledMinBlockSize);
+            CHECK(pooled_cached_bytes() == thread_cached_bytes + kPooledMinBlockSize);
+        }).join();
+        CHECK(pooled_cached_bytes() == initial_cached_bytes);
+    }
+
+    SECTION("Blocks released after the thread cache") {
+        //! \brief Constructed before the cache of the thread hence destroyed after it
+        struct LateReleaser {
+            void* ptr{nullptr};
+            ~LateReleaser() { pooled_deallocate(ptr, kPooledMinBlockSize); }
+        };
+        std::thread([]() {
+            thread_local LateReleaser releaser;
+            releaser.ptr = pooled_allocate(kPooledMinBlockSize);
+            pooled_deallocate(pooled_allocate(kPooledMinBlockSize), kPooledMinBlockSize);  // Populate the cache
+        }).join();
+        CHECK(pooled_cached_bytes() == initial_cached_bytes);
+    }
+}
+
+TEST_CASE("Pooled Bytes", "[memory]") {
+    PooledBytes pooled_bytes(4_KiB, 0);
+    pooled_bytes[0] = 'a';
+    pooled_bytes[1] = 'b';
+    pooled_bytes[2] = 'c';
+    pooled_bytes.append(4_KiB, 'd');
+    CHECK(pooled_bytes.size() == 8_KiB);
+    CHECK(pooled_bytes[2] == 'c');
+    CHECK(pooled_bytes.back() == 'd');
+}
+}  // namespace znode
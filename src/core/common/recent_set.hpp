@@ -0,0 +1,86 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace znode {
+
+//! \brief A lock-free set remembering the Capacity most recently inserted items
+//! \details Items are stored as hashes in a ring of atomic slots : when the set is full every insertion overwrites the
+//! oldest slot (FIFO). Lookups scan all the slots which, for the small capacities this is meant for, fit in a few
+//! cache lines.
+//! \remarks Thread safe and wait-free. Membership is approximate : distinct items with the same hash collide and two
+//! threads inserting the same item at the same time may both succeed. Use it for heuristics only (e.g. avoiding
+//! to pick the same item twice in a row)
+template <class Key, class Hasher = std::hash<Key>, size_t Capacity = 64>
+class RecentSet {
+    static_assert(Capacity not_eq 0U, "Can't create a zero capped container");
+
+  public:
+    explicit RecentSet(Hasher hasher = Hasher{}) : hasher_{std::move(hasher)} {}
+    ~RecentSet() = default;
+
+    // Not copyable nor movable
+    RecentSet(const RecentSet&) = delete;
+    RecentSet& operator=(const RecentSet&) = delete;
+
+    //! \brief Adds an item to the set
+    //! \return true if the item was added, false if it was already present
+    bool insert(const Key& item) noexcept {
+        const auto hash{fingerprint(item)};
+        if (contains_hash(hash)) return false;
+        const auto position{inserts_.fetch_add(1U, std::memory_order_relaxed) % Capacity};
+        slots_[position].store(hash, std::memory_order_relaxed);
+        return true;
+    }
+
+    [[nodiscard]] bool contains(const Key& item) const noexcept { return contains_hash(fingerprint(item)); }
+
+    [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+    [[nodiscard]] size_t size() const noexcept {
+        return static_cast<size_t>(std::min<uint64_t>(inserts_.load(std::memory_order_relaxed), Capacity));
+    }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0U; }
+
+  private:
+    //! \brief Mixes the hash of the item (splitmix64) so that weak hashers (e.g. std::hash of integers is the
+    //! identity) are unlikely to collide with the empty slot marker
+    [[nodiscard]] uint64_t fingerprint(const Key& item) const noexcept {
+        uint64_t ret{static_cast<uint64_t>(hasher_(item)) + 0x9e3779b97f4a7c15ULL};
+        ret = (ret ^ (ret >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+        ret = (ret ^ (ret >> 27U)) * 0x94d049bb133111ebULL;
+        ret ^= ret >> 31U;
+        return ret == kEmptySlot ? 1U : ret;
+    }
+
+    [[nodiscard]] bool contains_hash(uint64_t hash) const noexcept {
+        return std::ranges::any_of(slots_,
+                                   [hash](const auto& slot) { return slot.load(std::memory_order_relaxed) == hash; });
+    }
+
+    static constexpr uint64_t kEmptySlot{0};
+    const Hasher hasher_;  // Same instance for all the items (keyed hashers are seeded on construction)
+    std::array<std::atomic_uint64_t, Capacity> slots_{};
+    std::atomic_uint64_t inserts_{0};  // Number of insertions so far (next slot to overwrite modulo Capacity)
+};
+
+}  // namespace znode
@@ -0,0 +1,111 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <core/common/recent_set.hpp>
+
+namespace znode {
+TEST_CASE("Recent Set", "[memory]") {
+    constexpr int kContainerSize{10};
+    RecentSet<int, std::hash<int>, kContainerSize> recent_set;
+    CHECK(recent_set.capacity() == kContainerSize);
+    CHECK(recent_set.empty());
+
+    // Fill with 10 items
+    for (int i{0}; i < kContainerSize; ++i) {
+        CHECK(recent_set.insert(i));
+    }
+    CHECK(recent_set.size() == kContainerSize);
+
+    // Inserting an item already present should return false
+    for (int i{0}; i < kContainerSize; ++i) {
+        CHECK_FALSE(recent_set.insert(i));
+    }
+
+    // Add another item and ensure the oldest one has been evicted
+    CHECK(recent_set.insert(kContainerSize));
+    CHECK(recent_set.size() == kContainerSize);
+    CHECK_FALSE(recent_set.contains(0));
+    CHECK(recent_set.contains(1));
+    CHECK(recent_set.contains(kContainerSize));
+
+    // Items hashing to zero are not mistaken for empty slots
+    RecentSet<int, std::hash<int>, kContainerSize> zero_set;
+    CHECK_FALSE(zero_set.contains(0));
+    CHECK(zero_set.insert(0));
+    CHECK(zero_set.contains(0));
+}
+
+namespace {
+    //! \brief A hasher drawing a new key on every construction (as IPEndpointHasher does) and counting its calls
+    struct KeyedHasher {
+        KeyedHasher() : key{++keys_drawn} {}
+        explicit KeyedHasher(size_t* calls_counter) : key{++keys_drawn}, calls{calls_counter} {}
+        size_t operator()(int item) const noexcept {
+            if (calls not_eq nullptr) ++*calls;
+            return static_cast<size_t>((static_cast<uint64_t>(item) ^ key) * uint64_t{0x9e3779b97f4a7c15});
+        }
+        inline static std::atomic_uint64_t keys_drawn{0};
+        uint64_t key;
+        size_t* calls{nullptr};
+    };
+}  // namespace
+
+TEST_CASE("Recent Set with keyed hasher", "[memory]") {
+    constexpr int kContainerSize{10};
+    size_t hasher_calls{0};
+    RecentSet<int, KeyedHasher, kContainerSize> recent_set{KeyedHasher{&hasher_calls}};
+    const auto keys_drawn{KeyedHasher::keys_drawn.load()};
+
+    for (int i{0}; i < kContainerSize; ++i) {
+        CHECK(recent_set.insert(i));
+    }
+    for (int i{0}; i < kContainerSize; ++i) {
+        CHECK(recent_set.contains(i));
+        CHECK_FALSE(recent_set.insert(i));
+    }
+    CHECK_FALSE(recent_set.contains(kContainerSize));
+
+    // Every item has been hashed by the instance provided on construction : no other key has been drawn
+    CHECK(hasher_calls == kContainerSize * 3U + 1U);
+    CHECK(KeyedHasher::keys_drawn.load() == keys_drawn);
+}
+
+TEST_CASE("Recent Set concurrent inserts", "[memory]") {
+    constexpr int kThreads{4};
+    constexpr int kItemsPerThread{10'000};
+    RecentSet<int> recent_set;
+    std::vector<std::thread> threads;
+    for (int t{0}; t < kThreads; ++t) {
+        threads.emplace_back([&recent_set, t]() {
+            for (int i{0}; i < kItemsPerThread; ++i) std::ignore = recent_set.insert(t * kItemsPerThread + i);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    CHECK(recent_set.size() == recent_set.capacity());
+
+    // Still usable after contention
+    CHECK(recent_set.insert(-1));
+    CHECK_FALSE(recent_set.insert(-1));
+    CHECK(recent_set.contains(-1));
+}
+}  // namespace znode
@@ -0,0 +1,158 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "blake2b.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include <core/common/assert.hpp>
+#include <core/common/endian.hpp>
+
+namespace znode::crypto {
+
+namespace {
+    constexpr std::array<uint64_t, 8> kIV{0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+                                          0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+                                          0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL};
+
+    constexpr std::array<std::array<uint8_t, 16>, 12> kSigma{{
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+        {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+        {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+        {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+        {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+        {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+        {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+        {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+        {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+        {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+        {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    }};
+
+    inline void mix(std::array<uint64_t, 16>& v, size_t a, size_t b, size_t c, size_t d, uint64_t x,
+                    uint64_t y) noexcept {
+        v[a] = v[a] + v[b] + x;
+        v[d] = std::rotr(v[d] ^ v[a], 32);
+        v[c] = v[c] + v[d];
+        v[b] = std::rotr(v[b] ^ v[c], 24);
+        v[a] = v[a] + v[b] + y;
+        v[d] = std::rotr(v[d] ^ v[a], 16);
+        v[c] = v[c] + v[d];
+        v[b] = std::rotr(v[b] ^ v[c], 63);
+    }
+}  // namespace
+
+Blake2b::Blake2b(size_t digest_size, ByteView personalization) noexcept : digest_size_{digest_size} {
+    ASSERT(digest_size_ not_eq 0U and digest_size_ <= kMaxDigestSize);
+    ASSERT(personalization.size() <= kPersonalizationSize);
+
+    // Parameter block : digest length, key length (none), fanout and depth (sequential mode) then,
+    // at offset 48, the personalization
+    std::array<uint8_t, 64> parameter_block{};
+    parameter_block[0] = static_cast<uint8_t>(digest_size_);
+    parameter_block[2] = 1U;
+    parameter_block[3] = 1U;
+    std::ranges::copy(personalization, std::next(parameter_block.begin(), 48));
+    for (size_t i{0}; i < kIV.size(); ++i) {
+        parameter_block_words_[i] = kIV[i] ^ endian::load_little_u64(&parameter_block[i * 8]);
+    }
+    init();
+}
+
+void Blake2b::init() noexcept {
+    state_ = parameter_block_words_;
+    buffer_size_ = 0;
+    compressed_size_ = 0;
+    ingested_size_ = 0;
+    finalized_ = false;
+}
+
+void Blake2b::update(ByteView data) noexcept {
+    if (finalized_ or data.empty()) return;
+    ingested_size_ += data.size();
+
+    // The last block is retained in buffer as it has to be compressed with the final flag
+    while (not data.empty()) {
+        if (buffer_size_ == kBlockSize) {
+            compressed_size_ += kBlockSize;
+            compress(buffer_.data(), compressed_size_, /*last=*/false);
+            buffer_size_ = 0;
+        }
+        if (buffer_size_ == 0U and data.size() > kBlockSize) {
+            compressed_size_ += kBlockSize;
+            compress(data.data(), compressed_size_, /*last=*/false);
+            data.remove_prefix(kBlockSize);
+            continue;
+        }
+        const auto count{std::min(kBlockSize - buffer_size_, data.size())};
+        std::memcpy(&buffer_[buffer_size_], data.data(), count);
+        buffer_size_ += count;
+        data.remove_prefix(count);
+    }
+}
+
+Bytes Blake2b::finalize() noexcept {
+    Bytes ret(digest_size_, 0);
+    if (not finalize_to(ret)) ret.clear();
+    return ret;
+}
+
+bool Blake2b::finalize_to(std::span<uint8_t> output) noexcept {
+    if (finalized_ or output.size() < digest_size_) return false;
+    std::memset(&buffer_[buffer_size_], 0, kBlockSize - buffer_size_);
+    compress(buffer_.data(), compressed_size_ + buffer_size_, /*last=*/true);
+    finalized_ = true;
+
+    std::array<uint8_t, kMaxDigestSize> digest{};
+    for (size_t i{0}; i < state_.size(); ++i) {
+        endian::store_little_u64(&digest[i * 8], state_[i]);
+    }
+    std::memcpy(output.data(), digest.data(), digest_size_);
+    return true;
+}
+
+void Blake2b::compress(const uint8_t* block, uint64_t counter, bool last) noexcept {
+    std::array<uint64_t, 16> m{};
+    for (size_t i{0}; i < m.size(); ++i) {
+        m[i] = endian::load_little_u64(&block[i * 8]);
+    }
+
+    std::array<uint64_t, 16> v{};
+    std::ranges::copy(state_, v.begin());
+    std::ranges::copy(kIV, std::next(v.begin(), 8));
+    v[12] ^= counter;  // Low word of the counter (high word is zero as inputs are way below 2^64 bytes)
+    if (last) v[14] = ~v[14];
+
+    for (const auto& s : kSigma) {
+        mix(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        mix(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        mix(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        mix(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+        mix(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        mix(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        mix(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        mix(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for (size_t i{0}; i < state_.size(); ++i) {
+        state_[i] ^= v[i] ^ v[i + 8];
+    }
+}
+
+}  // namespace znode::crypto
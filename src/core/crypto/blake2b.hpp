@@ -0,0 +1,78 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <array>
+#include <span>
+
+#include <core/common/base.hpp>
+#include <core/common/cast.hpp>
+
+namespace znode::crypto {
+
+//! \brief Portable implementation of BLAKE2b (RFC 7693) supporting variable digest size and personalization
+//! \details OpenSSL's EVP interface does not allow to personalize the digest which is what Equihash requires.
+//! Instances are copyable: a copy carries on from the state of the original (e.g. a shared prefix)
+class Blake2b {
+  public:
+    static constexpr size_t kBlockSize{128};
+    static constexpr size_t kMaxDigestSize{64};
+    static constexpr size_t kPersonalizationSize{16};
+
+    //! \brief Instantiates a hasher producing digests of the given size (1 to kMaxDigestSize)
+    //! \remarks The personalization, if any, MUST be at most kPersonalizationSize bytes (it is zero padded)
+    explicit Blake2b(size_t digest_size = kMaxDigestSize, ByteView personalization = {}) noexcept;
+
+    //! \brief Re-initialize the state pristine (digest size and personalization are retained)
+    void init() noexcept;
+
+    //! \brief Accumulates more data into the digest
+    void update(ByteView data) noexcept;
+
+    //! \brief Accumulates more data into the digest
+    void update(std::string_view data) noexcept { update(string_view_to_byte_view(data)); }
+
+    //! \brief Finalizes the digest process and produces the actual digest
+    //! \remarks After this instance has finalized it cannot receive new updates unless it's recycled by init()
+    [[nodiscard]] Bytes finalize() noexcept;
+
+    //! \brief Finalizes the digest process writing the digest into the provided buffer (no allocations)
+    //! \remarks The output buffer MUST be at least digest_size() bytes wide
+    //! \returns Whether the digest has been successfully computed
+    [[nodiscard]] bool finalize_to(std::span<uint8_t> output) noexcept;
+
+    //! \brief Returns the size (in bytes) of the final digest
+    [[nodiscard]] size_t digest_size() const noexcept { return digest_size_; }
+
+    //! \brief Returns the number of bytes already digested
+    [[nodiscard]] size_t ingested_size() const noexcept { return ingested_size_; }
+
+  private:
+    //! \brief Compresses a block into the state
+    //! \param counter The number of bytes hashed so far (including the ones in this block)
+    void compress(const uint8_t* block, uint64_t counter, bool last) noexcept;
+
+    size_t digest_size_;
+    std::array<uint64_t, 8> parameter_block_words_{};  // Initial state (IV xor parameter block)
+    std::array<uint64_t, 8> state_{};
+    std::array<uint8_t, kBlockSize> buffer_{};
+    size_t buffer_size_{0};
+    size_t compressed_size_{0};
+    size_t ingested_size_{0};
+    bool finalized_{false};
+};
+
+}  // namespace znode::crypto
@@ -0,0 +1,76 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <array>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <core/crypto/blake2b.hpp>
+#include <core/crypto/md_test.hpp>
+
+namespace znode::crypto {
+
+TEST_CASE("Blake2b", "[crypto]") {
+    // See RFC 7693 Appendix A and https://github.com/BLAKE2/BLAKE2/tree/master/testvectors
+    const std::vector<std::string> inputs{
+        "",                                                          // Test 1
+        "abc",                                                       // Test 2
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",  // Test 3
+        std::string(1024, 'z'),                                      // Test 4 (spans several blocks)
+    };
+
+    const std::vector<std::string> digests{
+        "786a02f742015903c6c6fd852552d272912f4740e15847618a86e217f71f5419"
+        "d25e1031afee585313896444934eb04b903a685b1448b755d56f701afe9be2ce",  // Test 1
+        "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d1"
+        "7d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923",  // Test 2
+        "7285ff3e8bd768d69be62b3bf18765a325917fa9744ac2f582a20850bc2b1141"
+        "ed1b3e4528595acc90772bdf2d37dc8a47130b44f33a02e8730e5ad8e166e888",  // Test 3
+        "783d02d6c0f909d31b5038c07aed08f97d74289dfb26f0f1f20d5274cd344d98"
+        "7810e96ffab2c8fe5a64e2792851d41309889fee92969bc5164ff7900f16e10b",  // Test 4
+    };
+
+    Blake2b hasher;
+    run_hasher_tests(hasher, inputs, digests);
+}
+
+TEST_CASE("Blake2b personalized", "[crypto]") {
+    // Equihash (n=200, k=9) personalization i.e. "ZcashPoW" followed by n and k as LE 32 bit integers
+    const std::array<uint8_t, 16> personalization{'Z', 'c', 'a', 's', 'h', 'P', 'o', 'W', 200, 0, 0, 0, 9, 0, 0, 0};
+
+    const std::vector<std::string> inputs{"", "abc", std::string(1024, 'z')};
+    const std::vector<std::string> digests{
+        "42fadb7376483e2167dbb245215129da15280a65062e68cf07cc9bc3f71905b8070472455b9fc809308919b7834c78b40726",
+        "52e907446f88b0d5e63e3b2ed93b9cf178cff963d9b89e2a01fe2e42f247b0a58f8f40ccd4471fdadee85d6ab7e69be29285",
+        "f1ae95ce545a018825532d36fdf945c50559f9353a1b8db3a5454359a96c38e9da5d9d8b3b5c4abfc114ab6274733d057b4a",
+    };
+
+    Blake2b hasher(50, personalization);
+    run_hasher_tests(hasher, inputs, digests);
+
+    // A copy carries on from the state of the original
+    hasher.init();
+    hasher.update("ab");
+    Blake2b copy(hasher);
+    copy.update("c");
+    CHECK(enc::hex::encode(copy.finalize()) == digests[1]);
+
+    // No further updates once finalized
+    CHECK(copy.finalize().empty());
+}
+
+}  // namespace znode::crypto
@@ -0,0 +1,124 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "equihash.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <core/common/assert.hpp>
+#include <core/common/endian.hpp>
+#include <core/crypto/blake2b.hpp>
+
+namespace znode::crypto {
+
+namespace {
+    //! \brief Splits the provided bytes (big endian bit stream) into consecutive values bit_len bits wide
+    template <typename Sink>
+    void for_each_value(ByteView data, uint32_t bit_len, Sink&& sink) noexcept {
+        const uint64_t mask{(uint64_t{1} << bit_len) - 1U};
+        uint64_t acc_value{0};
+        uint32_t acc_bits{0};
+        for (const auto byte : data) {
+            acc_value = (acc_value << 8U) | byte;
+            acc_bits += 8U;
+            if (acc_bits >= bit_len) {
+                acc_bits -= bit_len;
+                sink(static_cast<uint32_t>((acc_value >> acc_bits) & mask));
+            }
+        }
+    }
+}  // namespace
+
+Equihash::Equihash(uint32_t n, uint32_t k) noexcept
+    : n_{n},
+      k_{k},
+      collision_bit_length_{n / (k + 1U)},
+      collision_byte_length_{(collision_bit_length_ + 7U) / 8U},
+      hash_length_{(k + 1U) * collision_byte_length_},
+      indices_per_hash_output_{512U / n},
+      hash_output_size_{indices_per_hash_output_ * n / 8U},
+      solution_size_{(size_t{1} << k) * (collision_bit_length_ + 1U) / 8U} {
+    ASSERT(is_valid_parameters(n, k));
+    std::memcpy(personalization_.data(), "ZcashPoW", 8);
+    endian::store_little_u32(&personalization_[8], n);
+    endian::store_little_u32(&personalization_[12], k);
+}
+
+bool Equihash::verify(ByteView input, ByteView solution) const noexcept {
+    if (solution.size() not_eq solution_size_) return false;
+
+    // Decode indices
+    const size_t rows_count{size_t{1} << k_};
+    std::array<uint32_t, size_t{1} << kMaxK> indices{};
+    size_t indices_count{0};
+    for_each_value(solution, collision_bit_length_ + 1U,
+                   [&indices, &indices_count](uint32_t value) { indices[indices_count++] = value; });
+    ASSERT(indices_count == rows_count);
+
+    // All indices must be distinct
+    auto sorted_indices{indices};
+    const auto sorted_end{std::next(sorted_indices.begin(), static_cast<std::ptrdiff_t>(rows_count))};
+    std::sort(sorted_indices.begin(), sorted_end);
+    if (std::adjacent_find(sorted_indices.begin(), sorted_end) not_eq sorted_end) return false;
+
+    // Generate the (expanded) hash of each index
+    Blake2b base_hasher(hash_output_size_, personalization_);
+    base_hasher.update(input);
+    const size_t hash_size{n_ / 8U};
+    std::vector<uint8_t> rows(rows_count * hash_length_);
+    std::array<uint8_t, Blake2b::kMaxDigestSize> digest{};
+    std::array<uint8_t, 4> group{};
+    for (size_t i{0}; i < rows_count; ++i) {
+        Blake2b hasher(base_hasher);
+        endian::store_little_u32(group.data(), static_cast<uint32_t>(indices[i] / indices_per_hash_output_));
+        hasher.update(ByteView{group.data(), group.size()});
+        std::ignore = hasher.finalize_to(digest);
+
+        uint8_t* row{&rows[i * hash_length_]};
+        const ByteView hash{&digest[(indices[i] % indices_per_hash_output_) * hash_size], hash_size};
+        for_each_value(hash, collision_bit_length_, [this, &row](uint32_t value) {
+            for (size_t j{collision_byte_length_}; j > 0U; --j, value >>= 8U) {
+                row[j - 1] = static_cast<uint8_t>(value & 0xffU);
+            }
+            row += collision_byte_length_;
+        });
+    }
+
+    // Climb the tree : at each level sibling subtrees (which, in a valid solution, are contiguous and ordered
+    // ranges of indices) must collide on the next collision_byte_length_ bytes. Merges happen in place.
+    for (uint32_t level{0}; level < k_; ++level) {
+        const size_t stride{size_t{1} << level};
+        const size_t offset{level * collision_byte_length_};
+        for (size_t left{0}; left < rows_count; left += 2U * stride) {
+            const size_t right{left + stride};
+            uint8_t* left_row{&rows[left * hash_length_]};
+            const uint8_t* right_row{&rows[right * hash_length_]};
+            if (std::memcmp(&left_row[offset], &right_row[offset], collision_byte_length_) not_eq 0) return false;
+            if (indices[left] > indices[right]) return false;  // Not in canonical order
+            for (size_t j{offset + collision_byte_length_}; j < hash_length_; ++j) {
+                left_row[j] ^= right_row[j];
+            }
+        }
+    }
+
+    // What remains must be all zeroes
+    const auto remainder{ByteView{rows.data(), hash_length_}.substr(k_ * collision_byte_length_)};
+    return std::ranges::all_of(remainder, [](const uint8_t byte) { return byte == 0U; });
+}
+
+}  // namespace znode::crypto
@@ -0,0 +1,66 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <array>
+
+#include <core/common/base.hpp>
+
+namespace znode::crypto {
+
+//! \brief Verifier of Equihash proof of work solutions
+//! \details See https://eprint.iacr.org/2015/946.pdf and section 7.6.1 of Zcash protocol specification.
+//! The verification is bit-for-bit compatible with the one of zend (i.e. Zcash's) : the input (the header
+//! serialized without the solution, nonce included) is hashed with a BLAKE2b personalized with "ZcashPoW"
+//! followed by n and k, the solution is a minimally encoded (bit packed) list of 2^k indices
+class Equihash {
+  public:
+    static constexpr uint32_t kMaxK{9};  // Largest k deployed on any chain (bounds the working set)
+
+    //! \brief Whether the provided parameters are supported
+    [[nodiscard]] static constexpr bool is_valid_parameters(uint32_t n, uint32_t k) noexcept {
+        return k > 0U and k <= kMaxK and k < n and n % 8U == 0U and n <= 512U and (n / (k + 1U)) + 1U < 32U;
+    }
+
+    //! \brief Instantiates a verifier for the provided parameters
+    //! \remarks Parameters MUST be valid (see is_valid_parameters)
+    Equihash(uint32_t n, uint32_t k) noexcept;
+
+    [[nodiscard]] uint32_t n() const noexcept { return n_; }
+    [[nodiscard]] uint32_t k() const noexcept { return k_; }
+
+    //! \brief Returns the size (in bytes) a solution is expected to have
+    [[nodiscard]] size_t solution_size() const noexcept { return solution_size_; }
+
+    //! \brief Verifies the provided solution against the provided input
+    //! \param input The block header serialized without the solution (nonce included)
+    //! \param solution The minimally encoded solution
+    //! \remarks Is thread safe : a single instance can be shared among threads
+    [[nodiscard]] bool verify(ByteView input, ByteView solution) const noexcept;
+
+  private:
+    uint32_t n_;
+    uint32_t k_;
+    uint32_t collision_bit_length_;              // Number of bits each step has to collide on
+    size_t collision_byte_length_;               // Number of bytes each step collision is expanded to
+    size_t hash_length_;                         // Size of a hash once expanded (i.e. each collision aligned to bytes)
+    size_t indices_per_hash_output_;             // Number of indices each BLAKE2b digest serves
+    size_t hash_output_size_;                    // Size of each BLAKE2b digest
+    size_t solution_size_;                       // Size of a minimally encoded solution
+    std::array<uint8_t, 16> personalization_{};  // "ZcashPoW" || LE32(n) || LE32(k)
+};
+
+}  // namespace znode::crypto
@@ -0,0 +1,146 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <core/crypto/equihash.hpp>
+#include <core/crypto/equihash_test.hpp>
+#include <core/encoding/hex.hpp>
+
+namespace znode::crypto {
+
+namespace {
+    std::vector<uint32_t> indices_from_solution(ByteView solution, uint32_t bit_len) {
+        std::vector<uint32_t> ret;
+        uint64_t acc_value{0};
+        uint32_t acc_bits{0};
+        for (const auto byte : solution) {
+            acc_value = (acc_value << 8U) | byte;
+            acc_bits += 8U;
+            if (acc_bits >= bit_len) {
+                acc_bits -= bit_len;
+                ret.push_back(static_cast<uint32_t>((acc_value >> acc_bits) & ((uint64_t{1} << bit_len) - 1U)));
+            }
+        }
+        return ret;
+    }
+
+    Bytes solution_from_indices(const std::vector<uint32_t>& indices, uint32_t bit_len) {
+        Bytes ret;
+        uint64_t acc_value{0};
+        uint32_t acc_bits{0};
+        for (const auto index : indices) {
+            acc_value = (acc_value << bit_len) | index;
+            acc_bits += bit_len;
+            while (acc_bits >= 8U) {
+                acc_bits -= 8U;
+                ret.push_back(static_cast<uint8_t>(acc_value >> acc_bits));
+            }
+        }
+        return ret;
+    }
+
+    Bytes pow_input(const BlockHeader& header) {
+        ser::SDataStream stream(ser::Scope::kHash, 0);
+        REQUIRE_FALSE(header.serialize_pow_input(stream).has_error());
+        REQUIRE(stream.size() == kBlockHeaderSerializedSize);
+        return Bytes{stream.contents()};
+    }
+}  // namespace
+
+TEST_CASE("Equihash parameters", "[crypto]") {
+    CHECK(Equihash::is_valid_parameters(200, 9));
+    CHECK(Equihash::is_valid_parameters(192, 7));
+    CHECK(Equihash::is_valid_parameters(144, 5));
+    CHECK(Equihash::is_valid_parameters(96, 5));
+    CHECK(Equihash::is_valid_parameters(48, 5));
+    CHECK_FALSE(Equihash::is_valid_parameters(201, 9));   // n not multiple of 8
+    CHECK_FALSE(Equihash::is_valid_parameters(200, 10));  // k too large
+    CHECK_FALSE(Equihash::is_valid_parameters(200, 0));
+    CHECK_FALSE(Equihash::is_valid_parameters(256, 3));  // Collision bits too large
+
+    CHECK(Equihash(200, 9).solution_size() == 1344);
+    CHECK(Equihash(192, 7).solution_size() == 400);
+    CHECK(Equihash(96, 5).solution_size() == 68);
+    CHECK(Equihash(48, 5).solution_size() == 36);
+}
+
+TEST_CASE("Equihash Zcash test vector", "[crypto]") {
+    // See https://github.com/zcash/zcash/blob/master/src/gtest/test_equihash.cpp
+    // (input "block header", nonce zero)
+    const std::vector<uint32_t> indices{976,    126621, 100174, 123328, 38477,  105390, 38834,  90500,
+                                        6411,   116489, 51107,  129167, 25557,  92292,  38525,  56514,
+                                        1110,   98024,  15426,  74455,  3185,   84007,  24328,  36473,
+                                        17427,  129451, 27556,  119967, 31704,  62448,  110460, 117894};
+    Bytes input{string_view_to_byte_view("block header")};
+    input.resize(input.size() + 32, 0);
+
+    const Equihash equihash(96, 5);
+    const auto solution{solution_from_indices(indices, 17)};
+    REQUIRE(solution.size() == equihash.solution_size());
+    CHECK(equihash.verify(input, solution));
+
+    input.back() = 1;  // Different nonce
+    CHECK_FALSE(equihash.verify(input, solution));
+}
+
+TEST_CASE("Equihash solutions", "[crypto]") {
+    for (const auto& vector : kEquihashTestVectors) {
+        const Equihash equihash(vector.n, vector.k);
+        const auto input{pow_input(make_equihash_test_header(vector.nonce))};
+        const auto solution{enc::hex::decode(vector.solution).value()};
+        const auto bit_len{(vector.n / (vector.k + 1)) + 1};
+        INFO("n=" << vector.n << " k=" << vector.k);
+
+        CHECK(equihash.verify(input, solution));
+
+        // Different input
+        const auto other_input{pow_input(make_equihash_test_header(vector.nonce + 1))};
+        CHECK_FALSE(equihash.verify(other_input, solution));
+
+        // Wrong size
+        CHECK_FALSE(equihash.verify(input, ByteView{solution}.substr(1)));
+        Bytes longer_solution{solution};
+        longer_solution.push_back(0);
+        CHECK_FALSE(equihash.verify(input, longer_solution));
+        CHECK_FALSE(equihash.verify(input, {}));
+
+        // Altered bits
+        for (const size_t position : {size_t{0}, solution.size() / 2, solution.size() - 1}) {
+            Bytes altered_solution{solution};
+            altered_solution[position] ^= 0x01;
+            CHECK_FALSE(equihash.verify(input, altered_solution));
+        }
+
+        // Non canonical order
+        auto indices{indices_from_solution(solution, bit_len)};
+        REQUIRE(indices.size() == size_t{1} << vector.k);
+        const auto middle{std::next(indices.begin(), static_cast<std::ptrdiff_t>(indices.size() / 2))};
+        auto rotated_indices{indices};
+        std::rotate(rotated_indices.begin(), std::next(rotated_indices.begin(), middle - indices.begin()),
+                    rotated_indices.end());
+        CHECK_FALSE(equihash.verify(input, solution_from_indices(rotated_indices, bit_len)));
+
+        // Duplicate indices (both halves are the same hence all collisions are zero)
+        std::copy(indices.begin(), middle, middle);
+        CHECK_FALSE(equihash.verify(input, solution_from_indices(indices, bit_len)));
+    }
+}
+
+}  // namespace znode::crypto
@@ -0,0 +1,94 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <array>
+#include <string_view>
+
+#include <core/types/block.hpp>
+
+namespace znode::crypto {
+
+//! \brief A valid Equihash solution for the header returned by make_equihash_test_header(nonce)
+struct EquihashTestVector {
+    uint32_t n;
+    uint32_t k;
+    uint32_t nonce;
+    std::string_view solution;  // Hex
+};
+
+//! \brief Returns the header the test vectors have been solved for
+inline BlockHeader make_equihash_test_header(uint32_t nonce) {
+    BlockHeader header;
+    header.version = 4;
+    header.parent_hash = h256::from_hex("0007104ccda289427919efc39dc9e4d499804b7bebc22df55f8b834301260602").value();
+    header.merkle_root = h256::from_hex("19612bcf00ea7611d315d7f43554fa983c6e8c30cba17e52c679e0e80abf7d42").value();
+    header.time = 1496187064U;
+    header.bits = 0x1f07ffffU;
+    header.nonce = nonce;
+    return header;
+}
+
+// Solutions below have been computed with a plain Wagner solver
+inline constexpr std::string_view kSolution200_9{
+    "00adfb47a3b1bb7ba9b3f30e40e8e489947019061c1ff4fd8f6c307c9ba11ff4dfe6fd7711ebfcf75df30745d525b9e43cf3"
+    "f68854cc85b69ac28ca1b95979315f21c8e1dd0ebd83f52372dcd063e910ec5a6c35064735affe4e2063a774d375c9cd61ca"
+    "dd2abdfb5c48408e4d1cd4732f31aad70bdb714a3a768fb605cf14fd3138438959437a4fe512e1ab08aafbc83cd2a921fc47"
+    "3355184dd5189a472700ebd08df5de7aefb700bfe22d9ebd1a03fff9a0d980444b7590dcf109ab4b606bf46a21b1395efeb6"
+    "1427332eadd42a3077d00e4bae331291cbb6bea008d804c9e5eaeb709f152416569f82481db98afb5d262092ea6462349ffe"
+    "ca4a06e6643355581cfbf60e128479cbf4acfce8373b4c115cef55ec60718df6b344ea6a6b2bf9619c13567d17bde6190354"
+    "09c938064694cdb565922b89deaa283c32d41e7da6e19df697775821bad7424a1e59fdf801a5aaef96a0b14b1dcb611a9bf5"
+    "a905d7a39ac43911596f7d560d931d01d9d29897b98d41162d9b103e028fb5bc990288766332d1278821b9be20e23827bc37"
+    "f29a307ed3fae3fa4883c10c2abe7ea6a27fe610026cf7b667df024d744cc3e3e52ddd0a841d97836a338acfe3f6a26147e6"
+    "dab3f105abfd2ff624ffead628a54bff4a9787299d96d2db2679e2fdbe02ff24f72a485c40dbd8ecb9015ce3022c2c9c7e04"
+    "43581a9601dfe4749e882b6766dc7476da3c849a52507de8b10329a64a35b1d15d928c82bd9bdbcaf933cddf709f05c5b4ae"
+    "b2b26e81c934a0e4dc15dda6314c59ad0f15aac642a6a7ee0743621b5a7cf8ebaf9d629fde260d228aa2e618ff85e0a8388b"
+    "e17f8c7e569ddd411732efbac8dae581e9affd8657ed625acf50489ce92f2b10df0434609e5f0c0fb55e37367e31c80d399b"
+    "2534118d044e98d4abaf4223fa7466f4dd00429ca4f8011f4489de843af79dc554567650e0aa3ebf1b54ab30e1b30665e502"
+    "ddd43af4735e58fa01ef5c5ed4cd1120c2eb05ef9093b46ae1f87a61fb250a823b2fe933c7b5c6dbae075198bb646a0e61bf"
+    "79bf6779f9300412a5bc3ccd88f581acb07d137da7e0ccab36628307e10512ca582387c8ffc7055a431dbb9c477cebdd17cf"
+    "ebfe8a17ac17a69d32b43353b4d8dedf96a8458c020fa0482358f142d79948bd51cf2331803995b308649cfef9d6329af1d7"
+    "3347e3fea02605e358bffa106d13bda8d721831aac4761ad659ede3ba65a77ba096d70f5e0563fd9f313e3597b7858765c9a"
+    "57bbc43ccf53a6f462e793a42f8cb7fe7ae01f3c219cc5af0d3eaa0997e705219576255fe72eedb988d56ff9022c53f5f469"
+    "d7c9d38b0de3bd3171a5118366f517db0f451b145c4eddd75e0fb2308db89b6ad5a5588aac5dcb2345f398d86534a0b5e412"
+    "bca26a397a5d496501376ce5049b567ce35d701cf927ad3c9e1030e47a19359c48a128c0934dc0080d7f57c9d65c283f80b6"
+    "0dc58572a81e309b4c8866138e39796abd7519c0bb10a6243ad7783d73dfdb532a562ab2dd1dd8782f26046bc3f765346201"
+    "d60a50d757e9c8008fd490b90143644552fae2448de5417692f27985bf5eccdf60e824afb6ebffa484458c2912abd82bf681"
+    "a4d02d48f54b6672a77ede99e5dc4594e23b379ca9e78dd933760a8ec61c231c674b19ef4228c7a6345663203d5bf10e0072"
+    "e30074fe99c6d6b2defb48dd3957052c125221b6c3d04a093969c20d75f82944d576577eb54ab16b63f5d078e65623fcd689"
+    "5766f9e49a91f2b8d8b40b89de55e3a72015d699814e7a202826712956886945371e697c143666b9b77816594f9e424fe874"
+    "7a0f1b143eb4cb06dbc6d495c6fa2038676df69e7557d844aec5c2b5dbe8df6925668bb6c9ffc1cda618124e"};
+
+inline constexpr std::string_view kSolution192_7{
+    "017d84281335c11f034c090f1237f717f78a4d71b941a692ff38a341cbe019ce54e72bb2f564610c530ed456c1963763a23b"
+    "0f81cc926dfa8d7025f310e7f690f89439f346032b597a187619369b2f9373248e419da63e1194f86cac99b20520a161e902"
+    "0dadcfa78b220e22505f4b58121a839e9c872622f7a154f30e2d8166e2a36f8d51225ddfc9477e0e8e81d662de06b1ed1b9e"
+    "0e32f86273b40ed874bc5d94358067ff61e2ad6aa4d99e2f3142dce5239d66517bc5d3cee6149ea875c5694d7204550cebcd"
+    "0ab87b07b3ffd8f623f9a84cc1b2df048930e24beaa3613a8c17d73c9af2b5a1fee6b683333597cfa3c3133b6db03de41d4f"
+    "125bfac5bb4484e75b7230403456b51deaa5f94b213324ce8b37cdd9bc14f7a64fbb33766fe3def897aaad8d19b41d0515de"
+    "0ee2f62ee63708c884c827107163dddc05d321e546f79db3da37cc14bd0f65924de3cd4c61088b1c045cb1eb2912c7d69f2f"
+    "2f87c518dba4dd689759fb98244ca63bea3fa6bd89fb8393ff4305aad2425594c30c6db8e444bc21e4626995a1558fa5ecef"};
+
+inline constexpr std::string_view kSolution48_5{
+    "10216a7eb7a406336b134c53f8c7bd9735bc10d14fb9c22e98f27a121ed5aaf2c39597e1"};
+
+inline constexpr std::array<EquihashTestVector, 3> kEquihashTestVectors{{
+    {200U, 9U, 1U, kSolution200_9},
+    {192U, 7U, 0U, kSolution192_7},
+    {48U, 5U, 1U, kSolution48_5},
+}};
+
+}  // namespace znode::crypto
@@ -38,8 +38,8 @@ struct LibCtxDeleter {
     void operator()(OSSL_LIB_CTX* ptr) const noexcept { OSSL_LIB_CTX_free(ptr); }
 };
 
-//! \brief A collection of recycle-able OSSL_LIB_CTXes
-static ObjectPool<OSSL_LIB_CTX, LibCtxDeleter> LibCtxs(/*thread_safe=*/true);
+//! \brief A collection of recycle-able OSSL_LIB_CTXes (inline : the same for all the translation units)
+inline ObjectPool<OSSL_LIB_CTX, LibCtxDeleter> LibCtxs(/*thread_safe=*/true);
 
 //! \brief Explicit recycler for OSSL_LIB_CTXes
 struct LibCtxRecycler {
@@ -16,6 +16,8 @@
 
 #include "hash256.hpp"
 
+#include <cstring>
+
 #include <core/common/cast.hpp>
 
 namespace znode::crypto {
@@ -50,10 +52,24 @@ void Hash256::update(std::string_view data) noexcept {
 }
 
 Bytes Hash256::finalize() noexcept {
-    if (ingested_size_ == 0U) return kEmptyHash();
-    Bytes data{hasher_.finalize()};
-    if (data.empty()) return data;  // Some error occurred
-    hasher_.init(data);             // 2nd pass
-    return hasher_.finalize();
+    Bytes ret(kDigestSize, 0);
+    if (not finalize_to(std::span<uint8_t, kDigestSize>{ret.data(), kDigestSize})) ret.clear();  // Some error occurred
+    return ret;
+}
+
+bool Hash256::finalize_to(std::span<uint8_t, kDigestSize> output) noexcept {
+    if (ingested_size_ == 0U) {
+        std::memcpy(output.data(), kEmptyHashDigest.data(), kDigestSize);
+        return true;
+    }
+    if (not hasher_.finalize_to(output)) return false;
+    hasher_.init(ByteView{output.data(), output.size()});  // 2nd pass
+    return hasher_.finalize_to(output);
+}
+
+h256 Hash256::finalize_h256() noexcept {
+    std::array<uint8_t, kDigestSize> digest{};
+    if (not finalize_to(digest)) return {};
+    return h256{ByteView{digest.data(), digest.size()}};
 }
 }  // namespace znode::crypto
@@ -16,14 +16,20 @@
 
 #pragma once
 
+#include <array>
+#include <span>
+
 #include <boost/noncopyable.hpp>
 
 #include <core/crypto/md.hpp>
+#include <core/types/hash.hpp>
 
 namespace znode::crypto {
 //! \brief A hasher class for Bitcoin's 256 bit hash (double Sha256)
 class Hash256 : private boost::noncopyable {
   public:
+    static constexpr size_t kDigestSize{32};  // Size in bytes of the resulting digest
+
     Hash256() = default;
     ~Hash256() = default;
 
@@ -38,15 +44,24 @@ class Hash256 : private boost::noncopyable {
     void update(std::string_view data) noexcept;
     [[nodiscard]] Bytes finalize() noexcept;
 
+    //! \brief Finalizes the double hashing writing the digest into a fixed size buffer
+    //! \details Unlike finalize() no heap allocation happens (intermediate digest included)
+    //! \returns Whether the digest has been successfully computed
+    [[nodiscard]] bool finalize_to(std::span<uint8_t, kDigestSize> output) noexcept;
+
+    //! \brief Finalizes the double hashing returning the digest as h256
+    //! \remarks In case of any error the returned hash is all zeroes
+    [[nodiscard]] h256 finalize_h256() noexcept;
+
     [[nodiscard]] size_t digest_size() const noexcept { return hasher_.digest_size(); }
     [[nodiscard]] size_t ingested_size() const noexcept { return ingested_size_; }
 
-    static constexpr Bytes kEmptyHash() noexcept {
-        // Known empty hash
-        return {std::initializer_list<uint8_t>{0x5d, 0xf6, 0xe0, 0xe2, 0x76, 0x13, 0x59, 0xd3, 0x0a, 0x82, 0x75,
-                                               0x05, 0x8e, 0x29, 0x9f, 0xcc, 0x03, 0x81, 0x53, 0x45, 0x45, 0xf5,
-                                               0x5c, 0xf4, 0x3e, 0x41, 0x98, 0x3f, 0x5d, 0x4c, 0x94, 0x56}};
-    }
+    // Known empty hash
+    static constexpr std::array<uint8_t, kDigestSize> kEmptyHashDigest{
+        0x5d, 0xf6, 0xe0, 0xe2, 0x76, 0x13, 0x59, 0xd3, 0x0a, 0x82, 0x75, 0x05, 0x8e, 0x29, 0x9f, 0xcc,
+        0x03, 0x81, 0x53, 0x45, 0x45, 0xf5, 0x5c, 0xf4, 0x3e, 0x41, 0x98, 0x3f, 0x5d, 0x4c, 0x94, 0x56};
+
+    static constexpr Bytes kEmptyHash() noexcept { return {kEmptyHashDigest.begin(), kEmptyHashDigest.end()}; }
 
   private:
     Sha256 hasher_;
@@ -0,0 +1,400 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "hash256_batch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#include <core/common/assert.hpp>
+#include <core/common/endian.hpp>
+
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#define ZNODE_HASH256_BATCH_X86
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace znode::crypto {
+
+namespace {
+
+    constexpr size_t kBlockSize{64};
+    constexpr size_t kDigestSize{32};
+
+    constexpr std::array<uint32_t, 8> kInitialState{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                                    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    alignas(16) constexpr std::array<uint32_t, 64> kRoundConstants{
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+    using State = std::array<uint32_t, 8>;
+
+    //! \brief An input split into the blocks Sha256 consumes
+    //! \details Whole blocks are read directly from input data while the trailing one or two blocks (holding the
+    //! remainder of data, the padding and the bit length) are materialized
+    class PaddedInput {
+      public:
+        PaddedInput() = default;
+        explicit PaddedInput(ByteView data) noexcept
+            : data_{data}, full_blocks_{data.size() / kBlockSize}, blocks_{(data.size() + 8) / kBlockSize + 1} {
+            const auto remainder{data.size() % kBlockSize};
+            std::memcpy(tail_.data(), data.data() + full_blocks_ * kBlockSize, remainder);
+            tail_[remainder] = 0x80;
+            endian::store_big_u64(&tail_[(blocks_ - full_blocks_) * kBlockSize - 8], uint64_t{data.size()} * 8U);
+        }
+
+        //! \brief Returns the number of blocks to be hashed
+        [[nodiscard]] size_t blocks() const noexcept { return blocks_; }
+
+        //! \brief Returns the number of whole blocks directly readable from input data
+        [[nodiscard]] size_t full_blocks() const noexcept { return full_blocks_; }
+
+        //! \brief Returns a pointer to the beginning of the block at the provided index
+        [[nodiscard]] const uint8_t* block(size_t index) const noexcept {
+            if (index < full_blocks_) return data_.data() + index * kBlockSize;
+            return tail_.data() + (index - full_blocks_) * kBlockSize;
+        }
+
+        //! \brief Returns a pointer to the beginning of the trailing (materialized) blocks
+        [[nodiscard]] const uint8_t* tail() const noexcept { return tail_.data(); }
+
+      private:
+        ByteView data_{};
+        size_t full_blocks_{0};
+        size_t blocks_{0};
+        std::array<uint8_t, 2 * kBlockSize> tail_{};
+    };
+
+    //! \brief Builds the single block to be hashed in the second pass out of the first pass' state
+    std::array<uint8_t, kBlockSize> second_pass_block(const State& state) noexcept {
+        std::array<uint8_t, kBlockSize> ret{};
+        for (size_t i{0}; i < state.size(); ++i) endian::store_big_u32(&ret[i * 4], state[i]);
+        ret[kDigestSize] = 0x80;
+        endian::store_big_u64(&ret[kBlockSize - 8], uint64_t{kDigestSize} * 8U);
+        return ret;
+    }
+
+    h256 to_h256(const State& state) noexcept {
+        std::array<uint8_t, kDigestSize> digest{};
+        for (size_t i{0}; i < state.size(); ++i) endian::store_big_u32(&digest[i * 4], state[i]);
+        return h256{ByteView{digest}};
+    }
+
+    void transform_scalar(State& state, const uint8_t* data, size_t blocks) noexcept {
+        std::array<uint32_t, 64> w{};
+        for (; blocks not_eq 0U; --blocks, data += kBlockSize) {
+            for (size_t i{0}; i < 16; ++i) w[i] = endian::load_big_u32(data + i * 4);
+            for (size_t i{16}; i < 64; ++i) {
+                const uint32_t s0{std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3)};
+                const uint32_t s1{std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10)};
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            auto [a, b, c, d, e, f, g, h] = state;
+            for (size_t i{0}; i < 64; ++i) {
+                const uint32_t s1{std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25)};
+                const uint32_t ch{(e & f) ^ (~e & g)};
+                const uint32_t t1{h + s1 + ch + kRoundConstants[i] + w[i]};
+                const uint32_t s0{std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22)};
+                const uint32_t maj{(a & b) ^ (a & c) ^ (b & c)};
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + s0 + maj;
+            }
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+            state[5] += f;
+            state[6] += g;
+            state[7] += h;
+        }
+    }
+
+#if defined(ZNODE_HASH256_BATCH_X86)
+
+    // NOLINTBEGIN(*-reinterpret-cast)
+    __attribute__((target("sha,sse4.1"))) void transform_shani(State& state, const uint8_t* data,
+                                                               size_t blocks) noexcept {
+        const __m128i byte_swap_mask{_mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL)};
+
+        // Rearrange state words as required by sha256rnds2 : ABEF and CDGH
+        __m128i tmp{_mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1)};
+        __m128i state1{_mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B)};
+        __m128i state0{_mm_alignr_epi8(tmp, state1, 8)};
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+        for (; blocks not_eq 0U; --blocks, data += kBlockSize) {
+            const __m128i saved_state0{state0};
+            const __m128i saved_state1{state1};
+
+            __m128i msg[4];  // NOLINT(*-avoid-c-arrays) : std::array would drop vector type's attributes
+            for (size_t i{0}; i < 4; ++i) {
+                msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)),
+                                          byte_swap_mask);
+            }
+
+            // 16 groups of 4 rounds each : message schedule is computed on the fly in a ring of 4 registers
+#pragma GCC unroll 16
+            for (size_t group{0}; group < 16; ++group) {
+                const __m128i current{msg[group % 4]};
+                __m128i rounds_input{_mm_add_epi32(
+                    current, _mm_load_si128(reinterpret_cast<const __m128i*>(&kRoundConstants[group * 4])))};
+                state1 = _mm_sha256rnds2_epu32(state1, state0, rounds_input);
+                if (group >= 3 and group <= 14) {
+                    __m128i& next{msg[(group + 1) % 4]};
+                    next = _mm_add_epi32(next, _mm_alignr_epi8(current, msg[(group + 3) % 4], 4));
+                    next = _mm_sha256msg2_epu32(next, current);
+                }
+                rounds_input = _mm_shuffle_epi32(rounds_input, 0x0E);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, rounds_input);
+                if (group >= 1 and group <= 12) {
+                    __m128i& previous{msg[(group + 3) % 4]};
+                    previous = _mm_sha256msg1_epu32(previous, current);
+                }
+            }
+
+            state0 = _mm_add_epi32(state0, saved_state0);
+            state1 = _mm_add_epi32(state1, saved_state1);
+        }
+
+        // Back to ABCD and EFGH
+        tmp = _mm_shuffle_epi32(state0, 0x1B);
+        state1 = _mm_shuffle_epi32(state1, 0xB1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(tmp, state1, 0xF0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(state1, tmp, 8));
+    }
+    // NOLINTEND(*-reinterpret-cast)
+
+    namespace avx2 {
+        constexpr size_t kLanes{8};
+
+        template <int N>
+        __attribute__((target("avx2"))) inline __m256i rotr(__m256i x) noexcept {
+            return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N));
+        }
+
+        __attribute__((target("avx2"))) inline __m256i add(__m256i a, __m256i b) noexcept {
+            return _mm256_add_epi32(a, b);
+        }
+
+        //! \brief Loads the same big endian word from the block of each lane
+        __attribute__((target("avx2"))) inline __m256i load_word(const std::array<const uint8_t*, kLanes>& blocks,
+                                                                 size_t offset) noexcept {
+            return _mm256_set_epi32(static_cast<int>(endian::load_big_u32(blocks[7] + offset)),
+                                    static_cast<int>(endian::load_big_u32(blocks[6] + offset)),
+                                    static_cast<int>(endian::load_big_u32(blocks[5] + offset)),
+                                    static_cast<int>(endian::load_big_u32(blocks[4] + offset)),
+                                    static_cast<int>(endian::load_big_u32(blocks[3] + offset)),
+                                    static_cast<int>(endian::load_big_u32(blocks[2] + offset)),
+                                    static_cast<int>(endian::load_big_u32(blocks[1] + offset)),
+                                    static_cast<int>(endian::load_big_u32(blocks[0] + offset)));
+        }
+
+        //! \brief Processes one block for each of the lanes
+        //! \remarks Lanes not flagged in active_mask retain their state
+        __attribute__((target("avx2"))) void transform(__m256i (&state)[8],  // NOLINT(*-avoid-c-arrays)
+                                                       const std::array<const uint8_t*, kLanes>& blocks,
+                                                       __m256i active_mask) noexcept {
+            __m256i w[64];  // NOLINT(*-avoid-c-arrays) : std::array would drop vector type's attributes
+            for (size_t i{0}; i < 16; ++i) w[i] = load_word(blocks, i * 4);
+            for (size_t i{16}; i < 64; ++i) {
+                const __m256i s0{_mm256_xor_si256(_mm256_xor_si256(rotr<7>(w[i - 15]), rotr<18>(w[i - 15])),
+                                                  _mm256_srli_epi32(w[i - 15], 3))};
+                const __m256i s1{_mm256_xor_si256(_mm256_xor_si256(rotr<17>(w[i - 2]), rotr<19>(w[i - 2])),
+                                                  _mm256_srli_epi32(w[i - 2], 10))};
+                w[i] = add(add(w[i - 16], s0), add(w[i - 7], s1));
+            }
+
+            auto [a, b, c, d, e, f, g, h] = state;
+            for (size_t i{0}; i < 64; ++i) {
+                const __m256i s1{_mm256_xor_si256(_mm256_xor_si256(rotr<6>(e), rotr<11>(e)), rotr<25>(e))};
+                const __m256i ch{_mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g))};
+                const __m256i t1{add(add(add(h, s1), add(ch, w[i])),
+                                     _mm256_set1_epi32(static_cast<int>(kRoundConstants[i])))};
+                const __m256i s0{_mm256_xor_si256(_mm256_xor_si256(rotr<2>(a), rotr<13>(a)), rotr<22>(a))};
+                const __m256i maj{_mm256_xor_si256(_mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(a, c)),
+                                                   _mm256_and_si256(b, c))};
+                h = g;
+                g = f;
+                f = e;
+                e = add(d, t1);
+                d = c;
+                c = b;
+                b = a;
+                a = add(t1, add(s0, maj));
+            }
+
+            const __m256i working[8]{a, b, c, d, e, f, g, h};  // NOLINT(*-avoid-c-arrays)
+            for (size_t i{0}; i < 8; ++i) {
+                state[i] = _mm256_blendv_epi8(state[i], add(state[i], working[i]), active_mask);
+            }
+        }
+
+        //! \brief Computes the hashes of up to kLanes inputs at once
+        __attribute__((target("avx2"))) void hash256(std::span<const ByteView> inputs,
+                                                     std::span<h256> outputs) noexcept {
+            ASSERT_PRE(inputs.size() <= kLanes);
+            std::array<PaddedInput, kLanes> padded_inputs{};
+            size_t max_blocks{0};
+            for (size_t lane{0}; lane < inputs.size(); ++lane) {
+                padded_inputs[lane] = PaddedInput(inputs[lane]);
+                max_blocks = std::max(max_blocks, padded_inputs[lane].blocks());
+            }
+
+            // Lanes with no more blocks (or not used) read a dummy block and retain their state
+            static constexpr std::array<uint8_t, kBlockSize> kDummyBlock{};
+            __m256i state[8];  // NOLINT(*-avoid-c-arrays) : std::array would drop vector type's attributes
+            for (size_t i{0}; i < 8; ++i) state[i] = _mm256_set1_epi32(static_cast<int>(kInitialState[i]));
+            std::array<const uint8_t*, kLanes> blocks{};
+            std::array<int, kLanes> active{};
+            for (size_t block{0}; block < max_blocks; ++block) {
+                for (size_t lane{0}; lane < kLanes; ++lane) {
+                    const bool lane_active{block < padded_inputs[lane].blocks()};
+                    blocks[lane] = lane_active ? padded_inputs[lane].block(block) : kDummyBlock.data();
+                    active[lane] = lane_active ? -1 : 0;
+                }
+                transform(state, blocks,
+                          _mm256_set_epi32(active[7], active[6], active[5], active[4], active[3], active[2],
+                                           active[1], active[0]));
+            }
+
+            // Second pass : one block per lane
+            alignas(32) std::array<std::array<uint32_t, kLanes>, 8> words{};
+            for (size_t i{0}; i < 8; ++i) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(words[i].data()), state[i]);  // NOLINT
+            }
+            std::array<std::array<uint8_t, kBlockSize>, kLanes> second_blocks{};
+            for (size_t lane{0}; lane < kLanes; ++lane) {
+                State lane_state{};
+                for (size_t i{0}; i < lane_state.size(); ++i) lane_state[i] = words[i][lane];
+                second_blocks[lane] = second_pass_block(lane_state);
+                blocks[lane] = second_blocks[lane].data();
+            }
+            for (size_t i{0}; i < 8; ++i) state[i] = _mm256_set1_epi32(static_cast<int>(kInitialState[i]));
+            transform(state, blocks, _mm256_set1_epi32(-1));
+
+            for (size_t i{0}; i < 8; ++i) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(words[i].data()), state[i]);  // NOLINT
+            }
+            for (size_t lane{0}; lane < inputs.size(); ++lane) {
+                State lane_state{};
+                for (size_t i{0}; i < lane_state.size(); ++i) lane_state[i] = words[i][lane];
+                outputs[lane] = to_h256(lane_state);
+            }
+        }
+    }  // namespace avx2
+
+    bool cpu_has_sha_extensions() noexcept {
+        unsigned int eax{0};
+        unsigned int ebx{0};
+        unsigned int ecx{0};
+        unsigned int edx{0};
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) return false;
+        return (ebx & bit_SHA) not_eq 0U and __builtin_cpu_supports("sse4.1");
+    }
+
+#endif
+
+    //! \brief Computes the hash of a single input by means of the provided block transform function
+    template <auto Transform>
+    h256 hash256_one(ByteView input) noexcept {
+        const PaddedInput padded_input(input);
+        State state{kInitialState};
+        Transform(state, padded_input.block(0), padded_input.full_blocks());
+        Transform(state, padded_input.tail(), padded_input.blocks() - padded_input.full_blocks());
+        const auto block{second_pass_block(state)};
+        state = kInitialState;
+        Transform(state, block.data(), 1);
+        return to_h256(state);
+    }
+
+}  // namespace
+
+Hash256Batch::Implementation Hash256Batch::implementation() noexcept {
+    static const Implementation ret{[]() {
+        if (is_supported(Implementation::kShaNi)) return Implementation::kShaNi;
+        if (is_supported(Implementation::kAvx2)) return Implementation::kAvx2;
+        return Implementation::kScalar;
+    }()};
+    return ret;
+}
+
+bool Hash256Batch::is_supported(Implementation implementation) noexcept {
+    switch (implementation) {
+        using enum Implementation;
+#if defined(ZNODE_HASH256_BATCH_X86)
+        case kShaNi:
+            return cpu_has_sha_extensions();
+        case kAvx2:
+            return __builtin_cpu_supports("avx2");
+#else
+        case kShaNi:
+        case kAvx2:
+            return false;
+#endif
+        case kScalar:
+            return true;
+    }
+    return false;
+}
+
+void Hash256Batch::compute(std::span<const ByteView> inputs, std::span<h256> outputs) noexcept {
+    compute(implementation(), inputs, outputs);
+}
+
+void Hash256Batch::compute(Implementation implementation, std::span<const ByteView> inputs,
+                           std::span<h256> outputs) noexcept {
+    ASSERT_PRE(outputs.size() >= inputs.size());
+    ASSERT_PRE(is_supported(implementation));
+    switch (implementation) {
+        using enum Implementation;
+#if defined(ZNODE_HASH256_BATCH_X86)
+        case kShaNi:
+            for (size_t i{0}; i < inputs.size(); ++i) outputs[i] = hash256_one<transform_shani>(inputs[i]);
+            return;
+        case kAvx2:
+            for (size_t i{0}; i < inputs.size(); i += avx2::kLanes) {
+                const auto count{std::min(avx2::kLanes, inputs.size() - i)};
+                avx2::hash256(inputs.subspan(i, count), outputs.subspan(i, count));
+            }
+            return;
+#else
+        case kShaNi:
+        case kAvx2:
+#endif
+        case kScalar:
+            for (size_t i{0}; i < inputs.size(); ++i) outputs[i] = hash256_one<transform_scalar>(inputs[i]);
+            return;
+    }
+}
+
+}  // namespace znode::crypto
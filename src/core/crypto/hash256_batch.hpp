@@ -0,0 +1,54 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <span>
+
+#include <core/common/base.hpp>
+#include <core/types/hash.hpp>
+
+namespace znode::crypto {
+
+//! \brief Computes Bitcoin's 256 bit hashes (double Sha256) of many independent inputs at once
+//! \details Unlike Hash256 this does not go through OpenSSL's EVP interface: it relies on the best Sha256
+//! implementation available on the running CPU (detected once at runtime) which is either the SHA extensions
+//! (one input at a time), AVX2 (eight inputs per pass in separate lanes) or plain portable code
+class Hash256Batch {
+  public:
+    enum class Implementation {
+        kScalar,  // Portable code
+        kAvx2,    // AVX2 multi-buffer (8 lanes)
+        kShaNi,   // Intel SHA extensions
+    };
+
+    //! \brief Returns the implementation selected for the running CPU
+    [[nodiscard]] static Implementation implementation() noexcept;
+
+    //! \brief Returns whether the running CPU supports the provided implementation
+    [[nodiscard]] static bool is_supported(Implementation implementation) noexcept;
+
+    //! \brief Computes the hash of each input into the output at the same position
+    //! \remarks Outputs' size MUST be greater or equal to inputs' size
+    static void compute(std::span<const ByteView> inputs, std::span<h256> outputs) noexcept;
+
+    //! \brief Computes the hash of each input into the output at the same position using a specific implementation
+    //! \remarks The implementation MUST be supported by the running CPU (see is_supported)
+    static void compute(Implementation implementation, std::span<const ByteView> inputs,
+                        std::span<h256> outputs) noexcept;
+};
+
+}  // namespace znode::crypto
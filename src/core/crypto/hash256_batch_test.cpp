@@ -0,0 +1,70 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <magic_enum.hpp>
+
+#include <core/common/random.hpp>
+#include <core/crypto/hash256.hpp>
+#include <core/crypto/hash256_batch.hpp>
+
+namespace znode::crypto {
+
+TEST_CASE("Hash256Batch", "[crypto]") {
+    CHECK(Hash256Batch::is_supported(Hash256Batch::Implementation::kScalar));
+    CHECK(Hash256Batch::is_supported(Hash256Batch::implementation()));
+
+    // Inputs of all sizes up to 4 blocks (padding spanning one or two trailing blocks) mixed in the same batch
+    const auto data{get_random_bytes(300)};
+    std::vector<ByteView> inputs;
+    std::vector<h256> expected;
+    for (size_t size{0}; size < data.size(); ++size) {
+        inputs.emplace_back(data.data(), size);
+        Hash256 hasher(inputs.back());
+        expected.emplace_back(ByteView{hasher.finalize()});
+    }
+
+    using enum Hash256Batch::Implementation;
+    for (const auto implementation : {kScalar, kAvx2, kShaNi}) {
+        if (not Hash256Batch::is_supported(implementation)) continue;
+        INFO("Implementation " << magic_enum::enum_name(implementation));
+
+        std::vector<h256> outputs(inputs.size());
+        Hash256Batch::compute(implementation, inputs, outputs);
+        CHECK(outputs == expected);
+
+        // Batches of any size (not multiple of lanes)
+        for (const size_t batch_size : {1U, 3U, 8U, 13U}) {
+            std::vector<h256> batch_outputs(batch_size);
+            for (size_t offset{0}; offset + batch_size <= inputs.size(); offset += batch_size * 7) {
+                Hash256Batch::compute(implementation, std::span{inputs}.subspan(offset, batch_size), batch_outputs);
+                CHECK(std::ranges::equal(batch_outputs, std::span{expected}.subspan(offset, batch_size)));
+            }
+        }
+    }
+
+    // Empty input gives the known empty hash
+    std::vector<h256> outputs(1);
+    const std::vector<ByteView> empty_input{ByteView{}};
+    Hash256Batch::compute(empty_input, outputs);
+    CHECK(outputs[0] == h256{ByteView{Hash256::kEmptyHash()}});
+}
+
+}  // namespace znode::crypto
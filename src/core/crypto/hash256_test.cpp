@@ -14,6 +14,7 @@
    limitations under the License.
 */
 
+#include <array>
 #include <vector>
 
 #include <catch2/catch.hpp>
@@ -46,4 +47,22 @@ TEST_CASE("Bitcoin Hash256", "[crypto]") {
     Hash256 hasher;
     run_hasher_tests(hasher, inputs, digests);
 }
+
+TEST_CASE("Bitcoin Hash256 fixed size digest", "[crypto]") {
+    const std::vector<std::string> inputs{"", "abc", std::string(1_KiB, 'z')};
+    for (const auto& input : inputs) {
+        Hash256 hasher(input);
+        const auto expected{hasher.finalize()};
+        REQUIRE(expected.size() == Hash256::kDigestSize);
+
+        std::array<uint8_t, Hash256::kDigestSize> digest{};
+        hasher.init(input);
+        REQUIRE(hasher.finalize_to(digest));
+        CHECK(ByteView{digest.data(), digest.size()} == ByteView{expected});
+
+        hasher.init(input);
+        CHECK(hasher.finalize_h256() == h256{ByteView{expected}});
+    }
+    CHECK(Hash256::kEmptyHash() == Bytes{Hash256::kEmptyHashDigest.begin(), Hash256::kEmptyHashDigest.end()});
+}
 }  // namespace znode::crypto
@@ -14,11 +14,18 @@
    limitations under the License.
 */
 
+#include <thread>
+#include <vector>
+
 #include <benchmark/benchmark.h>
+#include <openssl/evp.h>
 
 #include <core/common/base.hpp>
 #include <core/common/cast.hpp>
 #include <core/common/misc.hpp>
+#include <core/common/object_pool.hpp>
+#include <core/crypto/hash256.hpp>
+#include <core/crypto/hash256_batch.hpp>
 #include <core/crypto/md.hpp>
 
 namespace znode::crypto {
@@ -62,8 +69,94 @@ void bench_sha512(benchmark::State& state) {
     state.SetBytesProcessed(state.range() * static_cast<int64_t>(state.iterations()));
 }
 
+static constexpr size_t kBatchSize{64};  // Number of independent inputs hashed per iteration
+
+//! \brief Builds kBatchSize independent inputs of range(0) bytes each
+std::vector<ByteView> make_batch_inputs(const benchmark::State& state) {
+    const auto input_size{static_cast<size_t>(state.range(0))};
+    std::vector<ByteView> ret;
+    for (size_t i{0}; i < kBatchSize; ++i) {
+        ret.emplace_back(byte_ptr_cast(random_alpha_string.data()) + i * input_size, input_size);
+    }
+    return ret;
+}
+
+void bench_hash256(benchmark::State& state) {
+    const auto inputs{make_batch_inputs(state)};
+    std::vector<h256> outputs(inputs.size());
+    for ([[maybe_unused]] auto _ : state) {
+        for (size_t i{0}; i < inputs.size(); ++i) {
+            Hash256 hasher(inputs[i]);
+            outputs[i] = h256(ByteView{hasher.finalize()});
+        }
+        benchmark::DoNotOptimize(outputs.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(kBatchSize) * static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(state.range(0) * state.items_processed());
+}
+
+template <Hash256Batch::Implementation Implementation>
+void bench_hash256_batch(benchmark::State& state) {
+    if (not Hash256Batch::is_supported(Implementation)) {
+        state.SkipWithError("Not supported by this CPU");
+        return;
+    }
+    const auto inputs{make_batch_inputs(state)};
+    std::vector<h256> outputs(inputs.size());
+    for ([[maybe_unused]] auto _ : state) {
+        Hash256Batch::compute(Implementation, inputs, outputs);
+        benchmark::DoNotOptimize(outputs.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(kBatchSize) * static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(state.range(0) * state.items_processed());
+}
+
+static constexpr size_t kContextsInputSize{80};  // A block header
+
+//! \brief Hashes with a new digest on every iteration : contexts come from the per thread cache
+void bench_sha256_contexts_cache(benchmark::State& state) {
+    const ByteView data(byte_ptr_cast(random_alpha_string.data()), kContextsInputSize);
+    for ([[maybe_unused]] auto _ : state) {
+        Sha256 hasher(data);
+        auto hash{hasher.finalize()};
+        benchmark::DoNotOptimize(hash);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+//! \brief Same as above but contexts come from a process wide mutex guarded pool (as it used to be)
+void bench_sha256_contexts_pool(benchmark::State& state) {
+    struct ContextDeleter {
+        void operator()(EVP_MD_CTX* ptr) const noexcept { EVP_MD_CTX_free(ptr); }
+    };
+    static ObjectPool<EVP_MD_CTX, ContextDeleter> contexts_pool(/*thread_safe=*/true);
+    const ByteView data(byte_ptr_cast(random_alpha_string.data()), kContextsInputSize);
+    Bytes hash(32, 0);
+    for ([[maybe_unused]] auto _ : state) {
+        auto* context{contexts_pool.empty() ? EVP_MD_CTX_new() : contexts_pool.acquire()};
+        if (context == nullptr) context = EVP_MD_CTX_new();
+        EVP_DigestInit_ex(context, EVP_get_digestbyname("SHA256"), nullptr);
+        EVP_DigestUpdate(context, data.data(), data.size());
+        EVP_DigestFinal_ex(context, hash.data(), nullptr);
+        benchmark::DoNotOptimize(hash);
+        contexts_pool.add(context);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
 BENCHMARK(bench_sha1)->RangeMultiplier(kInputSizeMultiplier)->Range(kMinInputSize, kMaxInputSize);
 BENCHMARK(bench_sha256)->RangeMultiplier(kInputSizeMultiplier)->Range(kMinInputSize, kMaxInputSize);
 BENCHMARK(bench_sha512)->RangeMultiplier(kInputSizeMultiplier)->Range(kMinInputSize, kMaxInputSize);
 
+static const auto kMaxThreads{static_cast<int>(std::max(1U, std::thread::hardware_concurrency()))};
+BENCHMARK(bench_sha256_contexts_cache)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK(bench_sha256_contexts_pool)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+// Typical small inputs : a hash (32), a merkle node (64), a block header (80) and larger payloads
+static const std::vector<int64_t> kBatchInputSizes{32, 64, 80, 140, 512};
+BENCHMARK(bench_hash256)->ArgsProduct({kBatchInputSizes});
+BENCHMARK_TEMPLATE(bench_hash256_batch, Hash256Batch::Implementation::kScalar)->ArgsProduct({kBatchInputSizes});
+BENCHMARK_TEMPLATE(bench_hash256_batch, Hash256Batch::Implementation::kAvx2)->ArgsProduct({kBatchInputSizes});
+BENCHMARK_TEMPLATE(bench_hash256_batch, Hash256Batch::Implementation::kShaNi)->ArgsProduct({kBatchInputSizes});
+
 }  // namespace znode::crypto
@@ -17,6 +17,8 @@
 #pragma once
 
 #include <memory>
+#include <span>
+#include <vector>
 
 #include <openssl/evp.h>
 
@@ -24,32 +26,14 @@
 #include <core/common/base.hpp>
 #include <core/common/cast.hpp>
 #include <core/common/endian.hpp>
-#include <core/common/object_pool.hpp>
 
 namespace znode::crypto {
 
-//! \brief Explicit deleter for EVP_MD_CTXes
-struct MDContextDeleter {
-    constexpr MDContextDeleter() noexcept = default;
-    void operator()(EVP_MD_CTX* ptr) const noexcept { EVP_MD_CTX_free(ptr); }
-};
-
-//! \brief A collection of recycle-able MD Contexts
-static ObjectPool<EVP_MD_CTX, MDContextDeleter> MDContexts(/*thread_safe=*/true);
-
-//! \brief Explicit recycler for EVP_MD_CTXes
-struct MDContextRecycler {
-    constexpr MDContextRecycler() noexcept = default;
-    void operator()(EVP_MD_CTX* ptr) const noexcept { MDContexts.add(ptr); }
-};
-
 //! \brief This class is templatized wrapper around OpenSSL's EVP Message Digests
 template <StringLiteral T>
 class MessageDigest {
   public:
-    MessageDigest()
-        : digest_{EVP_get_digestbyname(T.value)},
-          digest_context_{MDContexts.empty() ? EVP_MD_CTX_new() : MDContexts.acquire()} {
+    MessageDigest() : digest_{get_digest()}, digest_context_{contexts_cache_.acquire()} {
         ASSERT(digest_ != nullptr);
         ASSERT(digest_context_ != nullptr);
         ASSERT(EVP_DigestInit_ex(digest_context_.get(), digest_, nullptr) == 1);
@@ -132,6 +116,15 @@ class MessageDigest {
         return ret;
     }
 
+    //! \brief Finalizes the digest process writing the digest into the provided buffer
+    //! \details Same as finalize() (with no compression) but no allocation happens
+    //! \remarks The output buffer MUST be at least digest_size() bytes wide
+    //! \returns Whether the digest has been successfully computed
+    [[nodiscard]] bool finalize_to(std::span<uint8_t> output) noexcept {
+        ASSERT(output.size() >= digest_size_);
+        return EVP_DigestFinal_ex(digest_context_.get(), output.data(), nullptr) == 1;
+    }
+
     //! \brief Returns the digest name e.g. "SHA256"
     [[nodiscard]] std::string digest_name() const noexcept { return std::string(T.value); }
 
@@ -145,8 +138,67 @@ class MessageDigest {
     [[nodiscard]] size_t ingested_size() const noexcept { return ingested_size_; }
 
   private:
-    const EVP_MD* digest_{nullptr};                                           // The digest function
-    std::unique_ptr<EVP_MD_CTX, MDContextRecycler> digest_context_{nullptr};  // The digest context
+    //! \brief A per thread cache of recycle-able contexts for this digest
+    //! \details Contexts are only ever used with this digest hence, on re-initialization, OpenSSL reuses
+    //! the already set up algorithm context. Being per thread no locking is involved.
+    class ContextsCache {
+      public:
+        static constexpr size_t kMaxCachedContexts{64};
+
+        ContextsCache() noexcept { alive_ = true; }
+        ~ContextsCache() {
+            alive_ = false;
+            for (auto* context : contexts_) EVP_MD_CTX_free(context);
+        }
+        ContextsCache(const ContextsCache&) = delete;
+        ContextsCache& operator=(const ContextsCache&) = delete;
+
+        [[nodiscard]] EVP_MD_CTX* acquire() noexcept {
+            if (contexts_.empty()) return EVP_MD_CTX_new();
+            auto* ret{contexts_.back()};
+            contexts_.pop_back();
+            return ret;
+        }
+
+        void recycle(EVP_MD_CTX* context) noexcept {
+            if (contexts_.size() >= kMaxCachedContexts) {
+                EVP_MD_CTX_free(context);
+                return;
+            }
+            contexts_.push_back(context);
+        }
+
+        //! \brief Whether the cache of the current thread is usable
+        //! \remarks Digests may outlive the thread local cache (e.g. static ones)
+        [[nodiscard]] static bool alive() noexcept { return alive_; }
+
+      private:
+        static inline thread_local bool alive_{false};
+        std::vector<EVP_MD_CTX*> contexts_;
+    };
+
+    //! \brief Returns the contexts to the cache of the thread destroying the digest
+    struct ContextRecycler {
+        constexpr ContextRecycler() noexcept = default;
+        void operator()(EVP_MD_CTX* ptr) const noexcept {
+            if (ContextsCache::alive()) {
+                contexts_cache_.recycle(ptr);
+            } else {
+                EVP_MD_CTX_free(ptr);
+            }
+        }
+    };
+
+    //! \brief Returns the digest function (looked up only once)
+    static const EVP_MD* get_digest() noexcept {
+        static const EVP_MD* digest{EVP_get_digestbyname(T.value)};
+        return digest;
+    }
+
+    static inline thread_local ContextsCache contexts_cache_{};  // One instance per thread and digest
+
+    const EVP_MD* digest_{nullptr};                                         // The digest function
+    std::unique_ptr<EVP_MD_CTX, ContextRecycler> digest_context_{nullptr};  // The digest context
     size_t digest_size_{0};                                                   // The size in bytes of this digest
     size_t block_size_{0};                                                    // The size in bytes of an input block
     size_t ingested_size_{0};                                                 // Number of bytes ingested
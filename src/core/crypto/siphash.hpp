@@ -0,0 +1,83 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <bit>
+#include <cstdint>
+
+namespace znode::crypto {
+
+//! \brief SipHash-2-4 over 64 bit words computed with no OpenSSL contexts nor allocations
+//! \details Yields the same results of SipHash24 (see evp_mac.hpp) fed with the little endian bytes of the same
+//! words. Meant for keyed hashing of small fixed size keys (e.g. in hash tables) where the construction of a
+//! SipHash24 on every call would dominate the cost
+class SipHasher {
+  public:
+    constexpr SipHasher(uint64_t k0, uint64_t k1) noexcept
+        : v0_{0x736f6d6570736575ULL ^ k0},
+          v1_{0x646f72616e646f6dULL ^ k1},
+          v2_{0x6c7967656e657261ULL ^ k0},
+          v3_{0x7465646279746573ULL ^ k1} {}
+
+    //! \brief Accumulates one more word
+    constexpr SipHasher& update(uint64_t word) noexcept {
+        v3_ ^= word;
+        sip_round();
+        sip_round();
+        v0_ ^= word;
+        ++words_count_;
+        return *this;
+    }
+
+    //! \brief Returns the hash of the words accumulated so far
+    [[nodiscard]] constexpr uint64_t finalize() const noexcept {
+        SipHasher ret{*this};
+        const uint64_t last_word{(words_count_ * sizeof(uint64_t)) << 56U};  // Length of the input in the top byte
+        ret.v3_ ^= last_word;
+        ret.sip_round();
+        ret.sip_round();
+        ret.v0_ ^= last_word;
+        ret.v2_ ^= 0xffU;
+        for (int i{0}; i < 4; ++i) ret.sip_round();
+        return ret.v0_ ^ ret.v1_ ^ ret.v2_ ^ ret.v3_;
+    }
+
+  private:
+    constexpr void sip_round() noexcept {
+        v0_ += v1_;
+        v1_ = std::rotl(v1_, 13);
+        v1_ ^= v0_;
+        v0_ = std::rotl(v0_, 32);
+        v2_ += v3_;
+        v3_ = std::rotl(v3_, 16);
+        v3_ ^= v2_;
+        v0_ += v3_;
+        v3_ = std::rotl(v3_, 21);
+        v3_ ^= v0_;
+        v2_ += v1_;
+        v1_ = std::rotl(v1_, 17);
+        v1_ ^= v2_;
+        v2_ = std::rotl(v2_, 32);
+    }
+
+    uint64_t v0_;
+    uint64_t v1_;
+    uint64_t v2_;
+    uint64_t v3_;
+    uint64_t words_count_{0};  // Number of words accumulated
+};
+
+}  // namespace znode::crypto
@@ -0,0 +1,58 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <core/common/endian.hpp>
+#include <core/common/random.hpp>
+#include <core/crypto/evp_mac.hpp>
+#include <core/crypto/siphash.hpp>
+
+namespace znode::crypto {
+
+TEST_CASE("SipHasher", "[crypto]") {
+    SECTION("Test vectors") {
+        // See bitcoin/src/test/siphash_tests.cpp : results for input bytes 0, 1, 2 ... (only whole words here)
+        const std::vector<uint64_t> siphash_tests{0x726fdb47dd0e0e31, 0x93f5f5799a932462, 0x3f2acc7f57c29bdb,
+                                                  0xb8ad50c6f649af94, 0x7127512f72f27cce, 0x0e3ea96b5304a7d0,
+                                                  0xe612a3cb9ecba951, 0xb78dbfaf3a8d83bd};
+        SipHasher hasher(0x0706050403020100ULL, 0x0F0E0D0C0B0A0908ULL);
+        for (uint64_t i{0}; i < siphash_tests.size(); ++i) {
+            INFO("words = " << i);
+            CHECK(hasher.finalize() == siphash_tests[i]);
+            const uint64_t first_byte{i * sizeof(uint64_t)};
+            hasher.update(0x0706050403020100ULL + first_byte * 0x0101010101010101ULL);
+        }
+    }
+
+    SECTION("Same as SipHash24") {
+        for (size_t i{0}; i < 100; ++i) {
+            const auto k0{randomize<uint64_t>()};
+            const auto k1{randomize<uint64_t>()};
+            SipHasher hasher(k0, k1);
+            SipHash24 reference_hasher(k0, k1);
+            const auto words_count{randomize<size_t>(size_t{0}, size_t{5})};
+            for (size_t j{0}; j < words_count; ++j) {
+                const auto word{randomize<uint64_t>()};
+                hasher.update(word);
+                reference_hasher.update(word);  // Little endian bytes
+            }
+            CHECK(hasher.finalize() == endian::load_little_u64(reference_hasher.finalize().data()));
+        }
+    }
+}
+
+}  // namespace znode::crypto
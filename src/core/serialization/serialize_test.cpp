@@ -124,6 +124,37 @@ TEST_CASE("Serialization stream", "[serialization]") {
     CHECK(dst.avail() == data.size());
 }
 
+TEST_CASE("Serialization stream attached", "[serialization]") {
+    const Bytes data{0x00, 0x01, 0x02, 0xff};
+    SDataStream stream(Scope::kNetwork, 0);
+    stream.attach(data);
+    CHECK(stream.attached());
+    CHECK(stream.size() == data.size());
+
+    auto read_result{stream.read(2)};
+    REQUIRE_FALSE(read_result.has_error());
+    CHECK(read_result.value().data() == data.data());  // No copy
+    CHECK(stream.avail() == 2);
+
+    stream.consume();
+    CHECK(stream.attached());
+    CHECK(stream.size() == 2);
+    CHECK(stream.tellg() == 0);
+
+    // Any mutation copies data into owned buffer
+    stream.push_back(0x11);
+    CHECK_FALSE(stream.attached());
+    CHECK(stream.size() == 3);
+    CHECK(stream[0] == 0x02);
+    CHECK(stream[2] == 0x11);
+    CHECK(data.size() == 4);
+
+    stream.attach(data);
+    stream.clear();
+    CHECK_FALSE(stream.attached());
+    CHECK(stream.empty());
+}
+
 TEST_CASE("Serialization of base types", "[serialization]") {
     SECTION("Write Types", "[serialization]") {
         SDataStream stream(Scope::kStorage, 0);
@@ -204,6 +235,19 @@ TEST_CASE("Serialization of base types", "[serialization]") {
         }
     }
 
+    SECTION("Big unsigned integrals", "[serialization]") {
+        SDataStream stream(Scope::kStorage, 0);
+        uint256_t value{0x0102};  // Leading zero bytes must not be dropped
+        REQUIRE_FALSE(stream.bind(value, Action::kSerialize).has_error());
+        CHECK(stream.size() == ssizeof<uint256_t>);
+        CHECK(stream.to_string() == std::string(60, '0') + "0102");
+
+        uint256_t read_value{0};
+        REQUIRE_FALSE(stream.bind(read_value, Action::kDeserialize).has_error());
+        CHECK(read_value == value);
+        CHECK(stream.eof());
+    }
+
     SECTION("Write compact") {
         SDataStream stream(Scope::kStorage, 0);
         uint64_t value{0};
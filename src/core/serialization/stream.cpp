@@ -37,18 +37,21 @@ DataStream::DataStream(const std::span<value_type> data) {
 
 outcome::result<void> DataStream::reserve(size_type count) {
     if (count > kMaxStreamSize) return Error::kInputTooLarge;
+    detach();
     buffer_.reserve(count);
     return outcome::success();
 }
 
 outcome::result<void> DataStream::resize(size_type new_size, value_type item) {
     if (new_size > kMaxStreamSize) return Error::kInputTooLarge;
+    detach();
     buffer_.resize(new_size, item);
     return outcome::success();
 }
 
 outcome::result<void> DataStream::write(ByteView data) {
     if (size() + data.size() > kMaxStreamSize) return Error::kInputTooLarge;
+    detach();
     buffer_.insert(buffer_.end(), data.begin(), data.end());
     return outcome::success();
 }
@@ -57,7 +60,10 @@ outcome::result<void> DataStream::write(const uint8_t* const ptr, DataStream::si
     return write({ptr, count});
 }
 
-DataStream::iterator DataStream::begin() { return buffer_.begin() + static_cast<difference_type>(read_position_); }
+DataStream::iterator DataStream::begin() {
+    detach();
+    return buffer_.begin() + static_cast<difference_type>(read_position_);
+}
 
 void DataStream::rewind(std::optional<size_type> count) noexcept {
     if (not count.has_value()) {
@@ -67,11 +73,18 @@ void DataStream::rewind(std::optional<size_type> count) noexcept {
     }
 }
 
-DataStream::iterator DataStream::end() { return buffer_.end(); }
+DataStream::iterator DataStream::end() {
+    detach();
+    return buffer_.end();
+}
 
-void DataStream::insert(iterator where, value_type item) { buffer_.insert(std::move(where), item); }
+void DataStream::insert(iterator where, value_type item) {
+    ASSERT_PRE(not attached_ and "Iterators must be obtained from begin() or end()");
+    buffer_.insert(std::move(where), item);
+}
 
 void DataStream::erase(iterator where) {
+    ASSERT_PRE(not attached_ and "Iterators must be obtained from begin() or end()");
     if (where == end()) return;
 
     const auto pos(static_cast<size_type>(std::distance(buffer_.begin(), where)));
@@ -83,7 +96,8 @@ void DataStream::erase(iterator where) {
 }
 
 void DataStream::erase(const size_type pos, std::optional<size_type> count) {
-    if ((count.has_value() and *count == 0) or pos >= buffer_.size()) return;
+    if ((count.has_value() and *count == 0) or pos >= size()) return;
+    detach();
 
     const auto max_count{buffer_.size() - pos};
     count = std::min(count.value_or(std::numeric_limits<size_type>::max()), max_count);
@@ -94,48 +108,78 @@ void DataStream::erase(const size_type pos, std::optional<size_type> count) {
     }
 }
 
-void DataStream::push_back(uint8_t byte) { buffer_.push_back(byte); }
+void DataStream::push_back(uint8_t byte) {
+    detach();
+    buffer_.push_back(byte);
+}
 
 outcome::result<ByteView> DataStream::read(std::optional<size_t> count) noexcept {
     const auto bytes_being_read{count.value_or(avail())};
     if (bytes_being_read > avail()) return Error::kReadOverflow;
-    ByteView ret(&buffer_[read_position_], bytes_being_read);
+    ByteView ret(contents().substr(read_position_, bytes_being_read));
     read_position_ += bytes_being_read;
     return ret;
 }
 
 void DataStream::ignore(size_type count) noexcept { read_position_ += std::min<size_type>(count, avail()); }
 
-bool DataStream::eof() const noexcept { return read_position_ >= buffer_.size(); }
+bool DataStream::eof() const noexcept { return read_position_ >= size(); }
 
 DataStream::size_type DataStream::tellg() const noexcept { return read_position_; }
 
 DataStream::size_type DataStream::seekg(size_type position) noexcept {
-    read_position_ = std::min(position, buffer_.size());
+    read_position_ = std::min(position, size());
     return read_position_;
 }
 
-std::string DataStream::to_string() const { return enc::hex::encode({buffer_.data(), buffer_.size()}, false); }
+std::string DataStream::to_string() const { return enc::hex::encode(contents(), false); }
 
 void DataStream::consume(std::optional<size_type> pos) noexcept {
     const size_t count{std::min(read_position_, pos.value_or(std::numeric_limits<size_type>::max()))};
-    buffer_.erase(0, count);
+    if (attached_) {
+        external_data_.remove_prefix(count);
+    } else {
+        buffer_.erase(0, count);
+    }
     read_position_ -= count;
 }
 
-DataStream::size_type DataStream::size() const noexcept { return buffer_.size(); }
+DataStream::size_type DataStream::size() const noexcept {
+    return attached_ ? external_data_.size() : buffer_.size();
+}
 
-bool DataStream::empty() const noexcept { return buffer_.empty(); }
+bool DataStream::empty() const noexcept { return size() == 0U; }
 
-DataStream::size_type DataStream::avail() const noexcept { return buffer_.size() - read_position_; }
+DataStream::size_type DataStream::avail() const noexcept { return size() - read_position_; }
 
 void DataStream::clear() noexcept {
     buffer_.clear();
+    external_data_ = {};
+    attached_ = false;
+    read_position_ = 0;
+}
+
+void DataStream::attach(ByteView data) noexcept {
+    buffer_.clear();
+    external_data_ = data;
+    attached_ = true;
     read_position_ = 0;
 }
 
+void DataStream::detach() {
+    if (not attached_) return;
+    buffer_.assign(external_data_.begin(), external_data_.end());
+    external_data_ = {};
+    attached_ = false;
+}
+
+ByteView DataStream::contents() const noexcept {
+    if (attached_) return external_data_;
+    return {buffer_.data(), buffer_.size()};
+}
+
 outcome::result<void> DataStream::get_clear(DataStream& dst) {
-    if (const auto write_result{dst.write({&buffer_[read_position_], avail()})}; not write_result) {
+    if (const auto write_result{dst.write(contents().substr(read_position_))}; not write_result) {
         return write_result.error();
     }
     clear();
@@ -18,6 +18,7 @@
 
 #pragma once
 #include <array>
+#include <cstring>
 #include <functional>
 #include <optional>
 #include <span>
@@ -26,7 +27,7 @@
 
 #include <core/common/base.hpp>
 #include <core/common/cast.hpp>
-#include <core/common/secure_bytes.hpp>
+#include <core/common/pooled_bytes.hpp>
 #include <core/serialization/base.hpp>
 #include <core/serialization/errors.hpp>
 #include <core/serialization/serialize.hpp>
@@ -37,11 +38,11 @@ class Serializable;
 
 class DataStream {
   public:
-    using size_type = typename SecureBytes::size_type;
-    using difference_type = typename SecureBytes::difference_type;
-    using reference = typename SecureBytes::reference;
-    using value_type = typename SecureBytes::value_type;
-    using iterator = typename SecureBytes::iterator;
+    using size_type = typename PooledBytes::size_type;
+    using difference_type = typename PooledBytes::difference_type;
+    using reference = typename PooledBytes::reference;
+    using value_type = typename PooledBytes::value_type;
+    using iterator = typename PooledBytes::iterator;
 
     explicit DataStream() = default;
     explicit DataStream(ByteView data);
@@ -102,7 +103,10 @@ class DataStream {
     [[nodiscard]] bool eof() const noexcept;
 
     //! \brief Accesses one element of the buffer
-    constexpr reference operator[](size_type pos) { return buffer_[pos]; }
+    reference operator[](size_type pos) {
+        detach();
+        return buffer_[pos];
+    }
 
     //! \brief Returns the size of the contained data
     [[nodiscard]] size_type size() const noexcept;
@@ -136,9 +140,27 @@ class DataStream {
     //! \brief Returns the hexed representation of the data buffer
     [[nodiscard]] std::string to_string() const;
 
+    //! \brief Binds the stream to externally owned data without copying it
+    //! \details Any previous content is discarded and the read position is moved at the beginning.
+    //! Read operations work directly on the provided data while any operation altering the data
+    //! transparently copies it into the internal buffer first (see detach)
+    //! \attention Provided data MUST outlive the binding (i.e. until the stream is cleared or detached)
+    void attach(ByteView data) noexcept;
+
+    //! \brief Copies externally bound data (if any) into the internal buffer and releases the binding
+    void detach();
+
+    //! \brief Whether the stream is bound to externally owned data
+    [[nodiscard]] bool attached() const noexcept { return attached_; }
+
+    //! \brief Returns a view over the whole data (either owned or attached) regardless the read position
+    [[nodiscard]] ByteView contents() const noexcept;
+
   private:
-    SecureBytes buffer_{};        // Data buffer
+    PooledBytes buffer_{};        // Data buffer
     size_type read_position_{0};  // Current read position;
+    ByteView external_data_{};    // Externally owned data (when attached)
+    bool attached_{false};        // Whether data is read from external_data_ rather than buffer_
 };
 
 //! \brief Stream for serialization / deserialization of Bitcoin objects
@@ -157,6 +179,10 @@ class SDataStream : public DataStream {
     //! \remarks Only when this stream is used as a calculator
     [[nodiscard]] size_type computed_size() const noexcept;
 
+    //! \brief Adds the provided amount of bytes to the computed size
+    //! \remarks Only when this stream is used as a calculator
+    void add_computed_size(size_type count) noexcept { computed_size_ += count; }
+
     //! \brief Clears data and moves the read position to the beginning
     //! \remarks After this operation eof() == true
     void clear() noexcept override;
@@ -188,9 +214,14 @@ class SDataStream : public DataStream {
             case kComputeSize:
                 computed_size_ += bytes.size();
                 break;
-            case kSerialize:
-                boost::multiprecision::export_bits(object, bytes.begin(), CHAR_BIT);
+            case kSerialize: {
+                // Only significant bytes are exported (most significant first) : right align them
+                std::array<uint8_t, ssizeof<T>> significant_bytes{0x0};
+                const auto end{boost::multiprecision::export_bits(object, significant_bytes.begin(), CHAR_BIT)};
+                const auto count{static_cast<size_t>(std::distance(significant_bytes.begin(), end))};
+                std::memcpy(&bytes[bytes.size() - count], significant_bytes.data(), count);
                 return write(bytes);
+            }
             case kDeserialize:
                 if (const auto read_result{bind(bytes, action)}; read_result.has_error()) [[unlikely]] {
                     return read_result.error();
@@ -18,6 +18,8 @@
 
 #include "block.hpp"
 
+#include <core/crypto/hash256.hpp>
+
 namespace znode {
 
 void BlockHeader::reset() {
@@ -32,6 +34,49 @@ void BlockHeader::reset() {
 }
 
 outcome::result<void> BlockHeader::serialization(ser::SDataStream& stream, ser::Action action) {
+    auto result{fixed_part_serialization(stream, action)};
+    if (not result.has_error()) result = stream.bind(solution, action);
+    return result;
+}
+
+outcome::result<void> BlockHeader::network_serialization(ser::SDataStream& stream, ser::Action action) {
+    if (auto result{fixed_part_serialization(stream, action)}; result.has_error()) return result.error();
+    switch (action) {
+        using enum ser::Action;
+        case kComputeSize:
+            stream.add_computed_size(ser::ser_compact_sizeof(solution.size()) + solution.size());
+            break;
+        case kSerialize:
+            if (auto result{ser::write_compact(stream, solution.size())}; result.has_error()) return result.error();
+            return stream.write(solution);
+        case kDeserialize: {
+            const auto solution_size{ser::read_compact(stream)};
+            if (solution_size.has_error()) return solution_size.error();
+            const auto data{stream.read(solution_size.value())};
+            if (data.has_error()) return data.error();
+            solution.assign(data.value());
+        } break;
+    }
+    return outcome::success();
+}
+
+outcome::result<void> BlockHeader::serialize_pow_input(ser::SDataStream& stream) const {
+    // Serialization does not alter the object
+    return const_cast<BlockHeader&>(*this).fixed_part_serialization(stream, ser::Action::kSerialize);
+}
+
+h256 BlockHeader::hash() const {
+    ser::SDataStream stream(ser::Scope::kHash, 0);
+    // Serialization does not alter the object
+    if (const auto result{const_cast<BlockHeader&>(*this).network_serialization(stream, ser::Action::kSerialize)};
+        result.has_error()) [[unlikely]] {
+        return {};
+    }
+    crypto::Hash256 hasher(stream.contents());
+    return hasher.finalize_h256();
+}
+
+outcome::result<void> BlockHeader::fixed_part_serialization(ser::SDataStream& stream, ser::Action action) {
     auto result{stream.bind(version, action)};
     if (not result.has_error()) stream.set_version(version);
     if (not result.has_error()) result = stream.bind(parent_hash, action);
@@ -40,7 +85,6 @@ outcome::result<void> BlockHeader::serialization(ser::SDataStream& stream, ser::
     if (not result.has_error()) result = stream.bind(time, action);
     if (not result.has_error()) result = stream.bind(bits, action);
     if (not result.has_error()) result = stream.bind(nonce, action);
-    if (not result.has_error()) result = stream.bind(solution, action);
     return result;
 }
 
@@ -41,6 +41,17 @@ class BlockHeader : public ser::Serializable {
     //! \brief Reset the object to its default state
     void reset();
 
+    //! \brief (De)Serializes the header in its network format
+    //! \details Unlike the storage format (see serialize/deserialize) the Equihash solution is prefixed by its
+    //! compact size. This is the format headers travel on the wire with and the one the hash is computed upon
+    [[nodiscard]] outcome::result<void> network_serialization(ser::SDataStream& stream, ser::Action action);
+
+    //! \brief Serializes the fixed size members only (i.e. the input the Equihash solution is computed upon)
+    [[nodiscard]] outcome::result<void> serialize_pow_input(ser::SDataStream& stream) const;
+
+    //! \brief Returns the hash of this header (i.e. double Sha256 of its network format)
+    [[nodiscard]] h256 hash() const;
+
     //! \brief Need an explicit declaration of the spaceship operator as
     //! the compiler cannot generate it for us due to the presence of
     //! of boost::multiprecision::uint256_t which does not have a spaceship
@@ -49,5 +60,8 @@ class BlockHeader : public ser::Serializable {
   private:
     friend class ser::SDataStream;
     outcome::result<void> serialization(ser::SDataStream& stream, ser::Action action) override;
+
+    //! \brief (De)Serializes the fixed size members (i.e. all but the Equihash solution)
+    outcome::result<void> fixed_part_serialization(ser::SDataStream& stream, ser::Action action);
 };
 }  // namespace znode
@@ -34,4 +34,38 @@ TEST_CASE("Block Serialization", "[serialization]") {
     CHECK(header == header2);
     CHECK(stream.eof());
 }
+
+TEST_CASE("Block Header network serialization", "[serialization]") {
+    BlockHeader header;
+    header.version = 4;
+    header.parent_hash = h256(10);
+    header.time = 1'500'000'000;
+    header.nonce = 42;  // Leading zeroes must be preserved
+    header.solution = Bytes(1344, 0xab);
+
+    ser::SDataStream stream(ser::Scope::kNetwork, 0);
+    REQUIRE_FALSE(header.network_serialization(stream, ser::Action::kComputeSize).has_error());
+    const auto expected_size{kBlockHeaderSerializedSize + ser::ser_compact_sizeof(1344) + 1344};
+    CHECK(stream.computed_size() == expected_size);
+    REQUIRE_FALSE(header.network_serialization(stream, ser::Action::kSerialize).has_error());
+    CHECK(stream.size() == expected_size);
+
+    // Same fixed part as storage format
+    ser::SDataStream storage_stream(ser::Scope::kStorage, 0);
+    REQUIRE_FALSE(header.serialize(storage_stream).has_error());
+    CHECK(storage_stream.contents().substr(0, kBlockHeaderSerializedSize) ==
+          stream.contents().substr(0, kBlockHeaderSerializedSize));
+
+    BlockHeader header2;
+    REQUIRE_FALSE(header2.network_serialization(stream, ser::Action::kDeserialize).has_error());
+    CHECK(stream.eof());
+    CHECK(header2.nonce == header.nonce);
+    CHECK(header2.time == header.time);
+    CHECK(header2.solution == header.solution);
+    CHECK(header2.hash() == header.hash());
+
+    // The hash covers the solution too
+    header2.solution.back() ^= 0xff;
+    CHECK(header2.hash() != header.hash());
+}
 }  // namespace znode
@@ -17,10 +17,37 @@
 
 #include "access_layer.hpp"
 
+#include <algorithm>
+
 #include <core/common/assert.hpp>
 
 namespace znode::db {
 
+namespace {
+
+    //! \brief Serializes and upserts a header into Headers and HeaderNumbers tables by means of provided cursors
+    //! \returns The hash of the header and the amount of bytes written
+    std::pair<h256, size_t> put_header(Cursor& headers, Cursor& header_numbers, ser::SDataStream& data_stream,
+                                       BlockNum block_num, BlockHeader& header) {
+        data_stream.clear();
+        if (const auto result{header.serialize(data_stream)}; result.has_error()) {
+            throw Exception("Unable to serialize header " + std::to_string(block_num) + " " +
+                            result.error().message());
+        }
+        const ByteView value{data_stream.contents()};
+        ASSERT_POST(value.size() >= kBlockHeaderSerializedSize);
+        const auto header_hash{header.hash()};
+
+        std::array<uint8_t, sizeof(BlockNum)> key{};
+        endian::store_big_u32(key.data(), block_num);
+        const ByteView key_view{key.data(), key.size()};
+        headers.upsert(to_slice(key_view), to_slice(value));
+        header_numbers.upsert(to_slice(ByteView{header_hash.data(), header_hash.size()}), to_slice(key_view));
+        return {header_hash, key.size() + value.size() + header_hash.size() + key.size()};
+    }
+
+}  // namespace
+
 void write_config_value(mdbx::txn& txn, std::string_view key, const ByteView& value) {
     if (txn.is_readonly()) return;
     Cursor config(txn, db::tables::kConfig);
@@ -80,4 +107,121 @@ void write_chain_config(mdbx::txn& txn, const ChainConfig& config) {
     const auto json_str{json.dump()};
     write_config_value(txn, tables::kConfigChainKey, string_view_to_byte_view(json_str));
 }
+
+h256 write_header(mdbx::txn& txn, BlockNum block_num, BlockHeader& header) {
+    Cursor headers(txn, tables::kHeaders);
+    Cursor header_numbers(txn, tables::kHeaderNumbers);
+    ser::SDataStream data_stream(ser::Scope::kStorage, 0);
+    return put_header(headers, header_numbers, data_stream, block_num, header).first;
+}
+
+std::optional<BlockHeader> read_header(mdbx::txn& txn, BlockNum block_num, bool with_solution) {
+    std::array<uint8_t, sizeof(BlockNum)> key{};
+    endian::store_big_u32(key.data(), block_num);
+    Cursor headers(txn, tables::kHeaders);
+    const auto data{headers.find(to_slice(ByteView{key.data(), key.size()}), /*throw_notfound=*/false)};
+    if (not data) return std::nullopt;
+
+    auto value{from_slice(data.value)};
+    if (value.size() < kBlockHeaderSerializedSize) [[unlikely]] {
+        throw Exception("Invalid stored header " + std::to_string(block_num));
+    }
+    if (not with_solution) value = value.substr(0, kBlockHeaderSerializedSize);
+
+    ser::SDataStream data_stream(ser::Scope::kStorage, 0);
+    data_stream.attach(value);  // No copy : data is owned by the transaction
+    BlockHeader header;
+    if (const auto result{header.deserialize(data_stream)}; result.has_error()) [[unlikely]] {
+        throw Exception("Unable to deserialize header " + std::to_string(block_num) + " " + result.error().message());
+    }
+    return header;
+}
+
+std::optional<BlockNum> read_header_number(mdbx::txn& txn, const h256& header_hash) {
+    Cursor header_numbers(txn, tables::kHeaderNumbers);
+    const auto data{
+        header_numbers.find(to_slice(ByteView{header_hash.data(), header_hash.size()}), /*throw_notfound=*/false)};
+    if (not data) return std::nullopt;
+    ASSERT_POST(data.value.length() == sizeof(BlockNum) and "Invalid stored header number");
+    return endian::load_big_u32(static_cast<const uint8_t*>(data.value.data()));
+}
+
+std::optional<BlockNum> read_max_header_number(mdbx::txn& txn) {
+    Cursor headers(txn, tables::kHeaders);
+    const auto data{headers.to_last(/*throw_notfound=*/false)};
+    if (not data) return std::nullopt;
+    ASSERT_POST(data.key.length() == sizeof(BlockNum) and "Invalid stored header key");
+    return endian::load_big_u32(static_cast<const uint8_t*>(data.key.data()));
+}
+
+size_t erase_headers(mdbx::txn& txn, BlockNum from_block_num) {
+    std::array<uint8_t, sizeof(BlockNum)> key{};
+    endian::store_big_u32(key.data(), from_block_num);
+    Cursor headers(txn, tables::kHeaders);
+    Cursor header_numbers(txn, tables::kHeaderNumbers);
+    ser::SDataStream data_stream(ser::Scope::kStorage, 0);
+
+    size_t ret{0};
+    auto data{headers.lower_bound(to_slice(ByteView{key.data(), key.size()}), /*throw_notfound=*/false)};
+    while (data) {
+        data_stream.attach(from_slice(data.value));
+        BlockHeader header;
+        if (const auto result{header.deserialize(data_stream)}; result.has_error()) [[unlikely]] {
+            const auto block_num{endian::load_big_u32(static_cast<const uint8_t*>(data.key.data()))};
+            throw Exception("Unable to deserialize header " + std::to_string(block_num) + " " +
+                            result.error().message());
+        }
+        const auto header_hash{header.hash()};
+        std::ignore = header_numbers.erase(to_slice(ByteView{header_hash.data(), header_hash.size()}));
+        ret += static_cast<size_t>(headers.erase());
+        data = headers.to_next(/*throw_notfound=*/false);
+    }
+    return ret;
+}
+
+HeadersWriter::HeadersWriter(RWTxn& txn, size_t batch_size, HeaderIndex* header_index)
+    : txn_{txn},
+      batch_size_{batch_size},
+      header_index_{header_index},
+      headers_{txn, tables::kHeaders},
+      header_numbers_{txn, tables::kHeaderNumbers} {}
+
+h256 HeadersWriter::write(BlockNum block_num, BlockHeader& header) {
+    const auto [header_hash, written_bytes]{put_header(headers_, header_numbers_, data_stream_, block_num, header)};
+    if (header_index_ not_eq nullptr) {
+        pending_records_.emplace_back(block_num, HeaderRecord::from_header(header_hash, header));
+    }
+    pending_bytes_ += written_bytes;
+    ++written_count_;
+    if (pending_bytes_ >= batch_size_) flush();
+    return header_hash;
+}
+
+size_t HeadersWriter::erase(BlockNum from_block_num) {
+    const auto ret{erase_headers(*txn_, from_block_num)};
+    std::erase_if(pending_records_, [from_block_num](const auto& item) { return item.first >= from_block_num; });
+    pending_truncation_ = std::min(pending_truncation_.value_or(from_block_num), from_block_num);
+    return ret;
+}
+
+void HeadersWriter::flush() {
+    if (pending_bytes_ == 0U and not pending_truncation_.has_value()) return;
+    txn_.commit(/*renew=*/true);
+    // Cursors are bound to the committed transaction : rebind them to the renewed one
+    headers_.bind(txn_, tables::kHeaders);
+    header_numbers_.bind(txn_, tables::kHeaderNumbers);
+    pending_bytes_ = 0;
+    ++commits_count_;
+
+    if (header_index_ == nullptr) return;
+    if (pending_truncation_.has_value()) header_index_->truncate(*pending_truncation_);
+    pending_truncation_.reset();
+    for (const auto& [block_num, record] : pending_records_) {
+        if (not header_index_->put(block_num, record)) {
+            pending_records_.clear();
+            throw Exception("Header index out of sync at block " + std::to_string(block_num));
+        }
+    }
+    pending_records_.clear();
+}
 }  // namespace znode::db
\ No newline at end of file
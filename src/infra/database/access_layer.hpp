@@ -19,11 +19,16 @@
 
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include <core/chain/config.hpp>
 #include <core/common/cast.hpp>
 #include <core/common/endian.hpp>
+#include <core/serialization/stream.hpp>
+#include <core/types/block.hpp>
+#include <core/types/hash.hpp>
 
+#include <infra/database/header_index.hpp>
 #include <infra/database/mdbx_tables.hpp>
 
 namespace znode::db {
@@ -57,4 +62,79 @@ std::optional<ChainConfig> read_chain_config(mdbx::txn& txn);
 //! \brief Upserts chain config into Config table
 void write_chain_config(mdbx::txn& txn, const ChainConfig& config);
 
+//! \brief Upserts a block header into Headers table and indexes its hash into HeaderNumbers table
+//! \returns The hash of the header
+//! \remarks Should the header not be serializable an exception is thrown
+h256 write_header(mdbx::txn& txn, BlockNum block_num, BlockHeader& header);
+
+//! \brief Pulls a block header from Headers table
+//! \param [in] with_solution : Whether also the Equihash solution has to be loaded. When false only the fixed size
+//! part of the stored value is parsed
+std::optional<BlockHeader> read_header(mdbx::txn& txn, BlockNum block_num, bool with_solution = true);
+
+//! \brief Pulls the block number of a header given its hash
+std::optional<BlockNum> read_header_number(mdbx::txn& txn, const h256& header_hash);
+
+//! \brief Returns the highest block number stored in Headers table (if any)
+std::optional<BlockNum> read_max_header_number(mdbx::txn& txn);
+
+//! \brief Erases all headers with block number greater or equal to the provided one (and their hashes from the index)
+//! \returns The number of erased headers
+//! \throws Exception when a stored header can't be deserialized
+size_t erase_headers(mdbx::txn& txn, BlockNum from_block_num);
+
+//! \brief Writes block headers in batches
+//! \details Data is written through the provided RW transaction which is committed (and renewed) every time the amount
+//! of pending written data exceeds the batch size (see AppSettings::batch_size). Cursors and the serialization buffer
+//! are reused across all writes
+//! \remarks Pending data is committed on flush(). Should the transaction be an external one commits are left to the
+//! owner of the transaction
+//! \attention Changes are applied to the in memory index only once committed (i.e. on flush() or when the batch size
+//! is exceeded) : uncommitted ones are discarded on destruction. Indexed changes made through an external transaction
+//! can't be rolled back hence the owner must commit it
+class HeadersWriter {
+  public:
+    //! \param header_index When provided it's kept in sync with written and erased headers
+    HeadersWriter(RWTxn& txn, size_t batch_size, HeaderIndex* header_index = nullptr);
+    ~HeadersWriter() = default;
+
+    // Not copyable nor movable
+    HeadersWriter(const HeadersWriter&) = delete;
+    HeadersWriter& operator=(const HeadersWriter&) = delete;
+
+    //! \brief Upserts a header at the provided height
+    //! \returns The hash of the header
+    h256 write(BlockNum block_num, BlockHeader& header);
+
+    //! \brief Erases all headers with block number greater or equal to the provided one (see erase_headers)
+    //! \returns The number of erased headers
+    size_t erase(BlockNum from_block_num);
+
+    //! \brief Commits any pending data then applies pending changes to the in memory index
+    //! \throws Exception when the index is not in sync with the written headers
+    void flush();
+
+    //! \brief Returns the amount of bytes written since last commit
+    [[nodiscard]] size_t pending_bytes() const noexcept { return pending_bytes_; }
+
+    //! \brief Returns the number of headers written by this instance
+    [[nodiscard]] size_t written_count() const noexcept { return written_count_; }
+
+    //! \brief Returns the number of commits issued by this instance
+    [[nodiscard]] size_t commits_count() const noexcept { return commits_count_; }
+
+  private:
+    RWTxn& txn_;
+    const size_t batch_size_;
+    HeaderIndex* header_index_;                             // In memory index kept in sync with writes (if any)
+    Cursor headers_;                                        // Cursor on Headers table
+    Cursor header_numbers_;                                 // Cursor on HeaderNumbers table
+    ser::SDataStream data_stream_{ser::Scope::kStorage, 0};  // Reused serialization buffer
+    std::optional<BlockNum> pending_truncation_;            // Lowest erased block number since last commit (if any)
+    std::vector<std::pair<BlockNum, HeaderRecord>> pending_records_;  // Written since last commit (if indexed)
+    size_t pending_bytes_{0};
+    size_t written_count_{0};
+    size_t commits_count_{0};
+};
+
 }  // namespace znode::db
\ No newline at end of file
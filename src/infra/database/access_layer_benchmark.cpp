@@ -0,0 +1,76 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <chrono>
+
+#include <benchmark/benchmark.h>
+
+#include <infra/database/access_layer.hpp>
+#include <infra/filesystem/directories.hpp>
+
+namespace znode::db {
+
+static constexpr BlockNum kBenchHeadersCount{2'000'000};
+static constexpr size_t kBenchSolutionSize{1344};  // Equihash 200,9
+
+//! \brief Builds a chain of fake headers and stores them through HeadersWriter
+void bench_headers_write_read(benchmark::State& state) {
+    const bool with_solution{state.range(0) not_eq 0};
+    for ([[maybe_unused]] auto _ : state) {
+        const TempDirectory tmp_dir{};
+        EnvConfig db_config{tmp_dir.path().string(), /*create=*/true};
+        db_config.exclusive = true;
+        auto env{db::open_env(db_config)};
+        RWTxn txn(env);
+        tables::deploy_tables(*txn, tables::kChainDataTables);
+        txn.commit(/*renew=*/true);
+
+        BlockHeader header;
+        header.version = 4;
+        header.bits = 0x1f07ffff;
+        header.solution = Bytes(kBenchSolutionSize, 0x5a);
+
+        // Write
+        auto start{std::chrono::steady_clock::now()};
+        HeadersWriter writer(txn, /*batch_size=*/512_MiB);
+        for (BlockNum block_num{0}; block_num < kBenchHeadersCount; ++block_num) {
+            header.time = block_num;
+            header.parent_hash = writer.write(block_num, header);
+        }
+        writer.flush();
+        const std::chrono::duration<double> write_elapsed{std::chrono::steady_clock::now() - start};
+
+        // Read back
+        start = std::chrono::steady_clock::now();
+        size_t read_count{0};
+        for (BlockNum block_num{0}; block_num < kBenchHeadersCount; ++block_num) {
+            const auto read_header_data{read_header(*txn, block_num, with_solution)};
+            read_count += read_header_data.has_value() ? 1U : 0U;
+        }
+        const std::chrono::duration<double> read_elapsed{std::chrono::steady_clock::now() - start};
+        if (read_count not_eq kBenchHeadersCount) state.SkipWithError("Missing headers");
+
+        state.counters["write_headers_per_sec"] = static_cast<double>(kBenchHeadersCount) / write_elapsed.count();
+        state.counters["read_headers_per_sec"] = static_cast<double>(kBenchHeadersCount) / read_elapsed.count();
+        state.counters["commits"] = static_cast<double>(writer.commits_count());
+        txn.commit(/*renew=*/false);
+    }
+}
+
+// Arg is whether the Equihash solution is read back too
+BENCHMARK(bench_headers_write_read)->Arg(0)->Arg(1)->Iterations(1)->Unit(benchmark::kSecond);
+
+}  // namespace znode::db
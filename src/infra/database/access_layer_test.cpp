@@ -58,4 +58,110 @@ TEST_CASE("Deploy Tables", "[database]") {
         CHECK(has_map(*txn, table.name));
     }
 }
+
+TEST_CASE("Block headers", "[database]") {
+    const TempDirectory tmp_dir{};
+    EnvConfig db_config{tmp_dir.path().string(), /*create=*/true};
+    db_config.inmemory = true;
+    auto env{db::open_env(db_config)};
+    RWTxn txn(env);
+    tables::deploy_tables(*txn, tables::kChainDataTables);
+
+    CHECK_FALSE(read_header(*txn, 0).has_value());
+    CHECK_FALSE(read_max_header_number(*txn).has_value());
+
+    BlockHeader header;
+    header.version = 4;
+    header.parent_hash = h256(1);
+    header.merkle_root = h256(2);
+    header.time = 1'500'000'000;
+    header.bits = 0x1d00ffff;
+    header.solution = Bytes(1344, 0xab);
+    const auto header_hash{write_header(*txn, 10, header)};
+    CHECK(header_hash);
+
+    SECTION("Read back") {
+        const auto full_header{read_header(*txn, 10)};
+        REQUIRE(full_header.has_value());
+        CHECK(full_header->version == header.version);
+        CHECK(full_header->parent_hash == header.parent_hash);
+        CHECK(full_header->merkle_root == header.merkle_root);
+        CHECK(full_header->scct_root == header.scct_root);
+        CHECK(full_header->time == header.time);
+        CHECK(full_header->bits == header.bits);
+        CHECK(full_header->solution == header.solution);
+
+        // Only the fixed size part
+        const auto fixed_header{read_header(*txn, 10, /*with_solution=*/false)};
+        REQUIRE(fixed_header.has_value());
+        CHECK(fixed_header->parent_hash == header.parent_hash);
+        CHECK(fixed_header->bits == header.bits);
+        CHECK(fixed_header->solution.empty());
+
+        CHECK(read_header_number(*txn, header_hash) == 10U);
+        CHECK_FALSE(read_header_number(*txn, h256(3)).has_value());
+        CHECK(read_max_header_number(*txn) == 10U);
+    }
+
+    SECTION("Batched writes") {
+        const size_t batch_size{4_KiB};
+        HeadersWriter writer(txn, batch_size);
+        for (BlockNum block_num{11}; block_num < 111; ++block_num) {
+            header.parent_hash = h256(block_num);
+            std::ignore = writer.write(block_num, header);
+            CHECK(writer.pending_bytes() < batch_size);
+        }
+        writer.flush();
+        CHECK(writer.written_count() == 100U);
+        CHECK(writer.commits_count() > 1U);
+        CHECK(writer.pending_bytes() == 0U);
+
+        CHECK(read_max_header_number(*txn) == 110U);
+        const auto read_back{read_header(*txn, 50, /*with_solution=*/false)};
+        REQUIRE(read_back.has_value());
+        CHECK(read_back->parent_hash == h256(50));
+    }
+
+    SECTION("Erase") {
+        header.parent_hash = h256(2);
+        const auto next_header_hash{write_header(*txn, 11, header)};
+        CHECK(erase_headers(*txn, 11) == 1U);
+        CHECK_FALSE(read_header(*txn, 11).has_value());
+        CHECK_FALSE(read_header_number(*txn, next_header_hash).has_value());
+        CHECK(read_header_number(*txn, header_hash) == 10U);
+        CHECK(read_max_header_number(*txn) == 10U);
+    }
+
+    SECTION("Erase corrupted") {
+        const std::array<uint8_t, sizeof(BlockNum)> key{0, 0, 0, 11};
+        const Bytes value(kBlockHeaderSerializedSize - 1U, 0);
+        Cursor headers(*txn, tables::kHeaders);
+        headers.upsert(to_slice(ByteView{key.data(), key.size()}), to_slice(value));
+        CHECK_THROWS_AS(erase_headers(*txn, 10), Exception);
+    }
+}
+
+TEST_CASE("Block header hash index", "[database]") {
+    const TempDirectory tmp_dir{};
+    EnvConfig db_config{tmp_dir.path().string(), /*create=*/true};
+    db_config.inmemory = true;
+    auto env{db::open_env(db_config)};
+    RWTxn txn(env);
+    tables::deploy_tables(*txn, tables::kChainDataTables);
+
+    BlockHeader header;
+    header.version = 4;
+    header.parent_hash = h256(Bytes(h256::size(), 0x11));
+    header.merkle_root = h256(Bytes(h256::size(), 0x22));
+    header.scct_root = h256(Bytes(h256::size(), 0x33));
+    header.time = 1'500'000'000;
+    header.bits = 0x1d00ffff;
+    header.solution = Bytes(1344, 0xab);
+
+    // Double sha256 of the network serialization (compact size prefixed solution)
+    const auto known_hash{h256::from_hex("f045204904a3f113acd0481b879fc0fb752dcd927a0cef4de4ba527d98cd7e64")};
+    REQUIRE(known_hash);
+    CHECK(write_header(*txn, 10, header) == known_hash.value());
+    CHECK(read_header_number(*txn, known_hash.value()) == 10U);
+}
 }  // namespace znode::db
@@ -0,0 +1,271 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "header_index.hpp"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+#include <core/common/endian.hpp>
+
+#include <infra/database/access_layer.hpp>
+
+namespace znode::db {
+
+namespace bip = boost::interprocess;
+
+HeaderIndex::HeaderIndex(std::filesystem::path file_path) : file_path_{std::move(file_path)} { rebuild_slots(); }
+
+void HeaderIndex::load(mdbx::txn& txn, const h256& genesis_hash) {
+    std::unique_lock lock(mutex_);
+    if (not loaded_) {
+        loaded_ = true;
+        if (map_file()) rebuild_slots();
+    }
+
+    const auto max_header_number{read_max_header_number(txn)};
+    const size_t table_count{static_cast<size_t>(max_header_number.value_or(0U)) + 1U};  // Genesis is implied
+
+    // Returns the hash of the header at the provided height according to the table
+    const auto table_hash{[&txn, &genesis_hash](BlockNum block_num) -> h256 {
+        const auto header{read_header(txn, block_num)};
+        if (header.has_value()) return header->hash();
+        if (block_num == 0U) return genesis_hash;
+        throw Exception("Missing header " + std::to_string(block_num));
+    }};
+
+    // Drop what has been unwound or does not match anymore
+    if (records_count() > table_count) truncate_unlocked(table_count);
+    if (records_count() not_eq 0U) {
+        const auto last_block_num{static_cast<BlockNum>(records_count() - 1U)};
+        if (record(last_block_num).header_hash() not_eq table_hash(last_block_num)) clear_unlocked();
+    }
+
+    if (records_count() == 0U) {
+        const auto genesis_header{read_header(txn, 0U)};
+        push_back_unlocked(HeaderRecord::from_header(genesis_hash, genesis_header.value_or(BlockHeader{})));
+    }
+    if (records_count() == table_count) return;
+
+    // Load the missing headers
+    std::array<uint8_t, sizeof(BlockNum)> key{};
+    endian::store_big_u32(key.data(), static_cast<BlockNum>(records_count()));
+    Cursor headers(txn, tables::kHeaders);
+    ser::SDataStream data_stream(ser::Scope::kStorage, 0);
+    auto data{headers.lower_bound(to_slice(ByteView{key.data(), key.size()}), /*throw_notfound=*/false)};
+    while (data) {
+        const auto block_num{endian::load_big_u32(static_cast<const uint8_t*>(data.key.data()))};
+        if (block_num not_eq records_count()) throw Exception("Missing header " + std::to_string(records_count()));
+        data_stream.attach(from_slice(data.value));
+        BlockHeader header;
+        if (const auto result{header.deserialize(data_stream)}; result.has_error()) {
+            throw Exception("Unable to deserialize header " + std::to_string(block_num) + " " +
+                            result.error().message());
+        }
+        if (header.parent_hash not_eq record(block_num - 1U).header_hash()) {
+            throw Exception("Unlinked header " + std::to_string(block_num));
+        }
+        push_back_unlocked(HeaderRecord::from_header(header.hash(), header));
+        data = headers.to_next(/*throw_notfound=*/false);
+    }
+}
+
+void HeaderIndex::save() {
+    std::unique_lock lock(mutex_);
+    const auto tmp_path{std::filesystem::path(file_path_.string() + ".tmp")};
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        FileHeader file_header;
+        file_header.records_count = records_count();
+        file.write(reinterpret_cast<const char*>(&file_header), sizeof(FileHeader));
+        if (mapped_count_ not_eq 0U) {
+            file.write(reinterpret_cast<const char*>(mapped_records_),
+                       static_cast<std::streamsize>(mapped_count_ * sizeof(HeaderRecord)));
+        }
+        if (not records_.empty()) {
+            file.write(reinterpret_cast<const char*>(records_.data()),
+                       static_cast<std::streamsize>(records_.size() * sizeof(HeaderRecord)));
+        }
+        file.close();
+        if (not file) throw Exception("Unable to write " + tmp_path.string());
+    }
+
+    // Release the current mapping before replacing the file
+    mapped_region_ = bip::mapped_region();
+    file_mapping_ = bip::file_mapping();
+    mapped_records_ = nullptr;
+    std::filesystem::rename(tmp_path, file_path_);
+    const auto count{records_count()};
+    mapped_count_ = 0;
+    records_.clear();
+    if (not map_file() or mapped_count_ not_eq count) {
+        clear_unlocked();
+        throw Exception("Unable to map " + file_path_.string());
+    }
+    // Slots are still valid : block numbers haven't changed
+}
+
+void HeaderIndex::push_back(const h256& header_hash, const BlockHeader& header) {
+    std::unique_lock lock(mutex_);
+    push_back_unlocked(HeaderRecord::from_header(header_hash, header));
+}
+
+void HeaderIndex::truncate(BlockNum block_num) {
+    std::unique_lock lock(mutex_);
+    truncate_unlocked(block_num);
+}
+
+bool HeaderIndex::put(BlockNum block_num, const HeaderRecord& new_record) {
+    std::unique_lock lock(mutex_);
+    if (block_num > records_count()) return false;  // Would leave a gap
+    truncate_unlocked(block_num);
+    push_back_unlocked(new_record);
+    return true;
+}
+
+size_t HeaderIndex::size() const {
+    std::shared_lock lock(mutex_);
+    return records_count();
+}
+
+size_t HeaderIndex::mapped_size() const {
+    std::shared_lock lock(mutex_);
+    return mapped_count_;
+}
+
+std::optional<HeaderRecord> HeaderIndex::at(BlockNum block_num) const {
+    std::shared_lock lock(mutex_);
+    if (block_num >= records_count()) return std::nullopt;
+    return record(block_num);
+}
+
+std::optional<BlockNum> HeaderIndex::find(const h256& header_hash) const {
+    std::shared_lock lock(mutex_);
+    return find_unlocked(header_hash.data());
+}
+
+std::optional<BlockNum> HeaderIndex::find_fork_point(std::span<const h256> locator_hashes) const {
+    std::shared_lock lock(mutex_);
+    for (const auto& locator_hash : locator_hashes) {
+        if (const auto block_num{find_unlocked(locator_hash.data())}; block_num.has_value()) return block_num;
+    }
+    return std::nullopt;
+}
+
+std::vector<h256> HeaderIndex::get_locator() const {
+    std::shared_lock lock(mutex_);
+    std::vector<h256> ret;
+    if (records_count() == 0U) return ret;
+    size_t step{1};
+    for (size_t block_num{records_count() - 1U}; block_num > 0U; block_num -= std::min(step, block_num)) {
+        ret.push_back(record(block_num).header_hash());
+        if (ret.size() >= 10U) step *= 2U;
+    }
+    ret.push_back(record(0U).header_hash());
+    return ret;
+}
+
+const HeaderRecord& HeaderIndex::record(size_t block_num) const noexcept {
+    return block_num < mapped_count_ ? mapped_records_[block_num] : records_[block_num - mapped_count_];
+}
+
+std::optional<BlockNum> HeaderIndex::find_unlocked(const uint8_t* hash) const noexcept {
+    const auto fingerprint{endian::load_little_u32(&hash[8])};
+    for (size_t position{endian::load_little_u64(hash) & slots_mask_}; slots_[position].value not_eq 0U;
+         position = (position + 1U) & slots_mask_) {
+        const auto& slot{slots_[position]};
+        if (slot.fingerprint not_eq fingerprint) continue;
+        const BlockNum block_num{slot.value - 1U};
+        if (std::memcmp(record(block_num).hash.data(), hash, h256::size()) == 0) return block_num;
+    }
+    return std::nullopt;
+}
+
+void HeaderIndex::insert_slot(const uint8_t* hash, BlockNum block_num) noexcept {
+    size_t position{endian::load_little_u64(hash) & slots_mask_};
+    while (slots_[position].value not_eq 0U) position = (position + 1U) & slots_mask_;
+    slots_[position] = {endian::load_little_u32(&hash[8]), block_num + 1U};
+    ++slots_used_;
+}
+
+void HeaderIndex::rebuild_slots() {
+    // Keep load factor below 50% so that probe sequences stay short
+    const size_t capacity{std::max(kMinSlots, std::bit_ceil((records_count() + 1U) * 2U))};
+    slots_.assign(capacity, Slot{});
+    slots_mask_ = capacity - 1U;
+    slots_used_ = 0;
+    for (size_t i{0}; i < records_count(); ++i) {
+        insert_slot(record(i).hash.data(), static_cast<BlockNum>(i));
+    }
+}
+
+void HeaderIndex::push_back_unlocked(const HeaderRecord& new_record) {
+    records_.push_back(new_record);
+    if ((slots_used_ + 1U) * 2U > slots_.size()) {
+        rebuild_slots();  // Also inserts the new record
+    } else {
+        insert_slot(new_record.hash.data(), static_cast<BlockNum>(records_count() - 1U));
+    }
+}
+
+void HeaderIndex::truncate_unlocked(size_t count) {
+    if (count >= records_count()) return;
+    if (count <= mapped_count_) {
+        mapped_count_ = count;
+        records_.clear();
+    } else {
+        records_.resize(count - mapped_count_);
+    }
+    rebuild_slots();
+}
+
+void HeaderIndex::clear_unlocked() {
+    mapped_region_ = bip::mapped_region();
+    file_mapping_ = bip::file_mapping();
+    mapped_records_ = nullptr;
+    mapped_count_ = 0;
+    records_.clear();
+    rebuild_slots();
+}
+
+bool HeaderIndex::map_file() {
+    std::error_code error_code;
+    const auto file_size{std::filesystem::file_size(file_path_, error_code)};
+    if (error_code or file_size < sizeof(FileHeader)) return false;
+
+    try {
+        bip::file_mapping file_mapping(file_path_.string().c_str(), bip::read_only);
+        bip::mapped_region mapped_region(file_mapping, bip::read_only);
+        FileHeader file_header;
+        std::memcpy(&file_header, mapped_region.get_address(), sizeof(FileHeader));
+        if (file_header.magic not_eq kFileMagic or file_header.version not_eq kFileVersion or
+            file_header.record_size not_eq sizeof(HeaderRecord) or
+            file_size not_eq sizeof(FileHeader) + file_header.records_count * sizeof(HeaderRecord)) {
+            return false;
+        }
+        file_mapping_ = std::move(file_mapping);
+        mapped_region_ = std::move(mapped_region);
+        const auto* records_address{static_cast<const uint8_t*>(mapped_region_.get_address()) + sizeof(FileHeader)};
+        mapped_records_ = reinterpret_cast<const HeaderRecord*>(records_address);
+        mapped_count_ = static_cast<size_t>(file_header.records_count);
+        return true;
+    } catch (const bip::interprocess_exception&) {
+        return false;
+    }
+}
+
+}  // namespace znode::db
@@ -0,0 +1,156 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <core/types/block.hpp>
+#include <core/types/hash.hpp>
+
+#include <infra/database/mdbx.hpp>
+
+namespace znode::db {
+
+//! \brief Compact record of a block header as held by HeaderIndex
+struct HeaderRecord {
+    std::array<uint8_t, h256::size()> hash{};  // Hash of the header
+    uint32_t time{0};                          // Header's timestamp
+    uint32_t bits{0};                          // Header's target difficulty
+
+    [[nodiscard]] h256 header_hash() const noexcept { return h256{ByteView{hash.data(), hash.size()}}; }
+
+    //! \brief Builds the record of the provided header
+    [[nodiscard]] static HeaderRecord from_header(const h256& header_hash, const BlockHeader& header) noexcept {
+        HeaderRecord ret;
+        std::memcpy(ret.hash.data(), header_hash.data(), h256::size());
+        ret.time = header.time;
+        ret.bits = header.bits;
+        return ret;
+    }
+};
+static_assert(sizeof(HeaderRecord) == 40 and std::is_trivially_copyable_v<HeaderRecord>);
+
+//! \brief In memory index of the headers chain
+//! \details Made of a height indexed array of compact header records and an open addressing (linear probing) hash map
+//! from header hash to block number. Map slots only hold a fingerprint of the hash and the block number (8 bytes) so
+//! probing stays within one or two cache lines: candidate matches are confirmed against the records array.
+//! The records array is persisted into a file which, on next start, is memory mapped so that only the headers past
+//! the persisted ones need to be read (and hashed) from Headers table
+//! \remarks Is thread safe : lookups can be concurrent but are mutually exclusive with updates
+class HeaderIndex {
+  public:
+    //! \brief Creates an empty index whose records are persisted into the provided file
+    explicit HeaderIndex(std::filesystem::path file_path);
+    ~HeaderIndex() = default;
+
+    // Not copyable nor movable
+    HeaderIndex(const HeaderIndex& other) = delete;
+    HeaderIndex& operator=(const HeaderIndex& other) = delete;
+
+    //! \brief Brings the index in sync with Headers table
+    //! \details On first invocation the records persisted in the file (if any and consistent with the table) are
+    //! memory mapped. Records no longer in the table (i.e. unwound) are dropped and records past the ones already
+    //! indexed are loaded from the table
+    //! \param genesis_hash The hash of block 0 (which is not necessarily stored in Headers table)
+    //! \remarks Should Headers table not be linked an exception is thrown
+    void load(mdbx::txn& txn, const h256& genesis_hash);
+
+    //! \brief Persists the records into the file
+    //! \details The file is rewritten and mapped anew : pending records are released from memory
+    void save();
+
+    //! \brief Appends a header at the height following the last indexed one
+    void push_back(const h256& header_hash, const BlockHeader& header);
+
+    //! \brief Drops all records at or above the provided block number
+    void truncate(BlockNum block_num);
+
+    //! \brief Indexes a record at the provided block number replacing the record there and all the following ones
+    //! \returns Whether the record has been indexed (not the case when it doesn't follow the last indexed one)
+    [[nodiscard]] bool put(BlockNum block_num, const HeaderRecord& new_record);
+
+    //! \brief Returns the number of records in the index
+    [[nodiscard]] size_t size() const;
+
+    //! \brief Returns the number of records currently served from the mapped file
+    [[nodiscard]] size_t mapped_size() const;
+
+    //! \brief Returns the record at the provided block number (if any)
+    [[nodiscard]] std::optional<HeaderRecord> at(BlockNum block_num) const;
+
+    //! \brief Returns the block number of the provided header hash (if indexed)
+    [[nodiscard]] std::optional<BlockNum> find(const h256& header_hash) const;
+
+    //! \brief Returns the block number of the first hash of the locator which is indexed (if any)
+    //! \details Complexity is O(locator length)
+    [[nodiscard]] std::optional<BlockNum> find_fork_point(std::span<const h256> locator_hashes) const;
+
+    //! \brief Builds a block locator from the tip : the last 10 hashes then exponentially spaced ones back to genesis
+    [[nodiscard]] std::vector<h256> get_locator() const;
+
+  private:
+    struct Slot {
+        uint32_t fingerprint{0};  // 32 bits of the hash (other than the ones selecting the home slot)
+        uint32_t value{0};        // Block number + 1 (zero means empty slot)
+    };
+
+    struct FileHeader {
+        uint32_t magic{kFileMagic};
+        uint32_t version{kFileVersion};
+        uint32_t record_size{sizeof(HeaderRecord)};
+        uint32_t reserved{0};
+        uint64_t records_count{0};
+    };
+
+    static constexpr uint32_t kFileMagic{0x49484e5a};  // "ZNHI"
+    static constexpr uint32_t kFileVersion{1};
+    static constexpr size_t kMinSlots{1024};
+
+    [[nodiscard]] const HeaderRecord& record(size_t block_num) const noexcept;
+    [[nodiscard]] size_t records_count() const noexcept { return mapped_count_ + records_.size(); }
+    [[nodiscard]] std::optional<BlockNum> find_unlocked(const uint8_t* hash) const noexcept;
+    void insert_slot(const uint8_t* hash, BlockNum block_num) noexcept;
+    void rebuild_slots();
+    void push_back_unlocked(const HeaderRecord& new_record);
+    void truncate_unlocked(size_t count);
+    void clear_unlocked();
+    bool map_file();  // Returns whether the file has been successfully mapped
+
+    const std::filesystem::path file_path_;
+    mutable std::shared_mutex mutex_;
+
+    boost::interprocess::file_mapping file_mapping_{};
+    boost::interprocess::mapped_region mapped_region_{};
+    const HeaderRecord* mapped_records_{nullptr};  // Records served from the mapped file
+    size_t mapped_count_{0};                       // Number of mapped records in use
+    std::vector<HeaderRecord> records_;            // Records past the mapped ones
+
+    std::vector<Slot> slots_;  // Open addressing hash map (capacity is a power of 2)
+    size_t slots_mask_{0};
+    size_t slots_used_{0};
+    bool loaded_{false};  // Whether load() has been already invoked
+};
+
+}  // namespace znode::db
@@ -0,0 +1,209 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <infra/database/access_layer.hpp>
+#include <infra/database/header_index.hpp>
+#include <infra/filesystem/directories.hpp>
+
+namespace znode::db {
+
+namespace {
+    //! \brief Writes a chain of linked headers into Headers table
+    //! \returns The hash of the last written header
+    h256 write_headers_chain(mdbx::txn& txn, BlockNum from_block_num, BlockNum to_block_num, const h256& parent_hash,
+                             uint32_t salt = 0) {
+        h256 ret{parent_hash};
+        for (BlockNum block_num{from_block_num}; block_num <= to_block_num; ++block_num) {
+            BlockHeader header;
+            header.version = 4;
+            header.parent_hash = ret;
+            header.time = 1'500'000'000U + block_num + salt;
+            header.bits = 0x1d00ffff;
+            header.solution = Bytes(1344, static_cast<uint8_t>(block_num));
+            ret = write_header(txn, block_num, header);
+        }
+        return ret;
+    }
+}  // namespace
+
+TEST_CASE("Header index", "[database]") {
+    const TempDirectory tmp_dir{};
+    EnvConfig db_config{tmp_dir.path().string(), /*create=*/true};
+    db_config.inmemory = true;
+    auto env{db::open_env(db_config)};
+    RWTxn txn(env);
+    tables::deploy_tables(*txn, tables::kChainDataTables);
+
+    const auto index_path{tmp_dir.path() / "headers.idx"};
+    const h256 genesis_hash{0x1234};
+
+    HeaderIndex index(index_path);
+    index.load(*txn, genesis_hash);
+    CHECK(index.size() == 1);
+    CHECK(index.find(genesis_hash) == 0U);
+    CHECK(index.get_locator() == std::vector<h256>{genesis_hash});
+
+    const auto tip_hash{write_headers_chain(*txn, 1, 3'000, genesis_hash)};
+    index.load(*txn, genesis_hash);
+    REQUIRE(index.size() == 3'001);
+    CHECK(index.mapped_size() == 0);
+    CHECK(index.find(tip_hash) == 3'000U);
+    CHECK_FALSE(index.find(h256{0x5678}).has_value());
+
+    // Every header can be looked up by hash
+    for (BlockNum block_num{1}; block_num <= 3'000; ++block_num) {
+        const auto header{read_header(*txn, block_num)};
+        REQUIRE(header.has_value());
+        const auto record{index.at(block_num)};
+        REQUIRE(record.has_value());
+        CHECK(record->header_hash() == header->hash());
+        CHECK(record->time == header->time);
+        CHECK(record->bits == header->bits);
+        CHECK(index.find(header->hash()) == block_num);
+    }
+    CHECK_FALSE(index.at(3'001).has_value());
+
+    SECTION("Locator") {
+        const auto locator{index.get_locator()};
+        REQUIRE(locator.size() > 10);
+        CHECK(locator.size() < 25);
+        CHECK(locator.front() == tip_hash);
+        CHECK(locator.back() == genesis_hash);
+        CHECK(index.find(locator[9]) == 2'991U);
+        CHECK(index.find(locator[10]) == 2'989U);
+
+        CHECK(index.find_fork_point(locator) == 3'000U);
+        const std::vector<h256> unknown_first{h256{0x5678}, h256{0x9abc}, locator[5]};
+        CHECK(index.find_fork_point(unknown_first) == 2'995U);
+        const std::vector<h256> unknown_all{h256{0x5678}, h256{0x9abc}};
+        CHECK_FALSE(index.find_fork_point(unknown_all).has_value());
+    }
+
+    SECTION("Persisted and mapped") {
+        index.save();
+        CHECK(index.mapped_size() == 3'001);
+        CHECK(index.find(tip_hash) == 3'000U);
+
+        // New instance maps the records and only loads new ones from the table
+        const auto new_tip_hash{write_headers_chain(*txn, 3'001, 3'100, tip_hash)};
+        HeaderIndex reloaded_index(index_path);
+        reloaded_index.load(*txn, genesis_hash);
+        CHECK(reloaded_index.mapped_size() == 3'001);
+        CHECK(reloaded_index.size() == 3'101);
+        CHECK(reloaded_index.find(tip_hash) == 3'000U);
+        CHECK(reloaded_index.find(new_tip_hash) == 3'100U);
+        CHECK(reloaded_index.find(genesis_hash) == 0U);
+    }
+
+    SECTION("Unwind") {
+        index.save();
+        const auto unwind_hash{index.at(2'000)->header_hash()};
+        CHECK(erase_headers(*txn, 2'000) == 1'001);
+
+        HeaderIndex reloaded_index(index_path);
+        reloaded_index.load(*txn, genesis_hash);
+        CHECK(reloaded_index.size() == 2'000);
+        CHECK(reloaded_index.mapped_size() == 2'000);
+        CHECK_FALSE(reloaded_index.find(unwind_hash).has_value());
+        CHECK_FALSE(reloaded_index.find(tip_hash).has_value());
+
+        // A different fork replaces the unwound headers
+        const auto parent_hash{reloaded_index.at(1'999)->header_hash()};
+        const auto fork_tip_hash{write_headers_chain(*txn, 2'000, 2'500, parent_hash, /*salt=*/1)};
+        reloaded_index.load(*txn, genesis_hash);
+        CHECK(reloaded_index.size() == 2'501);
+        CHECK(reloaded_index.find(fork_tip_hash) == 2'500U);
+    }
+
+    SECTION("Kept in sync by writes and unwinds") {
+        index.save();  // Half of the records mapped
+
+        // Unwind past the mapped records then write a fork
+        HeadersWriter writer(txn, 4_KiB, &index);
+        CHECK(writer.erase(2'000) == 1'001);
+        CHECK(index.size() == 3'001);  // Not committed yet
+        writer.flush();
+        CHECK(index.size() == 2'000);
+        CHECK_FALSE(index.find(tip_hash).has_value());
+
+        h256 fork_tip_hash{index.at(1'999)->header_hash()};
+        for (BlockNum block_num{2'000}; block_num <= 2'500; ++block_num) {
+            BlockHeader header;
+            header.version = 4;
+            header.parent_hash = fork_tip_hash;
+            header.time = 1'600'000'000U + block_num;
+            header.bits = 0x1d00ffff;
+            fork_tip_hash = writer.write(block_num, header);
+        }
+        writer.flush();
+        CHECK(index.size() == 2'501);
+        CHECK(index.find(fork_tip_hash) == 2'500U);
+        CHECK(index.get_locator().front() == fork_tip_hash);
+
+        // Overwriting a header drops the following ones
+        BlockHeader header;
+        header.parent_hash = index.at(2'099)->header_hash();
+        const auto new_tip_hash{writer.write(2'100, header)};
+        CHECK(index.find(fork_tip_hash) == 2'500U);  // Not committed yet
+        writer.flush();
+        CHECK(index.size() == 2'101);
+        CHECK(index.find(new_tip_hash) == 2'100U);
+        CHECK_FALSE(index.find(fork_tip_hash).has_value());
+
+        // Headers not following the indexed ones can't be indexed
+        CHECK_FALSE(index.put(2'200, HeaderRecord::from_header(new_tip_hash, header)));
+        std::ignore = writer.write(2'200, header);
+        CHECK_THROWS_AS(writer.flush(), Exception);
+        CHECK(index.size() == 2'101);
+    }
+
+    SECTION("Uncommitted changes are not indexed") {
+        {
+            HeadersWriter writer(txn, 512_MiB, &index);
+            CHECK(writer.erase(2'000) == 1'001);
+            BlockHeader header;
+            header.parent_hash = index.at(1'999)->header_hash();
+            std::ignore = writer.write(2'000, header);
+        }  // Never flushed (e.g. the transaction is about to be aborted)
+        CHECK(index.size() == 3'001);
+        CHECK(index.find(tip_hash) == 3'000U);
+    }
+
+    SECTION("Stale file") {
+        index.save();
+
+        // Replace the tip with a different header : the mapped records are discarded
+        const auto parent_hash{index.at(2'999)->header_hash()};
+        std::ignore = erase_headers(*txn, 3'000);
+        const auto fork_tip_hash{write_headers_chain(*txn, 3'000, 3'000, parent_hash, /*salt=*/1)};
+
+        HeaderIndex reloaded_index(index_path);
+        reloaded_index.load(*txn, genesis_hash);
+        CHECK(reloaded_index.mapped_size() == 0);
+        CHECK(reloaded_index.size() == 3'001);
+        CHECK(reloaded_index.find(fork_tip_hash) == 3'000U);
+        CHECK_FALSE(reloaded_index.find(tip_hash).has_value());
+    }
+
+    SECTION("Unlinked table") {
+        std::ignore = write_headers_chain(*txn, 3'001, 3'001, h256{0x5678});
+        CHECK_THROWS_AS(index.load(*txn, genesis_hash), Exception);
+    }
+}
+
+}  // namespace znode::db
@@ -42,11 +42,22 @@ inline constexpr std::string_view kConfigChainKey{"chain"};
 //! \details Stores Block headers information
 //! \struct
 //! \verbatim
-//!   key   : TODO
-//!   value : TODO
+//!   key   : block_num_u32 (BE)
+//!   value : serialized BlockHeader. First kBlockHeaderSerializedSize (140) bytes hold the fixed size members at fixed
+//!           offsets (version @0, parent_hash @4, merkle_root @36, scct_root @68, time @100, bits @104, nonce @108)
+//!           while the Equihash solution takes the remainder of the value
 //! \endverbatim
+//! \remarks The fixed size part of the header can be read without touching the solution
 inline constexpr db::MapConfig kHeaders{"Headers"};
 
+//! \details Stores the block number each known header hash belongs to
+//! \struct
+//! \verbatim
+//!   key   : block hash (32 bytes)
+//!   value : block_num_u32 (BE)
+//! \endverbatim
+inline constexpr db::MapConfig kHeaderNumbers{"HeaderNumbers"};
+
 inline constexpr const char* kDbSchemaVersionKey{"DbSchemaVersion"};
 
 //! \details Stores reached progress for each stage
@@ -58,7 +69,7 @@ inline constexpr const char* kDbSchemaVersionKey{"DbSchemaVersion"};
 inline constexpr db::MapConfig kSyncStageProgress{"Stages"};
 
 //! \brief List of all Chaindata database tables
-inline constexpr std::array<db::MapConfig, 3> kChainDataTables{kConfig, kHeaders, kSyncStageProgress};
+inline constexpr std::array<db::MapConfig, 4> kChainDataTables{kConfig, kHeaders, kHeaderNumbers, kSyncStageProgress};
 
 //! \details Stores list of known peer addresses and related info
 //! \struct
@@ -16,9 +16,15 @@
 
 #include "addressbook.hpp"
 
+#include <cmath>
+#include <map>
+
 #include <absl/strings/str_cat.h>
+#include <boost/asio/post.hpp>
 #include <gsl/gsl_util>
 
+#include <core/crypto/evp_mac.hpp>
+
 #include <infra/common/log.hpp>
 #include <infra/common/stopwatch.hpp>
 #include <infra/database/access_layer.hpp>
@@ -28,7 +34,7 @@ namespace znode::net {
 
 size_t AddressBook::size() const {
     std::shared_lock lock{mutex_};
-    return list_index_.size();
+    return endpoint_index_.size();
 }
 
 std::pair<uint32_t, uint32_t> AddressBook::size_by_buckets() const {
@@ -37,13 +43,17 @@ std::pair<uint32_t, uint32_t> AddressBook::size_by_buckets() const {
 
 bool AddressBook::empty() const {
     std::shared_lock lock{mutex_};
-    return list_index_.empty();
+    return endpoint_index_.empty();
 }
 
 bool AddressBook::insert_or_update(NodeService& service, const IPAddress& source, std::chrono::seconds time_penalty) {
     std::scoped_lock lock{mutex_};
     try {
-        return insert_or_update_impl(service, source, time_penalty).second;
+        if (not source.is_routable() or not service.endpoint_.address_.is_routable()) {
+            throw std::invalid_argument("Not routable");
+        }
+        const auto new_slot{get_new_slot(service.endpoint_, compute_group(source))};
+        return insert_or_update_impl(service, source, new_slot, time_penalty).second;
     } catch (const std::invalid_argument& ex) {
         log::Warning("Address Book",
                      {"invalid", service.endpoint_.to_string(), "from", source.to_string(), "reason", ex.what()})
@@ -54,58 +64,99 @@ bool AddressBook::insert_or_update(NodeService& service, const IPAddress& source
 
 bool AddressBook::insert_or_update(std::vector<NodeService>& services, const IPAddress& source,
                                    std::chrono::seconds time_penalty) {
+    std::vector<Advertisement> advertisements{Advertisement{services, source}};
+    return insert_or_update(advertisements, time_penalty) not_eq 0U;
+}
+
+size_t AddressBook::insert_or_update(std::vector<Advertisement>& advertisements, std::chrono::seconds time_penalty) {
     using namespace std::chrono_literals;
     NodeSeconds now{Now<NodeSeconds>()};
-    const auto services_size{services.size()};
-
-    uint32_t added_count{0U};
-    std::set<IPEndpoint> unique_endpoints{};
-
     StopWatch sw(/*auto_start=*/true);
-    std::scoped_lock lock{mutex_};
-    for (auto it{services.begin()}; it not_eq services.end();) {
-        try {
-            // Only add nodes that have the network service bit set - otherwise they are not useful
-            if (not(it->services_ bitand static_cast<uint64_t>(NodeServicesType::kNodeNetwork))) {
-                it = services.erase(it);
-                continue;
-            }
 
-            // Verify remotes are not pushing duplicate addresses
-            // it's a violation of the protocol
-            if (!unique_endpoints.insert(it->endpoint_).second) {
-                throw std::invalid_argument("Duplicate endpoint");
+    const auto discard = [](const NodeService& service, const IPAddress& source, const char* reason) {
+        log::Warning("Address Book", {"invalid address", service.endpoint_.to_string(), "from", source.to_string(),
+                                      "reason", reason})
+            << "Discarded ...";
+    };
+
+    //! \brief An advertised service validated and with its "new" bucket's slot computed
+    struct PreparedService {
+        size_t advertisement_index;  // Position of the advertisement in the batch
+        NodeService* service;        // The advertised service
+        SlotAddress new_slot;        // Slot for the service as advertised by the source of the advertisement
+        bool inserted{false};        // Whether the service has been inserted
+    };
+
+    // Nothing is modified here : readers are let in meanwhile
+    size_t services_size{0U};
+    std::vector<PreparedService> prepared;
+    {
+        std::map<IPEndpoint, /*advertisement_index*/ size_t> batch_endpoints{};
+        std::shared_lock lock{mutex_};
+        for (size_t i{0}; i < advertisements.size(); ++i) {
+            auto& [services, source]{advertisements[i]};
+            services_size += services.size();
+            if (not source.is_routable()) {
+                log::Warning("Address Book", {"invalid source", source.to_string(), "reason", "Not routable"})
+                    << "Discarded ...";
+                continue;
             }
-
-            // Adjust martian dates
-            // TODO: Do we care to handle advertisements of node which have a time far in the past ? (say more than 3
-            // months)
-            if (it->time_ < NodeSeconds{NodeService::kTimeInit} or it->time_ > now + 10min) {
-                it->time_ = now - std::chrono::days(5);
+            const auto source_group{compute_group(source)};  // Same for all the services advertised
+            for (auto& service : services) {
+                // Only add nodes that have the network service bit set - otherwise they are not useful
+                if (not(service.services_ bitand static_cast<uint64_t>(NodeServicesType::kNodeNetwork))) continue;
+                if (not service.endpoint_.address_.is_routable()) {
+                    discard(service, source, "Not routable");
+                    continue;
+                }
+
+                // Verify remotes are not pushing duplicate addresses : it's a violation of the protocol.
+                // Instead the same address advertised by another node is legit but processing it twice in
+                // the same batch is pointless
+                const auto [endpoint_it, endpoint_inserted]{batch_endpoints.try_emplace(service.endpoint_, i)};
+                if (not endpoint_inserted) {
+                    if (endpoint_it->second == i) discard(service, source, "Duplicate endpoint");
+                    continue;
+                }
+
+                // Adjust martian dates
+                // TODO: Do we care to handle advertisements of node which have a time far in the past ? (say more
+                // than 3 months)
+                if (service.time_ < NodeSeconds{NodeService::kTimeInit} or service.time_ > now + 10min) {
+                    service.time_ = now - std::chrono::days(5);
+                }
+                prepared.push_back({i, &service, get_new_slot(service.endpoint_, source_group)});
             }
+        }
+    }
 
-            if (insert_or_update_impl(*it, source, time_penalty).second) {
-                ++added_count;
-                ++it;
-            } else {
-                // Don't bother to relay
-                it = services.erase(it);
-            }
-        } catch (const std::invalid_argument& ex) {
-            log::Warning("Address Book", {"invalid address", it->endpoint_.to_string(), "from", source.to_string(),
-                                          "reason", ex.what()})
-                << "Discarded ...";
-            it = services.erase(it);
+    size_t added_count{0U};
+    if (not prepared.empty()) {
+        std::scoped_lock lock{mutex_};
+        for (auto& item : prepared) {
+            const auto& source{advertisements[item.advertisement_index].source};
+            item.inserted = insert_or_update_impl(*item.service, source, item.new_slot, time_penalty).second;
+            if (item.inserted) ++added_count;
         }
     }
 
+    // Don't bother to relay what has not been inserted
+    std::vector<std::vector<NodeService>> inserted_services(advertisements.size());
+    for (auto& item : prepared) {
+        if (item.inserted) inserted_services[item.advertisement_index].push_back(std::move(*item.service));
+    }
+    for (size_t i{0}; i < advertisements.size(); ++i) {
+        advertisements[i].services.swap(inserted_services[i]);
+    }
+
     if (log::test_verbosity(log::Level::kTrace)) {
         std::ignore = log::Trace("Address Book",
-                                 {"processed", std::to_string(services_size), "in", StopWatch::format(sw.since_start()),
+                                 {"advertisements", std::to_string(advertisements.size()), "processed",
+                                  std::to_string(services_size), "in", StopWatch::format(sw.since_start()),
                                   "additions", std::to_string(added_count), "buckets new/tried",
                                   absl::StrCat(new_entries_size_.load(), "/", tried_entries_size_.load())});
     }
-    return (added_count > 0U);
+    return added_count;
 }
 
 bool AddressBook::set_good(const IPEndpoint& remote, const MsgVersionPayload& version_info, NodeSeconds time) noexcept {
@@ -120,6 +171,8 @@ bool AddressBook::set_good(const IPEndpoint& remote, const MsgVersionPayload& ve
     service_info->last_connection_attempt_ = time;
     service_info->last_connection_success_ = time;
     service_info->connection_attempts_ = 0U;
+    dirty_entries_.insert(entry_id);
+    update_slot_weights(entry_id);
 
     // Ensure is in the tried bucket
     if (!service_info->tried_ref_.has_value()) make_entry_tried(entry_id);
@@ -134,6 +187,8 @@ bool AddressBook::set_failed(const IPEndpoint& remote, NodeSeconds time) noexcep
     // Update info
     service_info->last_connection_attempt_ = time;
     ++service_info->connection_attempts_;
+    dirty_entries_.insert(entry_id);
+    update_slot_weights(entry_id);
 
     if (!service_info->tried_ref_.has_value()) make_entry_tried(entry_id);
     return true;
@@ -147,6 +202,7 @@ bool AddressBook::set_tried(const IPEndpoint& remote, NodeSeconds time) noexcept
 
     // Update info
     service_info.last_connection_attempt_ = time;
+    dirty_entries_.insert(entry_id);
 
     if (!service_info.tried_ref_.has_value()) make_entry_tried(entry_id);
     return true;
@@ -156,31 +212,38 @@ bool AddressBook::contains(const NodeService& service) const noexcept { return c
 
 bool AddressBook::contains(const IPEndpoint& endpoint) const noexcept {
     std::shared_lock lock{mutex_};
-    auto& idx{list_index_.get<by_endpoint>()};
-    return idx.contains(endpoint);
+    return endpoint_index_.contains(endpoint);
 }
 
 bool AddressBook::contains(uint32_t id) const noexcept {
     std::shared_lock lock{mutex_};
-    auto& idx{list_index_.get<by_id>()};
-    return idx.contains(id);
+    return id < entries_.size() and entries_[id].has_value();
 }
 
 std::pair<std::optional<IPEndpoint>, NodeSeconds> AddressBook::select_random(
     bool new_only, std::optional<IPAddressType> type) const noexcept {
     std::pair<std::optional<IPEndpoint>, NodeSeconds> ret{};
 
-    std::scoped_lock lock{mutex_};
+    std::shared_lock lock{mutex_};
     if (randomly_ordered_ids_.empty()) return ret;
     if (new_only and new_entries_size_.load() == 0U) return ret;
 
+    // Only entries of the requested type are selectable
+    const auto selectable_weight{[&type](const SlotWeights& weights) -> uint64_t {
+        if (type.has_value()) return weights[weights_index(type.value())].total();
+        return uint64_t{weights[0].total()} + weights[1].total();
+    }};
+    const bool new_selectable{selectable_weight(new_weights_) not_eq 0U};
+    const bool tried_selectable{not new_only and selectable_weight(tried_weights_) not_eq 0U};
+    if (not new_selectable and not tried_selectable) return ret;
+
     // Determine whether to select from new or tried buckets
     bool select_from_tried{false};
-    if (new_only or tried_entries_size_.load() == 0U) {
+    if (not tried_selectable) {
         // Select from new buckets
         select_from_tried = false;
     } else {
-        if (new_entries_size_.load() == 0U) {
+        if (not new_selectable) {
             // Select from tried buckets
             select_from_tried = true;
         } else {
@@ -191,25 +254,30 @@ std::pair<std::optional<IPEndpoint>, NodeSeconds> AddressBook::select_random(
     }
 
     const auto items_in_set{select_from_tried ? tried_entries_size_.load() : new_entries_size_.load()};
-    const auto& bucket{select_from_tried ? tried_buckets_ : new_buckets_};
-    const auto bucket_size{bucket.size()};
+    const auto& slots{select_from_tried ? tried_slots_ : new_slots_};
+    const auto& weights{select_from_tried ? tried_weights_ : new_weights_};
+    const auto total_weight{selectable_weight(weights)};
+    const auto now{Now<NodeSeconds>()};
 
     double chance_factor{1.0};
     for (int attempt{0}; attempt < 50'000; ++attempt) {
-        // Pick a random item in the bucket
-        const uint32_t random_item_index{static_cast<uint32_t>(randomize<size_t>(0U, bucket_size - 1))};
-        const auto random_item_it{std::next(bucket.begin(), random_item_index)};
-        const auto entry_id{random_item_it->second};
+        // Draw a slot with a probability proportional to the base chance of the entry it references : accepting
+        // it with a probability of get_chance() / get_base_chance() makes the selection proportional to get_chance()
+        // as if slots were drawn uniformly and accepted with a probability of get_chance()
+        auto cumulative_weight{randomize<uint64_t>(uint64_t{0}, total_weight - 1U)};
+        auto weights_type{type.has_value() ? weights_index(type.value()) : size_t{0}};
+        if (not type.has_value() and cumulative_weight >= weights[0].total()) {
+            cumulative_weight -= weights[0].total();
+            weights_type = 1U;
+        }
+        const auto entry_id{slots[weights[weights_type].find(static_cast<uint32_t>(cumulative_weight))]};
 
         NodeServiceInfo* service_info{nullptr};
         std::tie(service_info, std::ignore) = lookup_entry(entry_id);
         ASSERT(service_info not_eq nullptr);  // Must be found or else the data structures are inconsistent
 
-        // Check type
-        if (type.has_value()) {
-            if (service_info->service_.endpoint_.address_.get_type() not_eq type.value()) continue;
-        }
-        if (randbits(30) < static_cast<uint64_t>(chance_factor * service_info->get_chance() * (1ULL << 30))) {
+        const auto chance{service_info->get_chance(now) / service_info->get_base_chance()};
+        if (randbits(30) < static_cast<uint64_t>(chance_factor * chance * (1ULL << 30))) {
             ret.first = service_info->service_.endpoint_;
             ret.second = service_info->service_.time_;
         } else {
@@ -230,8 +298,8 @@ std::pair<std::optional<IPEndpoint>, NodeSeconds> AddressBook::select_random(
 }
 
 std::vector<NodeService> AddressBook::get_random_services(uint32_t max_count, uint32_t max_percentage,
-                                                          std::optional<IPAddressType> type) noexcept {
-    std::scoped_lock lock{mutex_};
+                                                          std::optional<IPAddressType> type) const noexcept {
+    std::shared_lock lock{mutex_};
     if (randomly_ordered_ids_.empty()) return {};
 
     size_t count{randomly_ordered_ids_.size()};
@@ -246,14 +314,21 @@ std::vector<NodeService> AddressBook::get_random_services(uint32_t max_count, ui
     const auto now{Now<NodeSeconds>()};
     std::vector<NodeService> ret{};
     ret.reserve(count);
-    auto& idx{list_index_.get<by_id>()};
 
+    // Partial Fisher-Yates shuffle over a virtual copy of randomly_ordered_ids_ : only the displaced ids are recorded
+    // so that the shared vector is left untouched and a shared lock suffices
+    std::unordered_map</*position*/ size_t, /*entry_id*/ uint32_t> displaced_ids{};
+    const auto id_at{[this, &displaced_ids](size_t position) {
+        const auto it{displaced_ids.find(position)};
+        return it == displaced_ids.end() ? randomly_ordered_ids_[position] : it->second;
+    }};
     for (size_t i{0}; ret.size() < count && i < randomly_ordered_ids_.size(); ++i) {
-        size_t random_index{randomize<size_t>(0U, randomly_ordered_ids_.size() - i - 1U) + i};
-        swap_randomly_ordered_ids(static_cast<uint32_t>(i), static_cast<uint32_t>(random_index));
-        auto it{idx.find(randomly_ordered_ids_[i])};
-        ASSERT(it not_eq idx.end());  // Must be found or else the data structures are inconsistent
-        const auto& service_info{*it->list_it};
+        const size_t random_index{randomize<size_t>(i, randomly_ordered_ids_.size() - 1U)};
+        const auto entry_id{id_at(random_index)};
+        displaced_ids[random_index] = id_at(i);  // Position i is never visited again
+        const auto* entry{lookup_entry(entry_id).first};
+        ASSERT(entry not_eq nullptr);  // Must be found or else the data structures are inconsistent
+        const auto& service_info{*entry};
         if (type.has_value() and service_info.service_.endpoint_.address_.get_type() not_eq type.value()) continue;
         if (service_info.is_bad(now)) continue;
         if (!selected_endpoints.insert(service_info.service_.endpoint_).second) continue;  // Duplicate
@@ -265,6 +340,19 @@ std::vector<NodeService> AddressBook::get_random_services(uint32_t max_count, ui
 bool AddressBook::start() noexcept {
     bool ret{Stoppable::start()};
     if (ret) {
+        try {
+            // Map handles stay valid for the lifetime of the environment
+            db::RWTxn txn(node_data_env_);
+            db::tables::deploy_tables(*txn, db::tables::kNodeDataTables);
+            maps_.emplace(NodeDataMaps{db::open_map(*txn, db::tables::kServices),
+                                       db::open_map(*txn, db::tables::kRandomOrder),
+                                       db::open_map(*txn, db::tables::kBuckets)});
+            txn.commit(/*renew=*/false);
+        } catch (const std::exception& ex) {
+            log::Error("Address Book", {"action", "start", "error", ex.what()});
+            maps_.reset();
+        }
+        saver_context_.start();
         service_timer_.start(std::chrono::minutes(5),
                              [this](std::chrono::milliseconds& interval) { on_service_timer_expired(interval); });
     }
@@ -275,6 +363,9 @@ bool AddressBook::stop() noexcept {
     bool ret{Stoppable::stop()};
     if (ret) {
         service_timer_.stop();
+        saver_context_.stop();  // Waits for an ongoing save to complete
+        save();
+        maps_.reset();
     }
     return ret;
 }
@@ -283,32 +374,32 @@ void AddressBook::load() {
     using namespace std::chrono_literals;
     std::scoped_lock lock{mutex_};
     StopWatch sw(/*auto_start=*/true);
+    bool ids_compacted{false};
     try {
-
-        auto& env_config{app_settings_.nodedata_env_config};
-        env_config.path = (*app_settings_.data_directory)[DataDirectory::kNodesName].path().string();
-        env_config.create = !std::filesystem::exists(db::get_datafile_path(env_config.path));
-        env_config.exclusive = true;
-
-        log::Info("Opening database", {"path", env_config.path});
-        auto node_data_env{db::open_env(env_config)};
-        db::RWTxn txn(node_data_env);
-        db::tables::deploy_tables(*txn, db::tables::kNodeDataTables);
-        txn.commit(/*renew=*/true);
-
+        if (not maps_.has_value()) throw std::runtime_error("Node data tables not available");
+        db::ROTxn txn(node_data_env_);
         auto key_data(db::read_config_value(*txn, "seed"));
         if (key_data && key_data.value().size() == (2 * sizeof(uint64_t))) {
             key_ = key_data.value();
         }
 
-        db::Cursor cursor(txn, db::tables::kServices);
+        db::Cursor cursor(*txn, db::tables::kServices);
         log::Info("Address Book", {"action", "loading", "entries", std::to_string(cursor.size())});
 
         ser::SDataStream data_stream(ser::Scope::kStorage, 0);
         auto data{cursor.to_first(/*throw_notfound=*/false)};
-        uint32_t entry_id{1U};
+        uint32_t entry_id{0U};
 
         // Load services
+        // Persisted ids may be sparse (erased entries) : they're compacted so that entries_ has no holes and tables are
+        // rewritten on next save should any id have changed
+        std::unordered_map</*persisted_id*/ uint32_t, /*entry_id*/ uint32_t> ids{};
+        const auto translate_id{[&ids](uint32_t persisted_id) {
+            const auto it{ids.find(persisted_id)};
+            ASSERT(it not_eq ids.end());  // Must be found or else the tables are inconsistent
+            return it->second;
+        }};
+        entries_.reserve(cursor.size() + 1U);
         while (data) {
             data_stream.clear();
             std::ignore = data_stream.write(db::from_slice(data.value));
@@ -317,32 +408,34 @@ void AddressBook::load() {
             NodeServiceInfo service_info;
             const auto result{service_info.deserialize(data_stream)};
             if (!result.has_error()) {
-                auto new_it{list_.emplace(list_.end(), std::move(service_info))};
-                list_index_.insert({entry_id, service_info.service_.endpoint_, new_it});
+                const auto new_id{static_cast<uint32_t>(entries_.size())};
+                ids_compacted = ids_compacted or new_id not_eq entry_id;
+                ids.emplace(entry_id, new_id);
+                entries_.emplace_back(std::move(service_info));
+                std::ignore = endpoint_index_.insert(new_id);
             }
             data = cursor.to_next(/*throw_notfound=*/false);
         }
-        last_used_id_.exchange(entry_id + 1);  // Is the last used
 
         // Load randomly ordered ids
-        cursor.bind(txn, db::tables::kRandomOrder);
+        cursor.bind(*txn, db::tables::kRandomOrder);
         randomly_ordered_ids_.reserve(cursor.size());
         data = cursor.to_first(/*throw_notfound=*/false);
         while (data) {
-            entry_id = endian::load_big_u32(db::from_slice(data.value).data());
+            entry_id = translate_id(endian::load_big_u32(db::from_slice(data.value).data()));
             randomly_ordered_ids_.push_back(entry_id);
             data = cursor.to_next(/*throw_notfound=*/false);
         }
 
         // Load buckets
-        cursor.bind(txn, db::tables::kBuckets);
+        cursor.bind(*txn, db::tables::kBuckets);
         data = cursor.to_first(/*throw_notfound=*/false);
         while (data) {
             const auto key_view{db::from_slice(data.key)};
             const auto value_view{db::from_slice(data.value)};
             const auto bucket_type{key_view[0]};
             const auto slot_address{endian::load_big_u32(key_view.data() + 1)};
-            entry_id = endian::load_big_u32(value_view.data());
+            entry_id = translate_id(endian::load_big_u32(value_view.data()));
 
             NodeServiceInfo* service_info{nullptr};
             std::tie(service_info, std::ignore) = lookup_entry(entry_id);
@@ -351,13 +444,17 @@ void AddressBook::load() {
             switch (bucket_type) {
                 case 'N': {
                     ASSERT(service_info->new_refs_.emplace(slot_address).second);  // Must be inserted
-                    ASSERT(new_buckets_.emplace(slot_address, entry_id).second);   // Must be inserted
+                    const auto index{slot_index(SlotAddress{slot_address})};
+                    ASSERT(new_slots_[index] == 0U);  // Must be empty
+                    set_slot(/*tried=*/false, index, entry_id);
                     if (service_info->new_refs_.size() == 1U) ++new_entries_size_;
                 } break;
                 case 'T': {
                     ASSERT(service_info->tried_ref_.has_value() == false);  // Must not be in the tried bucket yet
                     service_info->tried_ref_.emplace(slot_address);
-                    ASSERT(tried_buckets_.emplace(slot_address, entry_id).second);  // Must be inserted
+                    const auto index{slot_index(SlotAddress{slot_address})};
+                    ASSERT(tried_slots_[index] == 0U);  // Must be empty
+                    set_slot(/*tried=*/true, index, entry_id);
                     ++tried_entries_size_;
                 } break;
                 default:
@@ -368,131 +465,196 @@ void AddressBook::load() {
 
         cursor.close();
         txn.abort();
-        log::Info("Closing database", {"path", env_config.path});
-        node_data_env.close();
     } catch (const std::exception& ex) {
-        log::Error("Address Book", {"action", "saving", "error", ex.what()});
+        log::Error("Address Book", {"action", "loading", "error", ex.what()});
         return;
     }
 
-    log::Info("Address Book", {"action", "loaded", "entries", std::to_string(list_.size()), "elapsed",
+    // What's in memory now mirrors the tables
+    dirty_entries_.clear();
+    dirty_random_positions_.clear();
+    dirty_new_slots_.clear();
+    dirty_tried_slots_.clear();
+    persisted_random_size_ = randomly_ordered_ids_.size();
+    full_save_needed_ = ids_compacted;
+
+    log::Info("Address Book", {"action", "loaded", "entries", std::to_string(endpoint_index_.size()), "elapsed",
                                StopWatch::format(sw.since_start())});
 }
 
-void AddressBook::save() const {
-    if (empty()) return;
-    
+void AddressBook::save() {
+    if (empty() or not maps_.has_value()) return;
+
     bool expected{false};
-    if (not is_saving_.compare_exchange_strong(expected, false)) return;
+    if (not is_saving_.compare_exchange_strong(expected, true)) return;
+    const auto reset_saving{gsl::finally([this] { is_saving_.store(false); })};
 
-    std::scoped_lock lock{mutex_};
     StopWatch sw(/*auto_start=*/true);
-    log::Info("Address Book", {"action", "saving", "entries", std::to_string(list_.size())}) << "...";
-
+    SaveSnapshot snapshot;
     try {
-        auto& env_config{app_settings_.nodedata_env_config};
-        env_config.path = (*app_settings_.data_directory)[DataDirectory::kNodesName].path().string();
-        env_config.create = !std::filesystem::exists(db::get_datafile_path(env_config.path));
-        env_config.exclusive = true;
-
-        log::Info("Opening database", {"path", env_config.path});
-        auto node_data_env{db::open_env(env_config)};
-        db::RWTxn txn(node_data_env);
-        db::tables::deploy_tables(*txn, db::tables::kNodeDataTables);
-        txn.commit(/*renew=*/true);
-        db::write_config_value(*txn, "seed", key_);
-        txn->clear_map(db::tables::kServices.name);
-        txn->clear_map(db::tables::kRandomOrder.name);
-        txn->clear_map(db::tables::kBuckets.name);
-        txn.commit(/*renew=*/true);
-        db::Cursor cursor(txn, db::tables::kServices);
+        snapshot = take_snapshot();
+        log::Info("Address Book", {"action", "saving", "entries", std::to_string(snapshot.book_size), "mode",
+                                   snapshot.full ? "full" : "delta"})
+            << "...";
+        persist(snapshot);
+    } catch (const std::exception& ex) {
+        log::Error("Address Book", {"action", "saving", "error", ex.what()});
+        std::scoped_lock lock{mutex_};
+        full_save_needed_ = true;  // Changes have been taken out of the dirty sets : rewrite everything next time
+        return;
+    }
 
-        ser::SDataStream data_stream(ser::Scope::kStorage, 0);
-        Bytes key(sizeof(uint32_t), 0);
-        auto& idx{list_index_.get<by_id>()};
+    const auto saved_count{std::min(snapshot.entries.size(), snapshot.book_size)};
+    log::Info("Address Book", {"action", "saved", "entries", std::to_string(snapshot.book_size), "saved",
+                               std::to_string(saved_count), "skipped", std::to_string(snapshot.book_size - saved_count),
+                               "elapsed", StopWatch::format(sw.since_start())});
+}
 
-        // Save all entries
-        for (auto it{idx.begin()}; it not_eq idx.end(); ++it) {
-            data_stream.clear();
-            const auto result{it->list_it->serialize(data_stream)};
-            if (result.has_error()) {
-                log::Error("Address Book", {"action", "serialization", "error", result.error().message()});
-                break;
+AddressBook::SaveSnapshot AddressBook::take_snapshot() {
+    // A shared lock is enough : dirty sets are otherwise only modified by writers (which hold the exclusive lock)
+    // and saves never overlap (see is_saving_). Hence writers wait for the snapshot while readers don't
+    std::shared_lock lock{mutex_};
+    SaveSnapshot ret;
+    ser::SDataStream data_stream(ser::Scope::kStorage, 0);
+    const auto take_entry{[&ret, &data_stream](uint32_t entry_id, NodeServiceInfo* service_info) {
+        if (service_info == nullptr) {
+            ret.entries.emplace_back(entry_id, std::nullopt);
+            return;
+        }
+        data_stream.clear();
+        if (const auto result{service_info->serialize(data_stream)}; result.has_error()) {
+            throw std::runtime_error("Unable to serialize entry " + std::to_string(entry_id) + " " +
+                                     result.error().message());
+        }
+        const auto data{data_stream.read().value()};
+        ret.entries.emplace_back(entry_id, Bytes{data.begin(), data.end()});
+    }};
+    ret.book_size = endpoint_index_.size();
+    ret.key = key_;
+
+    // When most of the entries have changed rewriting everything is cheaper than a sparse update
+    ret.full = full_save_needed_ or dirty_entries_.size() > endpoint_index_.size() / 2U;
+    if (ret.full) {
+        ret.entries.reserve(endpoint_index_.size());
+        for (uint32_t entry_id{1U}; entry_id < entries_.size(); ++entry_id) {
+            if (entries_[entry_id].has_value()) take_entry(entry_id, &entries_[entry_id].value());
+        }
+        ret.random_positions.reserve(randomly_ordered_ids_.size());
+        for (uint32_t position{0}; position < randomly_ordered_ids_.size(); ++position) {
+            ret.random_positions.emplace_back(position, randomly_ordered_ids_[position]);
+        }
+        ret.slots.reserve(new_entries_size_.load() + tried_entries_size_.load());
+        const auto take_slots{[&ret](uint8_t type, const std::vector<uint32_t>& slots) {
+            for (size_t index{0}; index < slots.size(); ++index) {
+                if (slots[index] not_eq 0U) ret.slots.emplace_back(type, slot_address_at(index).xy, slots[index]);
+            }
+        }};
+        take_slots('N', new_slots_);
+        take_slots('T', tried_slots_);
+    } else {
+        // Entries no longer in the book, positions past the current size and emptied slots are erased
+        ret.entries.reserve(dirty_entries_.size());
+        for (const auto entry_id : dirty_entries_) take_entry(entry_id, lookup_entry(entry_id).first);
+        for (const auto position : dirty_random_positions_) {
+            if (position < randomly_ordered_ids_.size()) {
+                ret.random_positions.emplace_back(position, randomly_ordered_ids_[position]);
             }
-
-            endian::store_big_u32(key.data(), it->id);
-            const auto k{db::to_slice(key)};
-            const auto v{db::to_slice(data_stream.read().value())};
-            cursor.upsert(k, v);
         }
-
-        // Save the contents of randomly ordered ids
-        uint32_t ordinal{0U};
-        Bytes value(sizeof(uint32_t), 0);
-        cursor.bind(txn, db::tables::kRandomOrder);
-        for (const auto entry_id : randomly_ordered_ids_) {
-            endian::store_big_u32(key.data(), ordinal++);
-            endian::store_big_u32(value.data(), entry_id);
-            const auto k{db::to_slice(key)};
-            const auto v{db::to_slice(value)};
-            cursor.upsert(k, v);
+        for (auto position{randomly_ordered_ids_.size()}; position < persisted_random_size_; ++position) {
+            ret.random_positions.emplace_back(static_cast<uint32_t>(position), std::nullopt);
         }
+        const auto take_slots{[&ret](uint8_t type, const std::vector<uint32_t>& slots,
+                                     const std::set<uint32_t>& dirty_slots) {
+            for (const auto slot_address : dirty_slots) {
+                const auto entry_id{slots[slot_index(SlotAddress{slot_address})]};
+                ret.slots.emplace_back(type, slot_address, entry_id == 0U ? std::nullopt : std::optional{entry_id});
+            }
+        }};
+        take_slots('N', new_slots_, dirty_new_slots_);
+        take_slots('T', tried_slots_, dirty_tried_slots_);
+    }
+
+    dirty_entries_.clear();
+    dirty_random_positions_.clear();
+    dirty_new_slots_.clear();
+    dirty_tried_slots_.clear();
+    persisted_random_size_ = randomly_ordered_ids_.size();
+    full_save_needed_ = false;
+    return ret;
+}
 
-        // Save the contents of New and Tried buckets
-        cursor.bind(txn, db::tables::kBuckets);
-        key.insert(key.begin(), 'N');
-        for (const auto& [slot_address, entry_id] : new_buckets_) {
-            endian::store_big_u32(key.data() + 1, slot_address);
-            endian::store_big_u32(value.data(), entry_id);
-            const auto k{db::to_slice(key)};
-            const auto v{db::to_slice(value)};
-            cursor.upsert(k, v);
+void AddressBook::persist(const SaveSnapshot& snapshot) const {
+    const auto& maps{maps_.value()};
+    db::RWTxn txn(node_data_env_);
+    db::write_config_value(*txn, "seed", snapshot.key);
+    if (snapshot.full) {
+        txn->clear_map(maps.services);
+        txn->clear_map(maps.random_order);
+        txn->clear_map(maps.buckets);
+    }
+
+    Bytes key(sizeof(uint32_t), 0);
+    Bytes value(sizeof(uint32_t), 0);
+
+    // Save entries
+    for (const auto& [entry_id, data] : snapshot.entries) {
+        endian::store_big_u32(key.data(), entry_id);
+        if (not data.has_value()) {
+            std::ignore = txn->erase(maps.services, db::to_slice(key));
+            continue;
         }
-        key[0] = 'T';
-        for (const auto& [slot_address, entry_id] : tried_buckets_) {
-            endian::store_big_u32(key.data() + 1, slot_address);
-            endian::store_big_u32(value.data(), entry_id);
-            const auto k{db::to_slice(key)};
-            const auto v{db::to_slice(value)};
-            cursor.upsert(k, v);
+        txn->upsert(maps.services, db::to_slice(key), db::to_slice(*data));
+    }
+
+    // Save the randomly ordered ids
+    for (const auto& [position, entry_id] : snapshot.random_positions) {
+        endian::store_big_u32(key.data(), position);
+        if (not entry_id.has_value()) {
+            std::ignore = txn->erase(maps.random_order, db::to_slice(key));
+            continue;
         }
+        endian::store_big_u32(value.data(), *entry_id);
+        txn->upsert(maps.random_order, db::to_slice(key), db::to_slice(value));
+    }
 
-        cursor.close();
-        txn.commit(/*renew=*/false);
-        log::Info("Closing database", {"path", env_config.path});
-        node_data_env.close();
-    } catch (const std::exception& ex) {
-        log::Error("Address Book", {"action", "saving", "error", ex.what()});
-        is_saving_.exchange(false);
-        return;
+    // Save the contents of New and Tried buckets
+    key.insert(key.begin(), 0);  // Bucket type prefix
+    for (const auto& [type, slot_address, entry_id] : snapshot.slots) {
+        key[0] = type;
+        endian::store_big_u32(key.data() + 1, slot_address);
+        if (not entry_id.has_value()) {
+            std::ignore = txn->erase(maps.buckets, db::to_slice(key));
+            continue;
+        }
+        endian::store_big_u32(value.data(), *entry_id);
+        txn->upsert(maps.buckets, db::to_slice(key), db::to_slice(value));
     }
 
-    log::Info("Address Book", {"action", "saved", "entries", std::to_string(list_.size()), "elapsed",
-                               StopWatch::format(sw.since_start())});
-    is_saving_.exchange(false);
-};
+    txn.commit(/*renew=*/false);
+}
 
 void AddressBook::on_service_timer_expired(con::Timer::duration& /*interval*/) {
     if (!is_running()) return;
     // TODO clean up outdated entries
-    save();
+    boost::asio::post(*saver_context_, [this]() { save(); });  // Keep the database write off the network threads
 }
 
 void AddressBook::erase_new_entry(uint32_t entry_id) noexcept {
     if (entry_id == 0U) return;  // Cannot erase non-existent entry
-    auto& idx{list_index_.get<by_id>()};
-    auto it{idx.find(entry_id)};
-    ASSERT(it not_eq idx.end());  // Must be found or else the data structures are inconsistent
-    auto& entry{*it->list_it};
+    auto* service_info{lookup_entry(entry_id).first};
+    ASSERT(service_info not_eq nullptr);  // Must be found or else the data structures are inconsistent
+    auto& entry{*service_info};
     ASSERT(entry.new_refs_.empty());        // Must not be referenced by any "new" bucket
     ASSERT(!entry.tried_ref_.has_value());  // Must not be in the tried bucket
 
     swap_randomly_ordered_ids(entry.random_pos_, static_cast<uint32_t>(randomly_ordered_ids_.size() - 1U));
     ASSERT(randomly_ordered_ids_.back() == entry_id);  // Must have become the last element
     randomly_ordered_ids_.pop_back();
+    dirty_entries_.insert(entry_id);  // Not found on save hence erased
     --new_entries_size_;
-    std::ignore = list_.erase(it->list_it);
-    std::ignore = idx.erase(it);
+    std::ignore = endpoint_index_.erase(entry.service_.endpoint_);
+    entries_[entry_id].reset();
+    free_ids_.push_back(entry_id);
 }
 
 void AddressBook::make_entry_tried(uint32_t entry_id) noexcept {
@@ -506,16 +668,17 @@ void AddressBook::make_entry_tried(uint32_t entry_id) noexcept {
     // Erase all references from the "new" buckets
     new_entries_size_ -= static_cast<uint32_t>(!service_info->new_refs_.empty());
     for (auto refs_iterator{service_info->new_refs_.begin()}; refs_iterator not_eq service_info->new_refs_.end();) {
-        new_buckets_.erase(*refs_iterator);
+        set_slot(/*tried=*/false, slot_index(SlotAddress{*refs_iterator}), 0U);
+        dirty_new_slots_.insert(*refs_iterator);
         refs_iterator = service_info->new_refs_.erase(refs_iterator);
     }
 
     const auto tried_slot_address{get_tried_slot(*service_info)};
-    const auto tried_slot_it{tried_buckets_.find(tried_slot_address.xy)};
+    const auto tried_slot_index{slot_index(tried_slot_address)};
 
-    if (tried_slot_it not_eq tried_buckets_.end()) {
+    if (tried_slots_[tried_slot_index] not_eq 0U) {
         // Evict existing item from the tried bucket
-        auto [evict_service_info, evict_entry_id]{lookup_entry(tried_slot_it->second)};
+        auto [evict_service_info, evict_entry_id]{lookup_entry(tried_slots_[tried_slot_index])};
         ASSERT(evict_service_info != nullptr);
 
         ASSERT(evict_service_info->tried_ref_.has_value() &&
@@ -523,30 +686,34 @@ void AddressBook::make_entry_tried(uint32_t entry_id) noexcept {
         ASSERT(evict_service_info->new_refs_.empty());                            // Must not be referenced by any "new"
                                                                                   // bucket
         evict_service_info->tried_ref_.reset();
-        tried_buckets_.erase(tried_slot_it);
+        set_slot(/*tried=*/true, tried_slot_index, 0U);
         --tried_entries_size_;
 
         // Get coordinates for a bucket positioning in the "new" collection
         // and eventually put a reference to the evicted item
-        const auto slot_address{get_new_slot(*evict_service_info, evict_service_info->origin_)};
+        const auto slot_address{
+            get_new_slot(evict_service_info->service_.endpoint_, compute_group(evict_service_info->origin_))};
         clear_new_slot(slot_address, true);  // Make room for the new entry if necessary
         ASSERT(evict_service_info->new_refs_.emplace(slot_address.xy).second);  // Must be inserted
-        ASSERT(new_buckets_.emplace(slot_address.xy, evict_entry_id).second);   // Must be inserted
+        set_slot(/*tried=*/false, slot_index(slot_address), evict_entry_id);
+        dirty_new_slots_.insert(slot_address.xy);
         ++new_entries_size_;
     }
 
-    ASSERT(tried_buckets_.emplace(tried_slot_address.xy, entry_id).second);  // Must be inserted
     service_info->tried_ref_.emplace(tried_slot_address.xy);
+    set_slot(/*tried=*/true, tried_slot_index, entry_id);
+    dirty_tried_slots_.insert(tried_slot_address.xy);
     ++tried_entries_size_;
 }
 
 void AddressBook::clear_new_slot(const SlotAddress& slot_address, bool erase_unreferenced_entry) noexcept {
     ASSERT(slot_address.x < kNewBucketsCount and slot_address.y < kBucketSize);
-    auto slot_it{new_buckets_.find(slot_address.xy)};
-    if (slot_it == new_buckets_.end()) return;  // Empty slot already
+    const auto index{slot_index(slot_address)};
+    const auto slot_entry_id{new_slots_[index]};
+    if (slot_entry_id == 0U) return;  // Empty slot already
 
     {
-        auto [service_info, entry_id]{lookup_entry(slot_it->second)};
+        auto [service_info, entry_id]{lookup_entry(slot_entry_id)};
         ASSERT(entry_id != 0U);                                        // Must be found
         ASSERT(service_info->new_refs_.erase(slot_address.xy) == 1U);  // Must be erased
         if (!service_info->new_refs_.empty() or service_info->tried_ref_.has_value()) {
@@ -555,28 +722,54 @@ void AddressBook::clear_new_slot(const SlotAddress& slot_address, bool erase_unr
     }
 
     // Remove the service from the address book entirely
-    if (erase_unreferenced_entry) erase_new_entry(slot_it->second);
-    new_buckets_.erase(slot_it);  // Effectively clear the slot
+    if (erase_unreferenced_entry) erase_new_entry(slot_entry_id);
+    set_slot(/*tried=*/false, index, 0U);  // Effectively clear the slot
+    dirty_new_slots_.insert(slot_address.xy);
+}
+
+void AddressBook::set_slot(bool tried, size_t index, uint32_t entry_id) noexcept {
+    auto& slots{tried ? tried_slots_ : new_slots_};
+    auto& weights{tried ? tried_weights_ : new_weights_};
+    slots[index] = entry_id;
+    for (auto& tree : weights) tree.set(index, 0U);
+    if (entry_id == 0U) return;
+
+    const auto* service_info{lookup_entry(entry_id).first};
+    ASSERT(service_info not_eq nullptr);  // Must be found or else the data structures are inconsistent
+    weights[weights_index(service_info->service_.endpoint_.address_.get_type())].set(index,
+                                                                                    selection_weight(*service_info));
+}
+
+void AddressBook::update_slot_weights(uint32_t entry_id) noexcept {
+    const auto* service_info{lookup_entry(entry_id).first};
+    ASSERT(service_info not_eq nullptr);  // Must be found or else the data structures are inconsistent
+    const auto weights_type{weights_index(service_info->service_.endpoint_.address_.get_type())};
+    const auto weight{selection_weight(*service_info)};
+    for (const auto slot_address : service_info->new_refs_) {
+        new_weights_[weights_type].set(slot_index(SlotAddress{slot_address}), weight);
+    }
+    if (service_info->tried_ref_.has_value()) {
+        tried_weights_[weights_type].set(slot_index(SlotAddress{service_info->tried_ref_.value()}), weight);
+    }
+}
+
+uint32_t AddressBook::selection_weight(const NodeServiceInfo& service_info) noexcept {
+    return static_cast<uint32_t>(std::ceil(service_info.get_base_chance() * kSelectionWeightScale));
 }
 
 std::pair<NodeServiceInfo*, /*id*/ uint32_t> AddressBook::lookup_entry(const IPEndpoint& endpoint) const noexcept {
-    auto& idx{list_index_.get<by_endpoint>()};
-    const auto it{idx.find(endpoint)};
-    if (it == idx.end()) {
+    const auto entry_id{endpoint_index_.find(endpoint)};
+    if (entry_id == 0U) {
         return {nullptr, 0U};
     }
-    NodeServiceInfo* entry{&(*(it->list_it))};
-    return {entry, it->id};
+    return {&entries_[entry_id].value(), entry_id};
 }
 
 std::pair<NodeServiceInfo*, /*id*/ uint32_t> AddressBook::lookup_entry(const uint32_t entry_id) const noexcept {
-    auto& idx{list_index_.get<by_id>()};
-    const auto it{idx.find(entry_id)};
-    if (it == idx.end()) {
+    if (entry_id >= entries_.size() or not entries_[entry_id].has_value()) {
         return {nullptr, 0U};
     }
-    NodeServiceInfo* entry{&(*(it->list_it))};
-    return {entry, it->id};
+    return {&entries_[entry_id].value(), entry_id};
 }
 
 void AddressBook::swap_randomly_ordered_ids(uint32_t i, uint32_t j) noexcept {
@@ -586,26 +779,25 @@ void AddressBook::swap_randomly_ordered_ids(uint32_t i, uint32_t j) noexcept {
     auto id_at_i{randomly_ordered_ids_[i]};
     auto id_at_j{randomly_ordered_ids_[j]};
 
-    auto& idx{list_index_.get<by_id>()};
-    auto it1{idx.find(id_at_i)};
-    auto it2{idx.find(id_at_j)};
-    ASSERT(it1 not_eq idx.end());  // Must be found
-    ASSERT(it2 not_eq idx.end());  // Must be found
+    auto* entry1{lookup_entry(id_at_i).first};
+    auto* entry2{lookup_entry(id_at_j).first};
+    ASSERT(entry1 not_eq nullptr);  // Must be found
+    ASSERT(entry2 not_eq nullptr);  // Must be found
 
     // Swap the references
-    it1->list_it->random_pos_ = j;
-    it2->list_it->random_pos_ = i;
+    entry1->random_pos_ = j;
+    entry2->random_pos_ = i;
 
     // Swap the ids
     randomly_ordered_ids_[i] = id_at_j;
     randomly_ordered_ids_[j] = id_at_i;
+    dirty_random_positions_.insert({i, j});
+    dirty_entries_.insert({id_at_i, id_at_j});
 }
 
-AddressBook::SlotAddress AddressBook::get_new_slot(const NodeServiceInfo& service,
-                                                   const IPAddress& source) const noexcept {
+AddressBook::SlotAddress AddressBook::get_new_slot(const IPEndpoint& endpoint, ByteView source_group) const noexcept {
     const ByteView key_view{key_.data(), key_.size()};
-    const auto source_group{compute_group(source)};
-    const auto service_group{compute_group(service.service_.endpoint_.address_)};
+    const auto service_group{compute_group(endpoint.address_)};
 
     SlotAddress ret{uint32_t(0)};
 
@@ -624,7 +816,7 @@ AddressBook::SlotAddress AddressBook::get_new_slot(const NodeServiceInfo& servic
     hasher.init(key_view);
     hasher.update('N');
     hasher.update(ret.x);
-    hasher.update(service.service_.endpoint_.to_bytes());
+    hasher.update(endpoint.to_bytes());
     const auto hash3{endian::load_little_u64(hasher.finalize().data())};
 
     ret.y = gsl::narrow_cast<uint16_t>(hash3 % kBucketSize);
@@ -684,18 +876,19 @@ Bytes AddressBook::compute_group(const IPAddress& address) noexcept {
 }
 
 std::pair<NodeServiceInfo*, bool> AddressBook::insert_or_update_impl(NodeService& service, const IPAddress& source,
+                                                                     const SlotAddress& new_slot,
                                                                      std::chrono::seconds time_penalty) {
     using namespace std::chrono_literals;
     if (source == service.endpoint_.address_) time_penalty = 0s;  // Self advertisement
     std::pair<NodeServiceInfo*, bool> ret{nullptr, false};
     auto [entry, entry_id]{lookup_entry(service.endpoint_)};
     if (entry != nullptr) {
-        update_entry(*entry, entry_id, service, source, time_penalty);
+        update_entry(*entry, entry_id, service, new_slot, time_penalty);
         ret.first = entry;
         ret.second = false;
     } else {
         // Insert new item
-        std::tie(entry, entry_id) = insert_entry(service, source, time_penalty);
+        std::tie(entry, entry_id) = insert_entry(service, source, new_slot, time_penalty);
         entry->service_.time_ = std::max(NodeSeconds{NodeService::kTimeInit}, service.time_ - time_penalty);
         ret.first = entry;
         ret.second = true;
@@ -704,37 +897,53 @@ std::pair<NodeServiceInfo*, bool> AddressBook::insert_or_update_impl(NodeService
 }
 
 std::pair<NodeServiceInfo*, uint32_t> AddressBook::insert_entry(const NodeService& service, const IPAddress& source,
+                                                                const SlotAddress& new_slot,
                                                                 std::chrono::seconds time_penalty) noexcept {
-    uint32_t new_id{last_used_id_.fetch_add(1U)};
     NodeServiceInfo service_info{service, source};
     service_info.service_.time_ -= time_penalty;
 
-    // Get coordinates of the bucket and position in the new bucket
-    // and eventually put a reference to the entry in the new bucket
-    const auto slot_address{get_new_slot(service_info, source)};
-    clear_new_slot(slot_address, true);                              // Make room for the new entry if necessary
-    ASSERT(service_info.new_refs_.emplace(slot_address.xy).second);  // Must be inserted
-    ASSERT(new_buckets_.emplace(slot_address.xy, new_id).second);    // Must be inserted
+    // Put a reference to the entry in the new bucket
+    // Note ! The id is assigned only after the slot has been cleared as this may free an id
+    clear_new_slot(new_slot, true);  // Make room for the new entry if necessary
+    uint32_t new_id{static_cast<uint32_t>(entries_.size())};
+    if (not free_ids_.empty()) {
+        new_id = free_ids_.back();
+        free_ids_.pop_back();
+    }
+    ASSERT(service_info.new_refs_.emplace(new_slot.xy).second);  // Must be inserted
 
     service_info.random_pos_ = static_cast<uint32_t>(randomly_ordered_ids_.size());
     randomly_ordered_ids_.push_back(new_id);
+    dirty_random_positions_.insert(service_info.random_pos_);
+    dirty_new_slots_.insert(new_slot.xy);
+    dirty_entries_.insert(new_id);
 
-    auto new_it{list_.emplace(list_.end(), std::move(service_info))};
-    list_index_.insert({new_id, service.endpoint_, new_it});
+    if (new_id == entries_.size()) {
+        entries_.emplace_back(std::move(service_info));
+    } else {
+        entries_[new_id].emplace(std::move(service_info));
+    }
+    ASSERT(endpoint_index_.insert(new_id));  // Must be inserted
+    set_slot(/*tried=*/false, slot_index(new_slot), new_id);
     ++new_entries_size_;
-    return {new_it.operator->(), new_id};
+    return {&entries_[new_id].value(), new_id};
 }
 
 void AddressBook::update_entry(NodeServiceInfo& entry, const uint32_t entry_id, const NodeService& service,
-                               const IPAddress& source, std::chrono::seconds time_penalty) noexcept {
+                               const SlotAddress& new_slot, std::chrono::seconds time_penalty) noexcept {
     // Update time seen
     using namespace std::chrono_literals;
     const bool currently_online{NodeClock::now() - service.time_ < 24h};
     const auto update_interval{currently_online ? 1h : 24h};
+    const auto previous_time{entry.service_.time_};
+    const auto previous_services{entry.service_.services_};
     if (entry.service_.time_ < (service.time_ - update_interval - time_penalty)) {
         entry.service_.time_ = std::max(NodeSeconds{NodeService::kTimeInit}, service.time_ - time_penalty);
     }
     entry.service_.services_ |= service.services_;
+    if (entry.service_.time_ not_eq previous_time or entry.service_.services_ not_eq previous_services) {
+        dirty_entries_.insert(entry_id);
+    }
 
     // Sanity check : entry must be either in the new bucket or in the tried bucket but not both
     ASSERT(!entry.new_refs_.empty() xor entry.tried_ref_.has_value());
@@ -754,22 +963,21 @@ void AddressBook::update_entry(NodeServiceInfo& entry, const uint32_t entry_id,
         return;
     }
 
-    // Get coordinates of the bucket and position in the new bucket
-    // and eventually put a reference to the entry in the new bucket
-    const auto slot_address{get_new_slot(entry, source)};
-    if (entry.new_refs_.contains(slot_address.xy)) {
-        ASSERT(new_buckets_.contains(slot_address.xy));  // Must be found or else the data structures are inconsistent)
+    // Eventually put a reference to the entry in the new bucket
+    if (entry.new_refs_.contains(new_slot.xy)) {
+        ASSERT(new_slots_[slot_index(new_slot)] == entry_id);  // Must be found or else the data structures are
+                                                                   // inconsistent
         return;
     }
 
-    auto slot_it{new_buckets_.find(slot_address.xy)};
-    if (slot_it != new_buckets_.end()) {
-        ASSERT(slot_it->second != entry_id);  // Must not contain a reference to this entry otherwise the data
-                                              // structures are inconsistent
-        clear_new_slot(slot_address, true);   // Make room for the new entry
+    if (new_slots_[slot_index(new_slot)] not_eq 0U) {
+        ASSERT(new_slots_[slot_index(new_slot)] != entry_id);  // Must not contain a reference to this entry
+                                                                   // otherwise the data structures are inconsistent
+        clear_new_slot(new_slot, true);                        // Make room for the new entry
     }
-    ASSERT(entry.new_refs_.emplace(slot_address.xy).second);         // Must be inserted
-    ASSERT(new_buckets_.emplace(slot_address.xy, entry_id).second);  // Must be inserted
+    ASSERT(entry.new_refs_.emplace(new_slot.xy).second);  // Must be inserted
+    set_slot(/*tried=*/false, slot_index(new_slot), entry_id);
+    dirty_new_slots_.insert(new_slot.xy);
     if (entry.new_refs_.size() == 1U) ++new_entries_size_;
 }
 }  // namespace znode::net
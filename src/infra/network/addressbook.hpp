@@ -15,23 +15,27 @@
 */
 
 #pragma once
+#include <array>
 #include <atomic>
-#include <list>
+#include <limits>
+#include <optional>
+#include <set>
 #include <shared_mutex>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <boost/asio/io_context.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index_container.hpp>
 
-#include <core/common/lru_set.hpp>
+#include <core/common/fenwick_tree.hpp>
+#include <core/common/id_hash_index.hpp>
+#include <core/common/recent_set.hpp>
 #include <core/common/random.hpp>
 #include <core/types/hash.hpp>
 
 #include <infra/common/settings.hpp>
+#include <infra/concurrency/context.hpp>
 #include <infra/concurrency/stoppable.hpp>
 #include <infra/concurrency/timer.hpp>
 #include <infra/database/mdbx.hpp>
@@ -51,11 +55,22 @@ class AddressBook : public con::Stoppable {
     static constexpr uint16_t kIPv4SubnetGroupsPrefix{16};
     static constexpr uint16_t kIPv6SubnetGroupsPrefix{64};
 
-    AddressBook(AppSettings& settings, boost::asio::io_context& io_context)
+    //! \brief Creates an address book persisted into the provided node data environment
+    //! \remarks The environment must be open by the time start() is invoked and stay open till stop() returns
+    AddressBook(AppSettings& settings, boost::asio::io_context& io_context, mdbx::env& node_data_env)
         : Stoppable(),
           app_settings_{settings},
           asio_context_{io_context},
-          service_timer_{io_context, "ab_service", true} {}
+          service_timer_{io_context, "ab_service", true},
+          node_data_env_{node_data_env},
+          saver_context_{"ab_saver", 1},
+          new_slots_(kNewBucketsCount * kBucketSize, 0U),
+          tried_slots_(kTriedBucketsCount * kBucketSize, 0U),
+          new_weights_{FenwickTree<uint32_t>(kNewBucketsCount * kBucketSize),
+                       FenwickTree<uint32_t>(kNewBucketsCount * kBucketSize)},
+          tried_weights_{FenwickTree<uint32_t>(kTriedBucketsCount * kBucketSize),
+                         FenwickTree<uint32_t>(kTriedBucketsCount * kBucketSize)},
+          entries_(1U) {}
     ~AddressBook() = default;
 
     // Not copyable nor moveable
@@ -120,6 +135,19 @@ class AddressBook : public con::Stoppable {
     [[nodiscard]] bool insert_or_update(std::vector<NodeService>& services, const IPAddress& source,
                                         std::chrono::seconds time_penalty);
 
+    //! \brief A set of services advertised by a node (i.e. the items of an addr message)
+    struct Advertisement {
+        std::vector<NodeService>& services;  // Advertised services (pruned of the ones not inserted)
+        IPAddress source;                    // Address of the advertising node
+    };
+
+    //! \brief Inserts or updates the services advertised by many nodes at once
+    //! \details Validation, deduplication (also across advertisements) and the computation of the "new" buckets
+    //! slots are carried out under a shared lock : the exclusive lock is then held only to apply the changes
+    //! \returns The number of inserted items
+    [[nodiscard]] size_t insert_or_update(std::vector<Advertisement>& advertisements,
+                                          std::chrono::seconds time_penalty);
+
     //! \brief Marks an item as good (reachable and successfully connected to)
     [[nodiscard]] bool set_good(const IPEndpoint& remote, const MsgVersionPayload& version_info,
                                 NodeSeconds time = Now<NodeSeconds>()) noexcept;
@@ -148,63 +176,130 @@ class AddressBook : public con::Stoppable {
 
     //! \brief Selects a randomly picked set of NodeServices from the ones collected into the address book
     std::vector<NodeService> get_random_services(uint32_t max_count, uint32_t max_percentage,
-                                                 std::optional<IPAddressType> type = std::nullopt) noexcept;
+                                                 std::optional<IPAddressType> type = std::nullopt) const noexcept;
 
     //! \brief Loads the address book from disk
     void load();
 
     //! \brief Saves the address book to disk
-    void save() const;
-
+    //! \details Only the entries, random order positions and bucket slots modified since last save are written (or
+    //! erased). The tables are rewritten from scratch (compaction) only when nothing has been persisted yet or when
+    //! most of the entries have changed.
+    //! Changes are serialized under a shared lock (entries are not deep copied) : lookups are never blocked and
+    //! inserts only wait for the serialization. Database writes happen with no lock held. Periodic saves run on a
+    //! dedicated thread
+    void save();
+
+    //! \brief Prepares the tables and starts the periodic saves
     bool start() noexcept override;
 
+    //! \brief Stops the periodic saves and saves the address book a last time
     bool stop() noexcept override;
 
   private:
+    friend struct AddressBookInspector;  // Unit tests access to the internal data structures
+
     AppSettings& app_settings_;              // Reference to global application settings
     boost::asio::io_context& asio_context_;  // Reference to global asio context
     con::Timer service_timer_;               // Triggers a maintenance cycle
-
-    mutable std::shared_mutex mutex_;                     // Thread safety
-    Bytes key_{get_random_bytes(2 * sizeof(uint64_t))};   // Secret key to randomize the address book
-    std::atomic<uint32_t> last_used_id_{1};               // Last used id (0 means "non-existent")
-    std::atomic<uint32_t> new_entries_size_{0};           // Number of items in "new" buckets
-    std::atomic<uint32_t> tried_entries_size_{0};         // Number of items in "tried" buckets
-    mutable std::vector<uint32_t> randomly_ordered_ids_;  // Randomly ordered ids
-    mutable std::atomic_bool is_saving_{false};           // Whether a save operation is in progress
-
-    /* Buckets */
-    std::map</*bucket_address*/ uint32_t, /*entry_id*/ uint32_t> new_buckets_;    // New buckets references
-    std::map</*bucket_address*/ uint32_t, /*entry_id*/ uint32_t> tried_buckets_;  // Tried buckets references
-    mutable LruSet<IPEndpoint, IPEndpointHasher> recently_selected_{64, true};  // Recently randomly selected endpoints
-                                                                                // to avoid very near duplicates
-
-    mutable std::list<NodeServiceInfo> list_;  // List of NodeServiceInfo (for iterator invariance)
-    using list_it_type = std::list<NodeServiceInfo>::iterator;
-    struct AddressBookEntry {
-        uint32_t id{0};         // Id of the entry
-        IPEndpoint endpoint{};  // Endpoint associated with the entry
-        list_it_type list_it;   // Iterator to the entry in the list
+    mdbx::env& node_data_env_;               // Reference to the node data environment
+    con::Context saver_context_;             // Runs periodic saves off the network threads
+
+    //! \brief Handles of the address book tables prepared once for all transactions
+    struct NodeDataMaps {
+        mdbx::map_handle services;
+        mdbx::map_handle random_order;
+        mdbx::map_handle buckets;
     };
-    struct by_id {};        // Tag for index naming
-    struct by_endpoint {};  // Tag for index naming
+    std::optional<NodeDataMaps> maps_{};  // Prepared tables handles (none if tables could not be deployed)
+
+    mutable std::shared_mutex mutex_;                    // Thread safety
+    Bytes key_{get_random_bytes(2 * sizeof(uint64_t))};  // Secret key to randomize the address book
+    std::atomic<uint32_t> new_entries_size_{0};          // Number of items in "new" buckets
+    std::atomic<uint32_t> tried_entries_size_{0};        // Number of items in "tried" buckets
+    std::vector<uint32_t> randomly_ordered_ids_;         // Randomly ordered ids
+    mutable std::atomic_bool is_saving_{false};          // Whether a save operation is in progress
+
+    /* Changes not yet persisted */
+    std::set<uint32_t> dirty_entries_;                         // Ids of entries inserted, modified or erased
+    std::set<uint32_t> dirty_random_positions_;                // Positions changed in randomly_ordered_ids_
+    std::set</*bucket_address*/ uint32_t> dirty_new_slots_;    // Slots changed in new_slots_
+    std::set</*bucket_address*/ uint32_t> dirty_tried_slots_;  // Slots changed in tried_slots_
+    size_t persisted_random_size_{0};                          // Size of randomly_ordered_ids_ as persisted
+    bool full_save_needed_{true};                              // Whether tables must be rewritten from scratch
+
+    /* Buckets : every slot holds the id of the referenced entry (0 means empty) */
+    std::vector</*entry_id*/ uint32_t> new_slots_;    // Slots of "new" buckets
+    std::vector</*entry_id*/ uint32_t> tried_slots_;  // Slots of "tried" buckets
+
+    /* Selection weights of the slots (base chance of the referenced entries) by address type (IPv4, IPv6) */
+    static constexpr uint32_t kSelectionWeightScale{1U << 15U};  // Weight of an entry with a base chance of 1.0
+    static_assert(uint64_t{kNewBucketsCount} * kBucketSize * kSelectionWeightScale <=
+                  std::numeric_limits<uint32_t>::max());  // The sum of all the weights must fit
+    using SlotWeights = std::array<FenwickTree<uint32_t>, 2>;
+    SlotWeights new_weights_;                                            // Weights of "new" buckets slots
+    SlotWeights tried_weights_;                                          // Weights of "tried" buckets slots
+    mutable RecentSet<IPEndpoint, IPEndpointHasher> recently_selected_;  // Recently randomly selected endpoints
+                                                                         // to avoid very near duplicates
+
+    /* Entries : the id of an entry is its position in entries_ and stays the same for the whole life of the entry */
+    mutable std::vector<std::optional<NodeServiceInfo>> entries_;  // Entries by id (position 0 is never used)
+    std::vector</*entry_id*/ uint32_t> free_ids_;                  // Ids of erased entries available for reuse
+
+    //! \brief Returns the endpoint of an entry by id
+    struct EntryEndpoint {
+        const std::vector<std::optional<NodeServiceInfo>>* entries;
+        const IPEndpoint& operator()(uint32_t id) const noexcept { return (*entries)[id]->service_.endpoint_; }
+    };
+    //! \brief Ids of the entries by endpoint
+    IdHashIndex<IPEndpoint, EntryEndpoint, IPEndpointHasher> endpoint_index_{EntryEndpoint{&entries_}};
+
+    //! \brief Returns the position of a slot in new_slots_ or tried_slots_
+    static size_t slot_index(const SlotAddress& slot_address) noexcept {
+        return static_cast<size_t>(slot_address.x) * kBucketSize + slot_address.y;
+    }
 
-    using address_book_index_t = boost::multi_index_container<
-        AddressBookEntry,
-        boost::multi_index::indexed_by<
-            boost::multi_index::ordered_unique<
-                boost::multi_index::tag<by_id>,
-                boost::multi_index::member<AddressBookEntry, uint32_t, &AddressBookEntry::id>>,
-            boost::multi_index::ordered_unique<
-                boost::multi_index::tag<by_endpoint>,
-                boost::multi_index::member<AddressBookEntry, IPEndpoint, &AddressBookEntry::endpoint>>>>;
+    //! \brief Returns the coordinates of the slot at the provided position in new_slots_ or tried_slots_
+    static SlotAddress slot_address_at(size_t index) noexcept {
+        return SlotAddress{static_cast<uint16_t>(index / kBucketSize), static_cast<uint16_t>(index % kBucketSize)};
+    }
 
-    address_book_index_t list_index_;
+    //! \brief Returns the position in SlotWeights of an address type
+    static size_t weights_index(IPAddressType type) noexcept { return type == IPAddressType::kIPv6 ? 1U : 0U; }
+
+    //! \brief Returns the selection weight of an entry
+    static uint32_t selection_weight(const NodeServiceInfo& service_info) noexcept;
+
+    //! \brief Binds a slot of "new" or "tried" buckets to an entry (0 clears the slot) and updates its weight
+    //! \remarks The entry must be already in entries_
+    void set_slot(bool tried, size_t index, uint32_t entry_id) noexcept;
+
+    //! \brief Updates the weights of all the slots referencing an entry (e.g. after its connection attempts changed)
+    void update_slot_weights(uint32_t entry_id) noexcept;
 
     /*
      * Note ! Private methods, if called from public methods, assume that the caller has already acquired a lock
      */
 
+    //! \brief A copy of the changes to be persisted (a nullopt value means the key is to be erased)
+    struct SaveSnapshot {
+        bool full{false};     // Whether tables are to be rewritten from scratch
+        size_t book_size{0};  // Number of entries in the book at the time of the snapshot
+        Bytes key{};          // Secret key of the book
+        std::vector<std::pair</*entry_id*/ uint32_t, std::optional</*serialized*/ Bytes>>> entries{};
+        std::vector<std::pair</*position*/ uint32_t, std::optional</*entry_id*/ uint32_t>>> random_positions{};
+        std::vector<std::tuple</*type*/ uint8_t, /*bucket_address*/ uint32_t, std::optional</*entry_id*/ uint32_t>>>
+            slots{};
+    };
+
+    //! \brief Serializes the pending changes (or everything on full saves) and resets the dirty sets
+    //! \remarks Acquires a shared lock. Should an entry not be serializable an exception is thrown
+    [[nodiscard]] SaveSnapshot take_snapshot();
+
+    //! \brief Writes a snapshot into the database in a single transaction
+    //! \remarks Requires no lock. Should the database not be writable an exception is thrown
+    void persist(const SaveSnapshot& snapshot) const;
+
     //! \brief Executes one maintenance cycle over address book entries
     void on_service_timer_expired(con::Timer::duration& interval);
 
@@ -233,7 +328,8 @@ class AddressBook : public con::Stoppable {
     void swap_randomly_ordered_ids(uint32_t i, uint32_t j) noexcept;
 
     //! \brief Computes the coordinates for placement in a "new" bucket's slot
-    SlotAddress get_new_slot(const NodeServiceInfo& service, const IPAddress& source) const noexcept;
+    //! \param source_group The group of the address of the node which advertised the endpoint (see compute_group)
+    SlotAddress get_new_slot(const IPEndpoint& endpoint, ByteView source_group) const noexcept;
 
     //! \brief Computes the coordinates for placement in a "tried" bucket's slot
     SlotAddress get_tried_slot(const NodeServiceInfo& service) const noexcept;
@@ -244,17 +340,20 @@ class AddressBook : public con::Stoppable {
     static Bytes compute_group(const IPAddress& address) noexcept;
 
     //! \brief Inserts or updates an address book item in the collection
+    //! \param new_slot The "new" bucket's slot for the service as advertised by source (see get_new_slot)
     //! \returns Whether any item was inserted
     [[nodiscard]] std::pair<NodeServiceInfo*, bool> insert_or_update_impl(NodeService& service, const IPAddress& source,
+                                                                          const SlotAddress& new_slot,
                                                                           std::chrono::seconds time_penalty);
 
-    //! \brief Inserts an entry in the list and add it to the internal data structures
+    //! \brief Inserts an entry and add it to the internal data structures
     //! \returns A pair containing a pointer to the newly created entry and its newly generated id
     std::pair<NodeServiceInfo*, /*id*/ uint32_t> insert_entry(const NodeService& service, const IPAddress& source,
+                                                              const SlotAddress& new_slot,
                                                               std::chrono::seconds time_penalty) noexcept;
 
     //! \brief Updates an entry with new information and eventually updates the references in the "new" buckets
-    void update_entry(NodeServiceInfo& entry, uint32_t entry_id, const NodeService& service, const IPAddress& source,
-                      std::chrono::seconds time_penalty) noexcept;
+    void update_entry(NodeServiceInfo& entry, uint32_t entry_id, const NodeService& service,
+                      const SlotAddress& new_slot, std::chrono::seconds time_penalty) noexcept;
 };
 }  // namespace znode::net
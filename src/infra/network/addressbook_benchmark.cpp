@@ -0,0 +1,370 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index_container.hpp>
+
+#include <core/common/id_hash_index.hpp>
+#include <core/common/random.hpp>
+
+#include <infra/network/addressbook.hpp>
+#include <infra/network/protocol.hpp>
+
+namespace znode::net {
+
+static constexpr size_t kBenchBookSize{20'000};      // Entries in the book before measurements begin
+static constexpr size_t kBenchOpsPerThread{20'000};  // Operations executed by each thread
+static constexpr size_t kBenchServicesPerAddr{10};   // Services carried by each simulated addr message
+static constexpr size_t kBenchLayoutSize{100'000};   // Entries in the storage layouts compared below
+static constexpr size_t kBenchLookups{10'000};       // Lookups executed for each iteration
+static constexpr size_t kBenchAddrMessages{64};       // Full addr messages ingested for each iteration
+
+namespace {
+std::atomic_size_t layout_bytes{0};  // Bytes currently allocated by the containers of the storage layouts
+}  // namespace
+
+//! \brief An allocator accounting the bytes held by the containers of the storage layouts
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    CountingAllocator() = default;
+    template <typename U>
+    explicit(false) CountingAllocator(const CountingAllocator<U>& /*other*/) noexcept {}
+    T* allocate(size_t count) {
+        layout_bytes += count * sizeof(T);
+        return std::allocator<T>{}.allocate(count);
+    }
+    void deallocate(T* ptr, size_t count) noexcept {
+        layout_bytes -= count * sizeof(T);
+        std::allocator<T>{}.deallocate(ptr, count);
+    }
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+};
+
+//! \brief The address book storage as it used to be: tree buckets, a list of entries and ordered indexes by id and
+//! by endpoint
+class NodeBasedBookLayout {
+  public:
+    void insert(uint32_t id, NodeServiceInfo service_info, size_t slot, bool tried) {
+        const auto endpoint{service_info.service_.endpoint_};
+        auto list_it{list_.emplace(list_.end(), std::move(service_info))};
+        index_.insert({id, endpoint, list_it});
+        (tried ? tried_buckets_ : new_buckets_).emplace(static_cast<uint32_t>(slot), id);
+    }
+    const NodeServiceInfo* find(const IPEndpoint& endpoint) const {
+        const auto& idx{index_.get<by_endpoint>()};
+        const auto it{idx.find(endpoint)};
+        return it == idx.end() ? nullptr : &*it->list_it;
+    }
+    //! \brief Picks a random entry referenced by the buckets (as select_random did)
+    const NodeServiceInfo* pick(bool tried) const {
+        const auto& buckets{tried ? tried_buckets_ : new_buckets_};
+        const auto slot_it{std::next(buckets.begin(), randomize<std::ptrdiff_t>(0, std::ssize(buckets) - 1))};
+        const auto& idx{index_.get<by_id>()};
+        return &*idx.find(slot_it->second)->list_it;
+    }
+
+  private:
+    using list_type = std::list<NodeServiceInfo, CountingAllocator<NodeServiceInfo>>;
+    struct Entry {
+        uint32_t id{0};
+        IPEndpoint endpoint{};
+        list_type::iterator list_it;
+    };
+    struct by_id {};
+    struct by_endpoint {};
+    using buckets_type =
+        std::map<uint32_t, uint32_t, std::less<>, CountingAllocator<std::pair<const uint32_t, uint32_t>>>;
+
+    buckets_type new_buckets_;
+    buckets_type tried_buckets_;
+    list_type list_;
+    boost::multi_index_container<
+        Entry,
+        boost::multi_index::indexed_by<
+            boost::multi_index::ordered_unique<boost::multi_index::tag<by_id>,
+                                               boost::multi_index::member<Entry, uint32_t, &Entry::id>>,
+            boost::multi_index::ordered_unique<boost::multi_index::tag<by_endpoint>,
+                                               boost::multi_index::member<Entry, IPEndpoint, &Entry::endpoint>>>,
+        CountingAllocator<Entry>>
+        index_;
+};
+
+//! \brief The address book storage as in AddressBook: slot arrays, entries by id and a hash index of ids by endpoint
+class FlatBookLayout {
+  public:
+    void insert(uint32_t id, NodeServiceInfo service_info, size_t slot, bool tried) {
+        if (entries_.size() <= id) entries_.resize(id + 1U);
+        entries_[id].emplace(std::move(service_info));
+        std::ignore = endpoint_index_.insert(id);
+        (tried ? tried_slots_ : new_slots_)[slot] = id;
+    }
+    const NodeServiceInfo* find(const IPEndpoint& endpoint) const {
+        const auto id{endpoint_index_.find(endpoint)};
+        return id == 0U ? nullptr : &*entries_[id];
+    }
+    //! \brief Picks a random entry referenced by the buckets (as select_random does)
+    const NodeServiceInfo* pick(bool tried) const {
+        const auto& slots{tried ? tried_slots_ : new_slots_};
+        uint32_t id{0U};
+        while (id == 0U) id = slots[randomize<size_t>(0U, slots.size() - 1U)];
+        return &*entries_[id];
+    }
+
+  private:
+    using slots_type = std::vector<uint32_t, CountingAllocator<uint32_t>>;
+    slots_type new_slots_ = slots_type(AddressBook::kNewBucketsCount * AddressBook::kBucketSize, 0U);
+    slots_type tried_slots_ = slots_type(AddressBook::kTriedBucketsCount * AddressBook::kBucketSize, 0U);
+    using entries_type = std::vector<std::optional<NodeServiceInfo>, CountingAllocator<std::optional<NodeServiceInfo>>>;
+    struct EntryEndpoint {
+        const entries_type* entries;
+        const IPEndpoint& operator()(uint32_t id) const noexcept { return (*entries)[id]->service_.endpoint_; }
+    };
+    entries_type entries_;
+    IdHashIndex<IPEndpoint, EntryEndpoint, IPEndpointHasher, CountingAllocator<uint32_t>> endpoint_index_{
+        EntryEndpoint{&entries_}};
+};
+
+//! \brief Builds a batch of services with random (public) IPv4 addresses as if received by an addr message
+std::vector<NodeService> make_random_services(size_t count) {
+    std::vector<NodeService> ret;
+    ret.reserve(count);
+    while (ret.size() < count) {
+        const boost::asio::ip::address_v4 address{randomize<uint32_t>(0x01000000U, 0xdfffffffU)};
+        NodeService service(boost::asio::ip::address{address}, 9033);
+        if (not service.endpoint_.address_.is_routable()) continue;
+        service.services_ = static_cast<uint64_t>(NodeServicesType::kNodeNetwork);
+        service.time_ = Now<NodeSeconds>();
+        ret.push_back(std::move(service));
+    }
+    return ret;
+}
+
+//! \brief Fills a storage layout with kBenchLayoutSize entries one fifth of which in "tried" buckets (as many as the
+//! slots : colliding entries are simply not referenced)
+//! \returns The endpoints of the inserted entries
+template <typename Layout>
+std::vector<IPEndpoint> fill_layout(Layout& layout) {
+    constexpr size_t kNewSlots{AddressBook::kNewBucketsCount * AddressBook::kBucketSize};
+    constexpr size_t kTriedSlots{AddressBook::kTriedBucketsCount * AddressBook::kBucketSize};
+    std::vector<IPEndpoint> ret;
+    ret.reserve(kBenchLayoutSize);
+    const IPAddress source{boost::asio::ip::make_address("8.8.8.8")};
+    for (const auto& service : make_random_services(kBenchLayoutSize)) {
+        const auto id{static_cast<uint32_t>(ret.size() + 1U)};
+        const bool tried{id % 5U == 0U};
+        const auto slot{tried ? id / 5U % kTriedSlots : id % kNewSlots};
+        layout.insert(id, NodeServiceInfo{service, source}, slot, tried);
+        ret.push_back(service.endpoint_);
+    }
+    return ret;
+}
+
+//! \brief Looks up entries by endpoint (half of them unknown) as insert_or_update and set_good do
+template <typename Layout>
+void bench_address_book_layout_lookup(benchmark::State& state) {
+    const auto bytes_before{layout_bytes.load()};
+    Layout layout;
+    auto endpoints{fill_layout(layout)};
+    const auto memory_bytes{layout_bytes.load() - bytes_before};
+    const auto unknown_endpoints{make_random_services(kBenchLookups / 2U)};
+
+    size_t lookups{0};
+    for ([[maybe_unused]] auto _ : state) {
+        for (size_t i{0}; i < kBenchLookups / 2U; ++i) {
+            benchmark::DoNotOptimize(layout.find(endpoints[randomize<size_t>(0U, endpoints.size() - 1U)]));
+            benchmark::DoNotOptimize(layout.find(unknown_endpoints[i].endpoint_));
+        }
+        lookups += kBenchLookups;
+    }
+
+    state.counters["memory_bytes"] = benchmark::Counter(static_cast<double>(memory_bytes));
+    state.counters["lookups_per_sec"] = benchmark::Counter(static_cast<double>(lookups), benchmark::Counter::kIsRate);
+}
+
+//! \brief Picks random entries from "new" and "tried" buckets as select_random does
+template <typename Layout>
+void bench_address_book_layout_pick(benchmark::State& state) {
+    Layout layout;
+    std::ignore = fill_layout(layout);
+
+    size_t picks{0};
+    for ([[maybe_unused]] auto _ : state) {
+        for (size_t i{0}; i < kBenchLookups; ++i) {
+            benchmark::DoNotOptimize(layout.pick(/*tried=*/i % 2U == 0U));
+        }
+        picks += kBenchLookups;
+    }
+
+    state.counters["picks_per_sec"] = benchmark::Counter(static_cast<double>(picks), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_TEMPLATE(bench_address_book_layout_lookup, NodeBasedBookLayout)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bench_address_book_layout_lookup, FlatBookLayout)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bench_address_book_layout_pick, NodeBasedBookLayout)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bench_address_book_layout_pick, FlatBookLayout)->Unit(benchmark::kMicrosecond);
+
+//! \brief Selects endpoints for dial-out connections from a book of range(0) entries (the fewer the entries the
+//! sparser the buckets)
+void bench_address_book_select(benchmark::State& state) {
+    using namespace std::chrono_literals;
+    const auto book_size{static_cast<size_t>(state.range(0))};
+
+    AppSettings settings{};
+    boost::asio::io_context io_context;
+    mdbx::env node_data_env{};
+    AddressBook address_book(settings, io_context, node_data_env);  // Not started : nothing gets persisted
+    while (address_book.size() < book_size) {
+        auto services{make_random_services(kBenchServicesPerAddr)};
+        const IPAddress source{services.front().endpoint_.address_};  // Spread over as many buckets as possible
+        std::ignore = address_book.insert_or_update(services, source, 0s);
+    }
+
+    size_t selections{0};
+    for ([[maybe_unused]] auto _ : state) {
+        for (size_t i{0}; i < kBenchLookups; ++i) {
+            benchmark::DoNotOptimize(address_book.select_random(/*new_only=*/false));
+        }
+        selections += kBenchLookups;
+    }
+
+    state.counters["selections_per_sec"] =
+        benchmark::Counter(static_cast<double>(selections), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(bench_address_book_select)->Arg(100)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMillisecond);
+
+//! \brief Concurrent selectors (range(0) threads) pick endpoints while inserters (range(1) threads) process addr
+//! messages : mimics the connector, the selector and the processor coroutines of NodeHub hammering the book
+void bench_address_book_contention(benchmark::State& state) {
+    using namespace std::chrono;
+    using namespace std::chrono_literals;
+    const auto selectors_count{static_cast<size_t>(state.range(0))};
+    const auto inserters_count{static_cast<size_t>(state.range(1))};
+
+    AppSettings settings{};
+    boost::asio::io_context io_context;
+    mdbx::env node_data_env{};
+    AddressBook address_book(settings, io_context, node_data_env);  // Not started : nothing gets persisted
+    const IPAddress source{boost::asio::ip::make_address("8.8.8.8")};
+    for (size_t i{0}; i < kBenchBookSize; i += kBenchServicesPerAddr) {
+        auto services{make_random_services(kBenchServicesPerAddr)};
+        std::ignore = address_book.insert_or_update(services, source, 0s);
+    }
+
+    size_t selections{0};
+    size_t insertions{0};
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<std::vector<NodeService>> batches;  // Prepared upfront : we're measuring the book only
+        for (size_t i{0}; i < inserters_count * kBenchOpsPerThread / kBenchServicesPerAddr; ++i) {
+            batches.push_back(make_random_services(kBenchServicesPerAddr));
+        }
+        std::atomic_size_t next_batch{0};
+        std::vector<std::thread> threads;
+        const auto start{steady_clock::now()};
+        for (size_t selector{0}; selector < selectors_count; ++selector) {
+            threads.emplace_back([&address_book]() {
+                for (size_t i{0}; i < kBenchOpsPerThread; ++i) {
+                    if (i % 100U == 0U) {
+                        benchmark::DoNotOptimize(address_book.get_random_services(1'000, 23));
+                    } else {
+                        benchmark::DoNotOptimize(address_book.select_random(/*new_only=*/false));
+                    }
+                }
+            });
+        }
+        for (size_t inserter{0}; inserter < inserters_count; ++inserter) {
+            threads.emplace_back([&]() {
+                for (auto batch_index{next_batch++}; batch_index < batches.size(); batch_index = next_batch++) {
+                    std::ignore = address_book.insert_or_update(batches[batch_index], source, 2h);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        state.SetIterationTime(duration<double>(steady_clock::now() - start).count());
+        selections += selectors_count * kBenchOpsPerThread;
+        insertions += batches.size() * kBenchServicesPerAddr;
+    }
+
+    state.counters["selections_per_sec"] =
+        benchmark::Counter(static_cast<double>(selections), benchmark::Counter::kIsRate);
+    state.counters["insertions_per_sec"] =
+        benchmark::Counter(static_cast<double>(insertions), benchmark::Counter::kIsRate);
+}
+
+// Args are the number of selecting threads and the number of inserting threads
+BENCHMARK(bench_address_book_contention)
+    ->ArgsProduct({{1, 2, 4, 8}, {0, 1, 2}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! \brief Ingests full addr messages from different nodes range(0) messages at a time : nodes relay the same
+//! addresses so messages partially overlap (half of the items of a message are in the previous one)
+void bench_address_book_ingest(benchmark::State& state) {
+    using namespace std::chrono_literals;
+    const auto batch_size{static_cast<size_t>(state.range(0))};
+
+    AppSettings settings{};
+    boost::asio::io_context io_context;
+    mdbx::env node_data_env{};
+    AddressBook address_book(settings, io_context, node_data_env);  // Not started : nothing gets persisted
+
+    size_t items{0};
+    for ([[maybe_unused]] auto _ : state) {
+        state.PauseTiming();
+        const auto relayed{make_random_services((kBenchAddrMessages + 1U) * kMaxAddrItems / 2U)};
+        std::vector<std::vector<NodeService>> messages;
+        std::vector<IPAddress> sources;
+        for (size_t i{0}; i < kBenchAddrMessages; ++i) {
+            const auto first{relayed.begin() + static_cast<std::ptrdiff_t>(i * kMaxAddrItems / 2U)};
+            messages.emplace_back(first, first + static_cast<std::ptrdiff_t>(kMaxAddrItems));
+            sources.push_back(make_random_services(1).front().endpoint_.address_);
+        }
+        state.ResumeTiming();
+
+        for (size_t i{0}; i < kBenchAddrMessages; i += batch_size) {
+            std::vector<AddressBook::Advertisement> advertisements;
+            for (size_t j{i}; j < std::min(i + batch_size, kBenchAddrMessages); ++j) {
+                advertisements.push_back({messages[j], sources[j]});
+            }
+            benchmark::DoNotOptimize(address_book.insert_or_update(advertisements, 2h));
+        }
+        items += kBenchAddrMessages * kMaxAddrItems;
+    }
+
+    state.counters["items_per_sec"] = benchmark::Counter(static_cast<double>(items), benchmark::Counter::kIsRate);
+}
+
+// Arg is the number of addr messages ingested at once (1 is no batching)
+BENCHMARK(bench_address_book_ingest)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+}  // namespace znode::net
@@ -0,0 +1,198 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <map>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <catch2/catch.hpp>
+
+#include <core/common/random.hpp>
+
+#include <infra/database/mdbx.hpp>
+#include <infra/filesystem/directories.hpp>
+#include <infra/network/addressbook.hpp>
+
+namespace znode::net {
+
+//! \brief The contents of an address book with entry ids resolved into endpoints (ids change on compaction)
+struct AddressBookImage {
+    std::map<std::string, Bytes> entries{};  // Persisted fields (random position included) by endpoint
+    std::map<std::string, std::set<uint32_t>> new_refs{};
+    std::map<std::string, std::optional<uint32_t>> tried_refs{};
+    std::vector<std::string> random_order{};
+    std::map</*index*/ size_t, std::string> new_slots{};
+    std::map</*index*/ size_t, std::string> tried_slots{};
+    bool operator==(const AddressBookImage& other) const = default;
+};
+
+struct AddressBookInspector {
+    static AddressBookImage image(const AddressBook& book) {
+        std::shared_lock lock{book.mutex_};
+        AddressBookImage ret;
+        const auto endpoint_of{[&book](uint32_t entry_id) {
+            return book.entries_[entry_id].value().service_.endpoint_.to_string();
+        }};
+
+        ser::SDataStream stream(ser::Scope::kStorage, 0);
+        for (const auto& entry : book.entries_) {
+            if (not entry.has_value()) continue;
+            auto service_info{*entry};
+            stream.clear();
+            REQUIRE_FALSE(service_info.serialize(stream).has_error());
+            const auto data{stream.read().value()};
+            const auto endpoint{service_info.service_.endpoint_.to_string()};
+            ret.entries.emplace(endpoint, Bytes{data.begin(), data.end()});
+            ret.new_refs.emplace(endpoint, service_info.new_refs_);
+            ret.tried_refs.emplace(endpoint, service_info.tried_ref_);
+        }
+        for (const auto entry_id : book.randomly_ordered_ids_) ret.random_order.push_back(endpoint_of(entry_id));
+        for (size_t index{0}; index < book.new_slots_.size(); ++index) {
+            if (book.new_slots_[index] not_eq 0U) ret.new_slots.emplace(index, endpoint_of(book.new_slots_[index]));
+        }
+        for (size_t index{0}; index < book.tried_slots_.size(); ++index) {
+            if (book.tried_slots_[index] not_eq 0U) {
+                ret.tried_slots.emplace(index, endpoint_of(book.tried_slots_[index]));
+            }
+        }
+        return ret;
+    }
+
+    //! \brief Whether some ids have been freed and not reused (i.e. a reload compacts the ids)
+    static bool has_free_ids(const AddressBook& book) {
+        std::shared_lock lock{book.mutex_};
+        return not book.free_ids_.empty();
+    }
+
+    //! \brief Whether the next save rewrites the tables from scratch
+    static bool full_save_pending(const AddressBook& book) {
+        std::shared_lock lock{book.mutex_};
+        return book.full_save_needed_ or book.dirty_entries_.size() > book.endpoint_index_.size() / 2U;
+    }
+};
+
+namespace {
+    NodeService make_random_service(NodeSeconds time) {
+        while (true) {
+            const boost::asio::ip::address_v4 address{randomize<uint32_t>(0x01000000U, 0xdfffffffU)};
+            NodeService service(boost::asio::ip::address{address}, 9033);
+            if (not service.endpoint_.address_.is_routable()) continue;
+            service.services_ = static_cast<uint64_t>(NodeServicesType::kNodeNetwork);
+            service.time_ = time;
+            return service;
+        }
+    }
+
+    //! \brief Inserts count new services advertised by source
+    //! \remarks Entries occupying the slots of the new ones are erased
+    std::vector<NodeService> insert_services(AddressBook& book, const IPAddress& source, size_t count,
+                                             NodeSeconds time) {
+        using namespace std::chrono_literals;
+        std::vector<NodeService> ret;
+        while (ret.size() < count) {
+            auto service{make_random_service(time)};
+            if (book.insert_or_update(service, source, 0s)) ret.push_back(std::move(service));
+        }
+        return ret;
+    }
+}  // namespace
+
+TEST_CASE("Address book persistence", "[network]") {
+    using namespace std::chrono_literals;
+    const TempDirectory tmp_dir{};
+    db::EnvConfig db_config{tmp_dir.path().string(), /*create=*/true};
+    db_config.inmemory = true;
+    auto env{db::open_env(db_config)};
+    AppSettings settings{};
+    boost::asio::io_context io_context;
+
+    const auto now{Now<NodeSeconds>()};
+    const auto source{IPAddress::from_string("8.8.8.8").value()};
+    const auto other_source{IPAddress::from_string("9.9.9.9").value()};
+    const auto third_source{IPAddress::from_string("4.4.4.4").value()};
+
+    // Every source crowds its own few buckets hence inserts erase the entries occupying the slots
+    AddressBook book(settings, io_context, env);
+    REQUIRE(book.start());
+    const auto services{insert_services(book, source, 1'500, now - 48h)};
+    const auto other_services{insert_services(book, other_source, 1'500, now - 48h)};
+    REQUIRE(AddressBookInspector::full_save_pending(book));  // Nothing persisted yet
+    book.save();
+    REQUIRE_FALSE(AddressBookInspector::full_save_pending(book));
+
+    // Erase (freed ids are reused straight away by the inserted entries)
+    std::ignore = insert_services(book, source, 100, now - 24h);
+    // Update : services advertised by another source get references in the buckets of the latter evicting (and
+    // erasing) the entries there. Erased ids are left free (till next insertions)
+    for (size_t i{0}; i < 200; ++i) {
+        auto service{services[i]};
+        if (not book.contains(service)) continue;  // Erased meanwhile : would be inserted again
+        service.time_ = now;
+        std::ignore = book.insert_or_update(service, other_source, 0s);
+    }
+    // Evict to tried
+    MsgVersionPayload version_info;
+    version_info.services_ = static_cast<uint64_t>(NodeServicesType::kNodeNetwork);
+    version_info.user_agent_ = "/test:1.0.0/";
+    for (size_t i{0}; i < 100; ++i) std::ignore = book.set_good(other_services[i].endpoint_, version_info, now - 1h);
+
+    SECTION("Delta save and reload") {
+        while (AddressBookInspector::has_free_ids(book)) {
+            std::ignore = insert_services(book, third_source, 1, now);  // Lands in empty slots : reuses a free id
+        }
+        REQUIRE_FALSE(AddressBookInspector::full_save_pending(book));
+        book.save();
+        const auto expected{AddressBookInspector::image(book)};
+
+        AddressBook reloaded_book(settings, io_context, env);
+        REQUIRE(reloaded_book.start());
+        reloaded_book.load();
+        CHECK_FALSE(AddressBookInspector::full_save_pending(reloaded_book));  // Same ids
+        CHECK(reloaded_book.size() == book.size());
+        CHECK(reloaded_book.size_by_buckets() == book.size_by_buckets());
+        CHECK(AddressBookInspector::image(reloaded_book) == expected);
+        CHECK(reloaded_book.stop());
+    }
+
+    SECTION("Compaction on reload") {
+        REQUIRE(AddressBookInspector::has_free_ids(book));
+        REQUIRE_FALSE(AddressBookInspector::full_save_pending(book));
+        book.save();
+        const auto expected{AddressBookInspector::image(book)};
+
+        AddressBook reloaded_book(settings, io_context, env);
+        REQUIRE(reloaded_book.start());
+        reloaded_book.load();
+        CHECK(AddressBookInspector::full_save_pending(reloaded_book));  // Ids have been compacted
+        CHECK(reloaded_book.size_by_buckets() == book.size_by_buckets());
+        CHECK(AddressBookInspector::image(reloaded_book) == expected);
+        CHECK(reloaded_book.stop());  // Rewrites the tables with the compacted ids
+
+        AddressBook compacted_book(settings, io_context, env);
+        REQUIRE(compacted_book.start());
+        compacted_book.load();
+        CHECK_FALSE(AddressBookInspector::full_save_pending(compacted_book));
+        CHECK(AddressBookInspector::image(compacted_book) == expected);
+        CHECK(compacted_book.stop());
+    }
+
+    CHECK(book.stop());
+}
+}  // namespace znode::net
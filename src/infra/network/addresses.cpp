@@ -564,11 +564,17 @@ double NodeServiceInfo::get_chance(znode::NodeSeconds now) const noexcept {
     using namespace std::chrono_literals;
     if (is_bad(now)) return 0.0;
 
-    double ret{1.0};
+    double ret{get_base_chance()};
 
     // De-prioritize very recent attempts
     if (now - last_connection_attempt_ < 10min) ret *= 0.01;
 
+    return ret;
+}
+
+double NodeServiceInfo::get_base_chance() const noexcept {
+    double ret{1.0};
+
     // De-prioritize 66% after each failed attempt, but at most 1/28th to avoid the search taking forever or overly
     // penalizing outages.
     if (connection_attempts_ > 0U) {
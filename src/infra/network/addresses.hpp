@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <optional>
 #include <set>
@@ -28,9 +30,10 @@
 #include <gsl/gsl_util>
 #include <nlohmann/json.hpp>
 
+#include <core/common/endian.hpp>
 #include <core/common/random.hpp>
 #include <core/common/time.hpp>
-#include <core/crypto/evp_mac.hpp>
+#include <core/crypto/siphash.hpp>
 #include <core/serialization/serializable.hpp>
 
 #include <infra/common/log.hpp>
@@ -155,30 +158,32 @@ class IPEndpoint : public ser::Serializable {
     outcome::result<void> serialization(ser::SDataStream& stream, ser::Action action) override;
 };
 
+//! \brief Keyed hasher of IPEndpoints (e.g. for hash tables)
+//! \details The raw address (16 bytes, IPv4 ones zero padded), the address type and the port are fed as words into
+//! SipHash-2-4 : no allocations nor OpenSSL contexts involved. Every instance has its own random key
 class IPEndpointHasher {
   public:
     IPEndpointHasher() = default;
     size_t operator()(const IPEndpoint& endpoint) const noexcept {
         const auto endpoint_type{endpoint.address_.get_type()};
-        crypto::SipHash24 hasher{seed_key_};
-        hasher.update(std::string(magic_enum::enum_name(endpoint_type)));
-
+        std::array<uint8_t, 16> address_bytes{};
         if (endpoint_type == IPAddressType::kIPv4) {
-            auto bytes = endpoint.address_->to_v4().to_bytes();
-            hasher.update(bytes);
+            const auto bytes{endpoint.address_->to_v4().to_bytes()};
+            std::copy(bytes.begin(), bytes.end(), address_bytes.begin());
         } else {
-            auto bytes = endpoint.address_->to_v6().to_bytes();
-            hasher.update(bytes);
+            address_bytes = endpoint.address_->to_v6().to_bytes();
         }
-        hasher.update(std::to_string(endpoint.port_));
 
-        const auto result{hasher.finalize()};
-        auto result_64{endian::load_little_u64(result.data())};
-        return static_cast<size_t>(result_64);
+        crypto::SipHasher hasher{k0_, k1_};
+        hasher.update(endian::load_little_u64(address_bytes.data()));
+        hasher.update(endian::load_little_u64(address_bytes.data() + sizeof(uint64_t)));
+        hasher.update(static_cast<uint64_t>(endpoint_type) bitor (uint64_t{endpoint.port_} << 8U));
+        return static_cast<size_t>(hasher.finalize());
     }
 
   private:
-    const Bytes seed_key_{get_random_bytes(2U * sizeof(uint64_t))};
+    const uint64_t k0_{randomize<uint64_t>()};
+    const uint64_t k1_{randomize<uint64_t>()};
 };
 
 class IPSubNet {
@@ -298,6 +303,9 @@ class NodeServiceInfo : public ser::Serializable {
     //! nodes for outbound connections
     [[nodiscard]] double get_chance(NodeSeconds now = Now<NodeSeconds>()) const noexcept;
 
+    //! \brief Returns the part of get_chance() which does not depend on time (i.e. an upper bound of it)
+    [[nodiscard]] double get_base_chance() const noexcept;
+
     [[nodiscard]] nlohmann::json to_json() const noexcept;
 
   private:
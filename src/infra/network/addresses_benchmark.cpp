@@ -0,0 +1,89 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <magic_enum.hpp>
+
+#include <core/common/endian.hpp>
+#include <core/common/random.hpp>
+#include <core/crypto/evp_mac.hpp>
+
+#include <infra/network/addresses.hpp>
+
+namespace znode::net {
+
+static constexpr size_t kBenchEndpoints{1'024};  // Endpoints hashed for each iteration
+
+//! \brief The IPEndpointHasher as it used to be : a new SipHash24 (OpenSSL contexts) and string conversions for every
+//! hash
+class LegacyIPEndpointHasher {
+  public:
+    size_t operator()(const IPEndpoint& endpoint) const noexcept {
+        const auto endpoint_type{endpoint.address_.get_type()};
+        crypto::SipHash24 hasher{seed_key_};
+        hasher.update(std::string(magic_enum::enum_name(endpoint_type)));
+        if (endpoint_type == IPAddressType::kIPv4) {
+            auto bytes = endpoint.address_->to_v4().to_bytes();
+            hasher.update(bytes);
+        } else {
+            auto bytes = endpoint.address_->to_v6().to_bytes();
+            hasher.update(bytes);
+        }
+        hasher.update(std::to_string(endpoint.port_));
+        const auto result{hasher.finalize()};
+        return static_cast<size_t>(endian::load_little_u64(result.data()));
+    }
+
+  private:
+    const Bytes seed_key_{get_random_bytes(2U * sizeof(uint64_t))};
+};
+
+//! \brief Hashes kBenchEndpoints random endpoints (half IPv4 half IPv6)
+template <typename Hasher>
+void bench_endpoint_hasher(benchmark::State& state) {
+    std::vector<IPEndpoint> endpoints;
+    for (size_t i{0}; i < kBenchEndpoints; ++i) {
+        const auto port{randomize<uint16_t>(uint16_t{1})};
+        if (i % 2U == 0U) {
+            const boost::asio::ip::address_v4 address{randomize<uint32_t>()};
+            endpoints.emplace_back(boost::asio::ip::address{address}, port);
+        } else {
+            boost::asio::ip::address_v6::bytes_type bytes{};
+            for (auto& byte : bytes) {
+                byte = static_cast<uint8_t>(randomize<uint16_t>(uint16_t{0}, uint16_t{UINT8_MAX}));
+            }
+            endpoints.emplace_back(boost::asio::ip::address{boost::asio::ip::address_v6{bytes}}, port);
+        }
+    }
+
+    const Hasher hasher{};
+    size_t hashes{0};
+    for ([[maybe_unused]] auto _ : state) {
+        for (const auto& endpoint : endpoints) {
+            benchmark::DoNotOptimize(hasher(endpoint));
+        }
+        hashes += endpoints.size();
+    }
+    state.counters["hashes_per_sec"] = benchmark::Counter(static_cast<double>(hashes), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_TEMPLATE(bench_endpoint_hasher, LegacyIPEndpointHasher);
+BENCHMARK_TEMPLATE(bench_endpoint_hasher, IPEndpointHasher);
+
+}  // namespace znode::net
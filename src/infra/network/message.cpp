@@ -18,13 +18,14 @@
 
 #include "message.hpp"
 
-#include "core/common/misc.hpp"
-
 #include <algorithm>
 
 #include <boost/algorithm/clamp.hpp>
 #include <gsl/gsl_util>
 
+#include <core/common/endian.hpp>
+#include <core/common/misc.hpp>
+
 namespace znode::net {
 
 void MessageHeader::reset() noexcept {
@@ -92,7 +93,7 @@ outcome::result<void> MessageHeader::validate(int protocol_version, const ByteVi
 
     // In case of empty payload, the checksum is already known
     if (payload_length == 0) {
-        auto empty_payload_hash{crypto::Hash256::kEmptyHash()};
+        const auto& empty_payload_hash{crypto::Hash256::kEmptyHashDigest};
         if (memcmp(payload_checksum.data(), empty_payload_hash.data(), payload_checksum.size()) not_eq 0)
             return Error::kMessageHeaderInvalidChecksum;
     }
@@ -111,6 +112,7 @@ void Message::reset() noexcept {
     ser_stream_.clear();
     header_validated_ = false;
     payload_validated_ = false;
+    if (payload_digest_.has_value()) payload_digest_->init();
 }
 
 outcome::result<void> Message::validate() noexcept {
@@ -144,7 +146,8 @@ outcome::result<void> Message::push(MessagePayload& payload) noexcept {
     const auto payload_view{ser_stream_.read()};
     if (!payload_view) return payload_view.error();
     crypto::Hash256 payload_digest(payload_view.value());
-    auto payload_hash{payload_digest.finalize()};
+    std::array<uint8_t, crypto::Hash256::kDigestSize> payload_hash{};
+    if (not payload_digest.finalize_to(payload_hash)) return Error::kMessageHeaderInvalidChecksum;
     std::memcpy(header_.payload_checksum.data(), payload_hash.data(), header_.payload_checksum.size());
 
     // Now copy the lazily computed size and checksum into the datastream
@@ -155,7 +158,7 @@ outcome::result<void> Message::push(MessagePayload& payload) noexcept {
     return validate();                  // Ensure the message is valid also when we push it
 }
 
-outcome::result<void> Message::write(ByteView& input) {
+outcome::result<void> Message::write(ByteView& input, bool in_place) {
     outcome::result<void> result{outcome::success()};
     if (input.empty()) {
         if (not header_validated_) return Error::kMessageHeaderIncomplete;
@@ -163,15 +166,34 @@ outcome::result<void> Message::write(ByteView& input) {
         return outcome::success();
     }
     if (is_complete()) return Error::kMessageWriteNotPermitted;  // Can't write twice
+
+    // Try bind the whole frame in place if available in input
+    if (in_place and ser_stream_.empty() and input.size() >= kMessageHeaderLength) {
+        const auto payload_length{
+            endian::load_little_u32(&input[kMessageHeaderMagicLength + kMessageHeaderCommandLength])};
+        if (payload_length <= kMaxProtocolMessageLength and input.size() >= kMessageHeaderLength + payload_length) {
+            const auto frame_length{kMessageHeaderLength + payload_length};
+            ser_stream_.attach(input.substr(0, frame_length));
+            input.remove_prefix(frame_length);
+            return validate();
+        }
+    }
     while (not input.empty()) {
         // Grab as many bytes either to have a complete header or a complete message
         const bool header_mode(ser_stream_.tellg() < kMessageHeaderLength);
         auto bytes_to_read(header_mode ? kMessageHeaderLength - ser_stream_.avail()
                                        : header_.payload_length - ser_stream_.avail());
         bytes_to_read = std::min(bytes_to_read, input.size());
-        if (result = ser_stream_.write(input.substr(0, bytes_to_read)); result.has_error()) return result.error();
+        const auto chunk{input.substr(0, bytes_to_read)};
+        if (result = ser_stream_.write(chunk); result.has_error()) return result.error();
         input.remove_prefix(bytes_to_read);
 
+        // Accumulate the payload checksum while data arrives so completion only costs the finalization
+        if (not header_mode) {
+            if (not payload_digest_.has_value()) payload_digest_.emplace();
+            payload_digest_->update(chunk);
+        }
+
         // Validate the message
         result = validate();
         if (not result.has_error()) break;
@@ -254,7 +276,10 @@ outcome::result<void> Message::validate_payload_vector(const MessageDefinition&
         }
         return num_elements.error();
     }
-    if (num_elements.value() == 0U) return Error::kMessagePayloadEmptyVector;
+    // Message `headers` may legitimately carry no items (the peer has nothing newer to serve)
+    if (num_elements.value() == 0U and message_definition.message_type not_eq MessageType::kHeaders) {
+        return Error::kMessagePayloadEmptyVector;
+    }
     if (num_elements.value() > message_definition.max_vector_items.value_or(ser::kMaxSerializedCompactSize)) {
         return Error::kMessagePayloadOversizedVector;
     }
@@ -279,8 +304,15 @@ outcome::result<void> Message::validate_payload_checksum() noexcept {
     if (payload_view.has_error()) return payload_view.error();
     ASSERT_POST(payload_view.value().size() == header_.payload_length);
 
-    crypto::Hash256 payload_digest(payload_view.value());
-    if (auto payload_hash{payload_digest.finalize()};
+    std::array<uint8_t, crypto::Hash256::kDigestSize> payload_hash{};
+    bool digest_ok{false};
+    if (payload_digest_.has_value() and payload_digest_->ingested_size() == header_.payload_length) {
+        digest_ok = payload_digest_->finalize_to(payload_hash);
+    } else {
+        crypto::Hash256 payload_digest(payload_view.value());
+        digest_ok = payload_digest.finalize_to(payload_hash);
+    }
+    if (not digest_ok or
         memcmp(payload_hash.data(), header_.payload_checksum.data(), header_.payload_checksum.size()) not_eq 0) {
         return Error::kMessageHeaderInvalidChecksum;
     }
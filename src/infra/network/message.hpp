@@ -111,6 +111,10 @@ class Message {
 
     [[nodiscard]] ser::SDataStream& data() noexcept { return ser_stream_; }
 
+    //! \brief Returns a view over the whole serialized message (header and payload)
+    //! \remarks Does not alter the read position hence is safe to use on messages shared among threads
+    [[nodiscard]] ByteView bytes() const noexcept { return ser_stream_.contents(); }
+
     //! \brief Sets the message version (generally inherited from the protocol version)
     void set_version(int version) noexcept { ser_stream_.set_version(version); }
 
@@ -124,10 +128,16 @@ class Message {
     [[nodiscard]] outcome::result<void> validate() noexcept;
 
     //! \brief Writes data into message buffer and tries to deserialize and validate
+    //! \param input [in, out] The data to be consumed
+    //! \param in_place Whether a whole frame (header and payload) available at the beginning of input should be
+    //! validated and deserialized directly from the input without being copied. Frames not entirely available
+    //! in input are copied and accumulated as usual
     //! \remarks Input data is consumed until the message is fully validated or an error occurs
     //! \remarks Any error returned `Error::kMessageHeaderIncomplete` or `Error::kMessageBodyIncomplete`
     //!          must be considered fatal
-    [[nodiscard]] outcome::result<void> write(ByteView& input);
+    //! \attention When in_place is true the caller MUST ensure underlying input data outlives the usage of this
+    //! message's data (i.e. until the message is reset)
+    [[nodiscard]] outcome::result<void> write(ByteView& input, bool in_place = false);
 
     //! \brief Populates the message header and payload
     outcome::result<void> push(MessagePayload& payload) noexcept;
@@ -138,6 +148,7 @@ class Message {
     std::array<uint8_t, kMessageHeaderMagicLength> network_magic_{0x0};  // Message magic (network)
     bool header_validated_{false};   // Whether the header has been validated already
     bool payload_validated_{false};  // Whether the payload has been validated already
+    std::optional<crypto::Hash256> payload_digest_{};  // Checksum of payload accumulated while it's being written
 
     //! \brief Validates the message header
     [[nodiscard]] outcome::result<void> validate_header() noexcept;
@@ -149,6 +160,8 @@ class Message {
     [[nodiscard]] outcome::result<void> validate_payload_vector(const MessageDefinition& message_definition) noexcept;
 
     //! \brief Validates the message header's checksum against the payload
+    //! \remarks When the payload has been entirely streamed through write() only the finalization of the
+    //! accumulated digest is due, otherwise the whole payload gets hashed
     [[nodiscard]] outcome::result<void> validate_payload_checksum() noexcept;
 };
 }  // namespace znode::net
@@ -0,0 +1,115 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <benchmark/benchmark.h>
+
+#include <core/crypto/hash256.hpp>
+
+#include <infra/network/message.hpp>
+#include <infra/network/payloads.hpp>
+
+namespace {
+thread_local size_t heap_allocations{0};  // Number of operator new invocations on this thread
+}  // namespace
+
+// Replacement of global allocation functions to count heap allocations
+// Note ! This file is built into its own executable (see cmd/benchmark) so other benchmarks are not affected
+// NOLINTBEGIN(cppcoreguidelines-no-malloc)
+void* operator new(std::size_t size) {
+    ++heap_allocations;
+    if (void* ptr{std::malloc(size == 0U ? 1U : size)}; ptr not_eq nullptr) return ptr;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t /*size*/) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept { std::free(ptr); }
+// NOLINTEND(cppcoreguidelines-no-malloc)
+
+namespace znode::net {
+
+static const std::array<uint8_t, kMessageHeaderMagicLength> kBenchNetworkMagic{0x01, 0x02, 0x03, 0x04};
+
+//! \brief Builds an inventory payload with the requested number of items
+MsgInventoryPayload make_inventory_payload(size_t items_count) {
+    MsgInventoryPayload payload{MessageType::kInv};
+    for (uint64_t i{1}; i <= items_count; ++i) {
+        InventoryItem item;
+        item.type_ = InventoryItem::Type::kTx;
+        item.identifier_ = h256(i);
+        payload.items_.push_back(item);
+    }
+    return payload;
+}
+
+//! \brief Checksum of a payload by means of the allocating finalize()
+void bench_checksum_finalize_bytes(benchmark::State& state) {
+    const Bytes payload(static_cast<size_t>(state.range(0)), 0x5a);
+    std::array<uint8_t, 4> checksum{};
+    const auto allocations_before{heap_allocations};
+    for ([[maybe_unused]] auto _ : state) {
+        crypto::Hash256 digest(payload);
+        const auto hash{digest.finalize()};
+        std::memcpy(checksum.data(), hash.data(), checksum.size());
+        benchmark::DoNotOptimize(checksum);
+    }
+    state.counters["allocs_per_op"] = benchmark::Counter(static_cast<double>(heap_allocations - allocations_before),
+                                                         benchmark::Counter::kAvgIterations);
+}
+
+//! \brief Checksum of a payload by means of the fixed size finalize_to()
+void bench_checksum_finalize_to(benchmark::State& state) {
+    const Bytes payload(static_cast<size_t>(state.range(0)), 0x5a);
+    std::array<uint8_t, 4> checksum{};
+    const auto allocations_before{heap_allocations};
+    for ([[maybe_unused]] auto _ : state) {
+        crypto::Hash256 digest(payload);
+        std::array<uint8_t, crypto::Hash256::kDigestSize> hash{};
+        benchmark::DoNotOptimize(digest.finalize_to(hash));
+        std::memcpy(checksum.data(), hash.data(), checksum.size());
+        benchmark::DoNotOptimize(checksum);
+    }
+    state.counters["allocs_per_op"] = benchmark::Counter(static_cast<double>(heap_allocations - allocations_before),
+                                                         benchmark::Counter::kAvgIterations);
+}
+
+//! \brief Full round trip of a message : push (serialization + checksum) and parse (validation + checksum)
+void bench_message_roundtrip(benchmark::State& state) {
+    auto payload{make_inventory_payload(static_cast<size_t>(state.range(0)))};
+    const auto allocations_before{heap_allocations};
+    for ([[maybe_unused]] auto _ : state) {
+        Message outbound_message(kDefaultProtocolVersion, kBenchNetworkMagic);
+        if (outbound_message.push(payload).has_error()) state.SkipWithError("push failed");
+        Message inbound_message(kDefaultProtocolVersion, kBenchNetworkMagic);
+        ByteView data{outbound_message.bytes()};
+        if (inbound_message.write(data).has_error()) state.SkipWithError("write failed");
+        benchmark::DoNotOptimize(inbound_message.is_complete());
+    }
+    state.counters["allocs_per_msg"] = benchmark::Counter(static_cast<double>(heap_allocations - allocations_before),
+                                                          benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(bench_checksum_finalize_bytes)->Arg(0)->Arg(36)->Arg(1_KiB);
+BENCHMARK(bench_checksum_finalize_to)->Arg(0)->Arg(36)->Arg(1_KiB);
+BENCHMARK(bench_message_roundtrip)->Arg(1)->Arg(20)->Arg(500);
+
+}  // namespace znode::net
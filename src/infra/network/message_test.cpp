@@ -119,25 +119,239 @@ TEST_CASE("NetMessage write", "[net]") {
     test_cases.emplace_back(test_case{"Valid command (inv) / correct payload length (73) / body signals 2 items",
                                       enc::hex::encode(input_bytes), std::nullopt});
 
-    for (const auto& test : test_cases) {
-        INFO(test.test_label)
+    // Outcomes must not depend on whether complete frames are parsed in place or copied
+    for (const bool in_place : {false, true}) {
+        for (const auto& test : test_cases) {
+            INFO(test.test_label << (in_place ? " (in place)" : ""))
+            test_message.reset();
+            CHECK(test_message.header().pristine());
+            const auto data{enc::hex::decode(test.input_data)};
+            REQUIRE_FALSE(data.has_error());
+            ByteView data_view{data.value()};
+            auto write_result{test_message.write(data_view, in_place)};
+
+            if (test.expected_error.has_value()) {
+                REQUIRE(write_result.has_error());
+                CHECK(write_result.error().value() == static_cast<int>(test.expected_error.value()));
+                CHECK(write_result.error().message() == as_message(test.expected_error.value()));
+            } else {
+                REQUIRE_FALSE(write_result.has_error());
+                REQUIRE(test_message.get_type() not_eq MessageType::kMissingOrUnknown);
+                REQUIRE(test_message.is_complete());
+                CHECK(test_message.data().attached() == in_place);
+                CHECK(data_view.empty());
+            }
+        }
+    }
+}
+
+TEST_CASE("NetMessage write in place", "[net]") {
+    const std::array<uint8_t, 4> network_magic_bytes{0x01, 0x02, 0x03, 0x04};
+    Message test_message(kDefaultProtocolVersion, network_magic_bytes);
+
+    // Two consecutive verack frames
+    const auto frame{enc::hex::decode(enc::hex::encode(network_magic_bytes) + "76657261636b000000000000" +
+                                      "000000005df6e0e2")
+                         .value()};
+    const Bytes input{frame + frame};
+
+    SECTION("Complete frames") {
+        ByteView data_view{input};
+        REQUIRE_FALSE(test_message.write(data_view, /*in_place=*/true).has_error());
+        CHECK(test_message.is_complete());
+        CHECK(test_message.data().attached());
+        CHECK(data_view.size() == frame.size());
+
         test_message.reset();
-        CHECK(test_message.header().pristine());
-        const auto data{enc::hex::decode(test.input_data)};
-        REQUIRE_FALSE(data.has_error());
-        ByteView data_view{data.value()};
-        auto write_result{test_message.write(data_view)};
-
-        if (test.expected_error.has_value()) {
-            REQUIRE(write_result.has_error());
-            CHECK(write_result.error().value() == static_cast<int>(test.expected_error.value()));
-            CHECK(write_result.error().message() == as_message(test.expected_error.value()));
-        } else {
-            REQUIRE_FALSE(write_result.has_error());
-            REQUIRE(test_message.get_type() not_eq MessageType::kMissingOrUnknown);
-            REQUIRE(test_message.is_complete());
+        CHECK_FALSE(test_message.data().attached());
+        REQUIRE_FALSE(test_message.write(data_view, /*in_place=*/true).has_error());
+        CHECK(test_message.is_complete());
+        CHECK(data_view.empty());
+    }
+
+    SECTION("Frame split across reads") {
+        ByteView first_chunk{input.data(), 10};
+        ByteView second_chunk{input.data() + 10, frame.size() - 10};
+        auto write_result{test_message.write(first_chunk, /*in_place=*/true)};
+        REQUIRE(write_result.has_error());
+        CHECK(write_result.error() == Error::kMessageHeaderIncomplete);
+        CHECK_FALSE(test_message.data().attached());
+        REQUIRE_FALSE(test_message.write(second_chunk, /*in_place=*/true).has_error());
+        CHECK(test_message.is_complete());
+        CHECK_FALSE(test_message.data().attached());
+    }
+}
+
+TEST_CASE("NetMessage shared frame", "[net]") {
+    const std::array<uint8_t, 4> network_magic_bytes{0x01, 0x02, 0x03, 0x04};
+    const auto message{std::make_shared<Message>(kDefaultProtocolVersion, network_magic_bytes)};
+    MsgNullPayload payload{MessageType::kVerAck};
+    REQUIRE_FALSE(message->push(payload).has_error());
+
+    // Same frame as in "NetMessage write in place"
+    const std::shared_ptr<const Message> shared_message{message};
+    const auto expected_frame{enc::hex::encode(network_magic_bytes) + "76657261636b000000000000" + "000000005df6e0e2"};
+    CHECK(enc::hex::encode(shared_message->bytes()) == expected_frame);
+    CHECK(shared_message->bytes().size() == shared_message->size());
+
+    // Accessing the frame does not move the read position
+    const auto read_position{message->data().tellg()};
+    CHECK(shared_message->bytes().size() == kMessageHeaderLength);
+    CHECK(message->data().tellg() == read_position);
+
+    // The frame is consumable by a receiving end
+    Message received_message(kDefaultProtocolVersion, network_magic_bytes);
+    ByteView data_view{shared_message->bytes()};
+    REQUIRE_FALSE(received_message.write(data_view).has_error());
+    CHECK(received_message.get_type() == MessageType::kVerAck);
+}
+
+TEST_CASE("NetMessage streaming checksum", "[net]") {
+    const std::array<uint8_t, 4> network_magic_bytes{0x01, 0x02, 0x03, 0x04};
+
+    MsgInventoryPayload payload{MessageType::kInv};
+    for (uint64_t i{1}; i <= 20; ++i) {
+        InventoryItem item;
+        item.type_ = InventoryItem::Type::kTx;
+        item.identifier_ = h256(i);
+        payload.items_.push_back(item);
+    }
+    Message source_message(kDefaultProtocolVersion, network_magic_bytes);
+    REQUIRE_FALSE(source_message.push(payload).has_error());
+    const Bytes frame{source_message.bytes()};
+
+    // Same frame with a corrupted payload byte (checksum must not match)
+    Bytes corrupted_frame{frame};
+    corrupted_frame.back() ^= 0xff;
+
+    for (const auto& input : {frame, corrupted_frame}) {
+        // Whole frame parsed in place : payload is hashed at once on completion
+        Message reference_message(kDefaultProtocolVersion, network_magic_bytes);
+        ByteView reference_view{input};
+        const auto reference_result{reference_message.write(reference_view, /*in_place=*/true)};
+        REQUIRE(reference_message.data().attached());
+
+        for (size_t split{1}; split <= input.size(); ++split) {
+            INFO("Split size " << split);
+            Message test_message(kDefaultProtocolVersion, network_magic_bytes);
+            outcome::result<void> result{outcome::success()};
+            for (size_t offset{0}; offset < input.size(); offset += split) {
+                ByteView chunk{ByteView{input}.substr(offset, split)};
+                result = test_message.write(chunk);
+                REQUIRE(chunk.empty());
+            }
+            REQUIRE(result.has_error() == reference_result.has_error());
+            if (result.has_error()) {
+                CHECK(result.error() == Error::kMessageHeaderInvalidChecksum);
+                CHECK(result.error() == reference_result.error());
+            } else {
+                CHECK(test_message.is_complete());
+                CHECK(test_message.bytes() == ByteView{input});
+            }
         }
     }
 }
 
-}  // namespace znode::net
\ No newline at end of file
+TEST_CASE("Payloads pool", "[net]") {
+    const auto& metrics{MessagePayload::pool_metrics()};
+    MessagePayload* recycled_ptr{nullptr};
+    {
+        auto payload_ptr{MessagePayload::acquire(MessageType::kInv)};
+        REQUIRE(payload_ptr);
+        CHECK(payload_ptr->type() == MessageType::kInv);
+        recycled_ptr = payload_ptr.get();
+    }
+
+    const auto hits{metrics.hits_.load()};
+    auto payload_ptr{MessagePayload::acquire(MessageType::kInv)};
+    CHECK(payload_ptr.get() == recycled_ptr);
+    CHECK(metrics.hits_.load() == hits + 1);
+
+    // Different type of same class must not be served from another type's bin
+    const auto misses{metrics.misses_.load()};
+    auto other_payload_ptr{MessagePayload::acquire(MessageType::kGetData)};
+    REQUIRE(other_payload_ptr);
+    CHECK(other_payload_ptr->type() == MessageType::kGetData);
+    CHECK(metrics.misses_.load() == misses + 1);
+
+    auto headers_payload_ptr{MessagePayload::acquire(MessageType::kHeaders)};
+    REQUIRE(headers_payload_ptr);
+    CHECK(headers_payload_ptr->type() == MessageType::kHeaders);
+}
+
+TEST_CASE("NetMessage headers", "[net]") {
+    const std::array<uint8_t, 4> network_magic_bytes{0x01, 0x02, 0x03, 0x04};
+
+    for (const size_t headers_count : {0U, 1U, 3U}) {
+        MsgHeadersPayload payload;
+        h256 parent_hash{};
+        for (size_t i{0}; i < headers_count; ++i) {
+            BlockHeader header;
+            header.version = 4;
+            header.parent_hash = parent_hash;
+            header.time = static_cast<uint32_t>(i);
+            header.solution = Bytes(1344, static_cast<uint8_t>(i));
+            parent_hash = header.hash();
+            payload.headers_.push_back(header);
+        }
+        Message source_message(kDefaultProtocolVersion, network_magic_bytes);
+        REQUIRE_FALSE(source_message.push(payload).has_error());
+
+        Message received_message(kDefaultProtocolVersion, network_magic_bytes);
+        ByteView data_view{source_message.bytes()};
+        REQUIRE_FALSE(received_message.write(data_view).has_error());
+        REQUIRE(received_message.get_type() == MessageType::kHeaders);
+
+        MsgHeadersPayload received_payload;
+        REQUIRE_FALSE(received_payload.deserialize(received_message.data()).has_error());
+        CHECK(received_message.data().eof());
+        REQUIRE(received_payload.headers_.size() == headers_count);
+        for (size_t i{0}; i < headers_count; ++i) {
+            CHECK(received_payload.headers_[i].hash() == payload.headers_[i].hash());
+        }
+    }
+}
+
+TEST_CASE("NetMessage stored headers", "[net]") {
+    const std::array<uint8_t, 4> network_magic_bytes{0x01, 0x02, 0x03, 0x04};
+
+    MsgHeadersPayload payload;
+    std::vector<Bytes> stored_headers;
+    stored_headers.reserve(4);
+    h256 parent_hash{};
+    for (size_t i{0}; i < 3; ++i) {
+        BlockHeader header;
+        header.version = 4;
+        header.parent_hash = parent_hash;
+        header.time = static_cast<uint32_t>(i);
+        header.solution = Bytes(1344, static_cast<uint8_t>(i));
+        parent_hash = header.hash();
+        ser::SDataStream storage_stream(ser::Scope::kStorage, 0);
+        REQUIRE_FALSE(header.serialize(storage_stream).has_error());
+        stored_headers.emplace_back(storage_stream.contents());
+        payload.headers_.push_back(header);
+    }
+
+    MsgStoredHeadersPayload stored_payload;
+    for (const auto& item : stored_headers) stored_payload.stored_headers_.emplace_back(item);
+
+    // Same frame as the one built from parsed headers
+    Message expected_message(kDefaultProtocolVersion, network_magic_bytes);
+    REQUIRE_FALSE(expected_message.push(payload).has_error());
+    Message stored_message(kDefaultProtocolVersion, network_magic_bytes);
+    REQUIRE_FALSE(stored_message.push(stored_payload).has_error());
+    CHECK(stored_message.bytes() == expected_message.bytes());
+    CHECK(stored_payload.serialized_size() == stored_message.size() - kMessageHeaderLength);
+
+    // Can't be deserialized
+    MsgStoredHeadersPayload received_payload;
+    CHECK(received_payload.deserialize(stored_message.data()).has_error());
+
+    // Stored headers must at least have the fixed size part
+    stored_headers.emplace_back(kBlockHeaderSerializedSize - 1, 0);
+    stored_payload.stored_headers_.emplace_back(stored_headers.back());
+    Message invalid_message(kDefaultProtocolVersion, network_magic_bytes);
+    CHECK(invalid_message.push(stored_payload).has_error());
+}
+
+}  // namespace znode::net
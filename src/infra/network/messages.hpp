@@ -114,7 +114,7 @@ inline constexpr MessageDefinition kMessageHeaders{
     .message_type = MessageType::kHeaders,
     .is_vectorized = true,
     .max_vector_items = size_t{kMaxHeadersItems},
-    .min_payload_length = size_t{1 + 140},
+    .min_payload_length = size_t{1},  // An empty list is legit (nothing newer to serve)
 };
 
 inline constexpr MessageDefinition kMessageGetAddr{
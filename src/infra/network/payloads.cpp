@@ -16,51 +16,112 @@
 
 #include "payloads.hpp"
 
+#include <algorithm>
+#include <array>
 #include <random>
+#include <vector>
 
 #include <absl/strings/str_cat.h>
+#include <gsl/pointers>
 
 #include <core/common/assert.hpp>
+#include <core/common/pooled_bytes.hpp>
 
 namespace znode::net {
 
 using namespace ser;
 
+namespace {
+
+    gsl::owner<MessagePayload*> new_payload(MessageType type) {
+        switch (type) {
+            using enum MessageType;
+            case kVersion:
+                return new MsgVersionPayload();
+
+                /* Same Payload for both Ping and Pong */
+
+            case kPing:
+            case kPong:
+                return new MsgPingPongPayload(type);
+
+            case kGetHeaders:
+                return new MsgGetHeadersPayload();
+            case kHeaders:
+                return new MsgHeadersPayload();
+            case kAddr:
+                return new MsgAddrPayload();
+            case kInv:
+            case kGetData:
+            case kNotFound:
+                return new MsgInventoryPayload(type);
+            case kReject:
+                return new MsgRejectPayload();
+
+                /* Following do not have a payload */
+
+            case kVerAck:
+            case kMemPool:
+            case kGetAddr:
+            case kMissingOrUnknown:
+                return new MsgNullPayload(type);
+            default:
+                return nullptr;
+        }
+    }
+
+    //! \brief Per-thread bins of recycled payloads indexed by message type
+    struct PayloadsCache {
+        std::array<std::vector<gsl::owner<MessagePayload*>>, static_cast<size_t>(MessageType::kMissingOrUnknown) + 1>
+            bins{};
+        ~PayloadsCache();
+    };
+
+    thread_local PayloadsCache payloads_cache;
+    thread_local bool payloads_cache_alive{true};  // Payloads released on thread exit can't be recycled
+    ObjectPoolMetrics payloads_pool_metrics;
+
+    PayloadsCache::~PayloadsCache() {
+        payloads_cache_alive = false;
+        for (auto& bin : bins) {
+            for (auto* ptr : bin) delete ptr;
+            bin.clear();
+        }
+    }
+
+    void recycle_payload(gsl::owner<MessagePayload*> ptr) noexcept {
+        if (payloads_cache_alive) {
+            auto& bin{payloads_cache.bins[static_cast<size_t>(ptr->type())]};
+            if (bin.size() < MessagePayload::kMaxRecycledPerType) {
+                bin.push_back(ptr);
+                return;
+            }
+        }
+        delete ptr;
+    }
+
+}  // namespace
+
 std::shared_ptr<MessagePayload> MessagePayload::from_type(MessageType type) {
-    switch (type) {
-        using enum MessageType;
-        case kVersion:
-            return std::make_shared<MsgVersionPayload>();
-
-            /* Same Payload for both Ping and Pong */
-
-        case kPing:
-        case kPong:
-            return std::make_shared<MsgPingPongPayload>(type);
-
-        case kGetHeaders:
-            return std::make_shared<MsgGetHeadersPayload>();
-        case kAddr:
-            return std::make_shared<MsgAddrPayload>();
-        case kInv:
-        case kGetData:
-        case kNotFound:
-            return std::make_shared<MsgInventoryPayload>(type);
-        case kReject:
-            return std::make_shared<MsgRejectPayload>();
-
-            /* Following do not have a payload */
-
-        case kVerAck:
-        case kMemPool:
-        case kGetAddr:
-        case kMissingOrUnknown:
-            return std::make_shared<MsgNullPayload>(type);
-        default:
-            return nullptr;
+    return std::shared_ptr<MessagePayload>(new_payload(type));
+}
+
+std::shared_ptr<MessagePayload> MessagePayload::acquire(MessageType type) {
+    gsl::owner<MessagePayload*> ptr{nullptr};
+    if (auto& bin{payloads_cache.bins[static_cast<size_t>(type)]}; not bin.empty()) {
+        ptr = bin.back();
+        bin.pop_back();
+        ++payloads_pool_metrics.hits_;
+    } else {
+        ptr = new_payload(type);
+        if (ptr == nullptr) return nullptr;
+        ++payloads_pool_metrics.misses_;
     }
+    return {ptr, recycle_payload, pooled_allocator<MessagePayload>()};
 }
 
+const ObjectPoolMetrics& MessagePayload::pool_metrics() noexcept { return payloads_pool_metrics; }
+
 outcome::result<void> MsgVersionPayload::serialization(SDataStream& stream, Action action) {
     auto result{stream.bind(protocol_version_, action)};
     if (not result.has_error()) result = stream.bind(services_, action);
@@ -164,6 +225,81 @@ nlohmann::json MsgGetHeadersPayload::to_json() const {
     return ret;
 }
 
+outcome::result<void> MsgHeadersPayload::serialization(SDataStream& stream, ser::Action action) {
+    // Each header is followed by the count of transactions which is always zero
+    if (action == Action::kSerialize) {
+        const auto vector_size = headers_.size();
+        if (vector_size > kMaxHeadersItems) return Error::kMessagePayloadOversizedVector;
+        if (auto result = write_compact(stream, vector_size); result.has_error()) return result.error();
+        for (auto& item : headers_) {
+            if (auto result{item.network_serialization(stream, action)}; result.has_error()) return result.error();
+            if (auto result{write_compact(stream, 0U)}; result.has_error()) return result.error();
+        }
+    } else {
+        const auto expected_vector_size = read_compact(stream);
+        if (expected_vector_size.has_error()) return expected_vector_size.error();
+        if (expected_vector_size.value() > kMaxHeadersItems) return Error::kMessagePayloadOversizedVector;
+        headers_.resize(expected_vector_size.value());  // Sized from the actual count (no upfront reservation)
+        for (auto& item : headers_) {
+            if (auto result = item.network_serialization(stream, action); result.has_error()) return result.error();
+            const auto transactions_count{read_compact(stream)};
+            if (transactions_count.has_error()) return transactions_count.error();
+            if (transactions_count.value() not_eq 0U) return Error::kMessagePayloadExtraData;
+        }
+    }
+    return outcome::success();
+}
+
+nlohmann::json MsgHeadersPayload::to_json() const {
+    nlohmann::json ret(nlohmann::json::value_t::object);
+    ret["command"] = std::string(magic_enum::enum_name(type())).substr(1);
+    ret["data"] = nlohmann::json(nlohmann::json::value_t::object);
+    auto& data = ret["data"];
+    data["headers"] = nlohmann::json(nlohmann::json::value_t::array);
+    auto& headers = data["headers"];
+    for (const auto& item : headers_) {
+        headers.push_back(item.hash().to_hex(/*reverse=*/true, /*with_prefix=*/true));
+    }
+    return ret;
+}
+
+size_t MsgStoredHeadersPayload::serialized_size() const noexcept {
+    size_t ret{ser_compact_sizeof(stored_headers_.size())};
+    for (const auto& item : stored_headers_) {
+        const auto solution_size{item.size() - std::min(item.size(), kBlockHeaderSerializedSize)};
+        ret += kBlockHeaderSerializedSize + ser_compact_sizeof(solution_size) + solution_size + 1U /* txn count */;
+    }
+    return ret;
+}
+
+outcome::result<void> MsgStoredHeadersPayload::serialization(SDataStream& stream, ser::Action action) {
+    // Deserialize as MsgHeadersPayload
+    if (action not_eq Action::kSerialize) return Error::kMessagePayLoadUnhandleable;
+    const auto vector_size = stored_headers_.size();
+    if (vector_size > kMaxHeadersItems) return Error::kMessagePayloadOversizedVector;
+    if (auto result{stream.reserve(stream.size() + serialized_size())}; result.has_error()) return result.error();
+    if (auto result = write_compact(stream, vector_size); result.has_error()) return result.error();
+    for (const auto& item : stored_headers_) {
+        if (item.size() < kBlockHeaderSerializedSize) return ser::Error::kReadOverflow;
+        const auto solution{item.substr(kBlockHeaderSerializedSize)};
+        if (auto result{stream.write(item.substr(0, kBlockHeaderSerializedSize))}; result.has_error()) {
+            return result.error();
+        }
+        if (auto result{write_compact(stream, solution.size())}; result.has_error()) return result.error();
+        if (auto result{stream.write(solution)}; result.has_error()) return result.error();
+        if (auto result{write_compact(stream, 0U)}; result.has_error()) return result.error();
+    }
+    return outcome::success();
+}
+
+nlohmann::json MsgStoredHeadersPayload::to_json() const {
+    nlohmann::json ret(nlohmann::json::value_t::object);
+    ret["command"] = std::string(magic_enum::enum_name(type())).substr(1);
+    ret["data"] = nlohmann::json(nlohmann::json::value_t::object);
+    ret["data"]["count"] = stored_headers_.size();
+    return ret;
+}
+
 outcome::result<void> MsgAddrPayload::serialization(SDataStream& stream, ser::Action action) {
     if (action == Action::kSerialize) {
         const auto vector_size = identifiers_.size();
@@ -256,6 +392,7 @@ outcome::result<void> MsgRejectPayload::serialization(SDataStream& stream, ser::
         if (not result.has_error() and extra_data_.has_value()) result = stream.bind(extra_data_.value(), action);
 
     } else {
+        extra_data_.reset();
         result = stream.bind(rejected_command_, action);
         if (not result.has_error() and not is_known_command(rejected_command_)) return Error::kUnknownRejectedCommand;
         if (not result.has_error()) {
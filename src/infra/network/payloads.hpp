@@ -16,11 +16,14 @@
 
 #pragma once
 #include <cstdint>
+#include <memory>
 #include <optional>
 
 #include <nlohmann/json.hpp>
 
+#include <core/common/object_pool.hpp>
 #include <core/serialization/serializable.hpp>
+#include <core/types/block.hpp>
 #include <core/types/hash.hpp>
 #include <core/types/inventory.hpp>
 
@@ -43,6 +46,18 @@ class MessagePayload : public ser::Serializable {
 
     [[nodiscard]] static std::shared_ptr<MessagePayload> from_type(MessageType type);
 
+    //! \brief Returns a payload of the given type recycled from the calling thread's pool whenever possible
+    //! \details Once the last reference to the returned payload is dropped the payload gets back to the pool of the
+    //! releasing thread. Recycled payloads retain the capacity of their containers and are meant to be overwritten
+    //! by deserialization.
+    [[nodiscard]] static std::shared_ptr<MessagePayload> acquire(MessageType type);
+
+    //! \brief Returns the metrics of the payloads pool
+    [[nodiscard]] static const ObjectPoolMetrics& pool_metrics() noexcept;
+
+    //! \brief Max number of recycled payloads kept by each thread for each message type
+    static constexpr size_t kMaxRecycledPerType{8};
+
   private:
     MessageType message_type_{MessageType::kMissingOrUnknown};
     friend class ser::SDataStream;
@@ -124,6 +139,42 @@ class MsgGetHeadersPayload : public MessagePayload {
     outcome::result<void> serialization(ser::SDataStream& stream, ser::Action action) override;
 };
 
+class MsgHeadersPayload : public MessagePayload {
+  public:
+    MsgHeadersPayload() : MessagePayload(MessageType::kHeaders) {}
+    ~MsgHeadersPayload() override = default;
+
+    std::vector<BlockHeader> headers_{};  // An empty list means the peer has nothing newer to serve
+
+    [[nodiscard]] nlohmann::json to_json() const override;
+
+  private:
+    friend class ser::SDataStream;
+    outcome::result<void> serialization(ser::SDataStream& stream, ser::Action action) override;
+};
+
+//! \brief A headers payload serialized straight from headers in storage format (see db::tables::kHeaders)
+//! \details Saves the parsing of stored headers into BlockHeader(s) when serving a getheaders request : each stored
+//! header is emitted in network format by injecting the length of the Equihash solution past the fixed size part
+//! \remarks Serialization only. The views MUST outlive the serialization (e.g. the read transaction they come from
+//! must still be open)
+class MsgStoredHeadersPayload : public MessagePayload {
+  public:
+    MsgStoredHeadersPayload() : MessagePayload(MessageType::kHeaders) { stored_headers_.reserve(kMaxHeadersItems); }
+    ~MsgStoredHeadersPayload() override = default;
+
+    std::vector<ByteView> stored_headers_{};  // Views on headers in storage format
+
+    //! \brief Returns the size of the serialized payload
+    [[nodiscard]] size_t serialized_size() const noexcept;
+
+    [[nodiscard]] nlohmann::json to_json() const override;
+
+  private:
+    friend class ser::SDataStream;
+    outcome::result<void> serialization(ser::SDataStream& stream, ser::Action action) override;
+};
+
 class MsgAddrPayload : public MessagePayload {
   public:
     MsgAddrPayload() : MessagePayload(MessageType::kAddr) {}
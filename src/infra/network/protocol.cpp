@@ -17,14 +17,17 @@
 #include "protocol.hpp"
 
 #include <algorithm>
-#include <utility>
-#include <vector>
+#include <array>
+#include <climits>
 
 #include <magic_enum.hpp>
 
 #include <core/common/assert.hpp>
 #include <core/common/base.hpp>
 #include <core/common/cast.hpp>
+#include <core/common/endian.hpp>
+
+#include <infra/network/messages.hpp>
 
 namespace znode::net {
 namespace {
@@ -41,26 +44,79 @@ namespace {
         return ret;
     }
 
-    std::vector<std::pair<Bytes, MessageType>> get_commands() {
-        std::vector<std::pair<Bytes, MessageType>> ret;
-        for (const auto enumerator : magic_enum::enum_values<MessageType>()) {
-            if (enumerator == MessageType::kMissingOrUnknown) continue;
-            ret.emplace_back(get_command_from_message_type(enumerator), enumerator);
+    //! \brief A command field split into two little endian integers for fast comparison
+    struct CommandKey {
+        uint64_t lo{0};  // Bytes [0, 8)
+        uint32_t hi{0};  // Bytes [8, 12)
+        MessageType message_type{MessageType::kMissingOrUnknown};
+    };
+
+    constexpr CommandKey make_command_key(const char* command, MessageType message_type) noexcept {
+        CommandKey ret{.message_type = message_type};
+        for (size_t i{0}; i < kMessageHeaderCommandLength and command[i] not_eq 0; ++i) {
+            const auto byte{static_cast<uint8_t>(command[i])};
+            if (i < sizeof(ret.lo)) {
+                ret.lo |= uint64_t{byte} << (CHAR_BIT * i);
+            } else {
+                ret.hi |= uint32_t{byte} << (CHAR_BIT * (i - sizeof(ret.lo)));
+            }
         }
         return ret;
     }
 
-}  // namespace
+    constexpr size_t kCommandsTableBits{5};
+    constexpr size_t kCommandsTableSize{size_t{1} << kCommandsTableBits};
+    static_assert(kCommandsTableSize >= kMessageDefinitions.size());
 
-MessageType message_type_from_command(const std::array<uint8_t, kMessageHeaderCommandLength>& command) {
-    static thread_local const auto commands{get_commands()};
-    for (const auto& [command_label, message_type] : commands) {
-        if (memcmp(command_label.data(), command.data(), command.size()) == 0) {
-            return message_type;
+    //! \brief Multiplicative hash of a command key into a slot of the commands table
+    constexpr size_t command_slot(uint64_t lo, uint32_t hi, uint64_t seed) noexcept {
+        return static_cast<size_t>(((lo ^ (uint64_t{hi} << 29U)) * seed) >> (64U - kCommandsTableBits));
+    }
+
+    //! \brief Searches for a seed which maps all known commands into distinct slots (i.e. a perfect hash)
+    constexpr uint64_t find_commands_seed() noexcept {
+        for (uint64_t seed{0x9e3779b97f4a7c15ULL}, attempts{0}; attempts < 1'000; seed += 2, ++attempts) {
+            std::array<bool, kCommandsTableSize> used{};
+            bool collision{false};
+            for (const auto& definition : kMessageDefinitions) {
+                if (definition.command == nullptr) continue;
+                const auto key{make_command_key(definition.command, definition.message_type)};
+                auto& slot{used[command_slot(key.lo, key.hi, seed)]};
+                if (slot) {
+                    collision = true;
+                    break;
+                }
+                slot = true;
+            }
+            if (not collision) return seed;
         }
+        return 0U;
     }
-    return MessageType::kMissingOrUnknown;
+
+    constexpr uint64_t kCommandsSeed{find_commands_seed()};
+    static_assert(kCommandsSeed not_eq 0U, "Unable to find a perfect hash for commands");
+
+    //! \brief The table of known commands indexed by command_slot
+    //! \remarks Empty slots hold an all zeroes key mapping to kMissingOrUnknown
+    constexpr auto kCommandsTable{[]() {
+        std::array<CommandKey, kCommandsTableSize> ret{};
+        for (const auto& definition : kMessageDefinitions) {
+            if (definition.command == nullptr) continue;
+            const auto key{make_command_key(definition.command, definition.message_type)};
+            ret[command_slot(key.lo, key.hi, kCommandsSeed)] = key;
+        }
+        return ret;
+    }()};
+
+}  // namespace
+
+MessageType message_type_from_command(const std::array<uint8_t, kMessageHeaderCommandLength>& command) {
+    const auto lo{endian::load_little_u64(command.data())};
+    const auto hi{endian::load_little_u32(&command[sizeof(lo)])};
+    const auto& entry{kCommandsTable[command_slot(lo, hi, kCommandsSeed)]};
+    return (entry.lo == lo and entry.hi == hi) ? entry.message_type : MessageType::kMissingOrUnknown;
 }
+
 bool is_known_command(const std::string& command) noexcept {
     if (command.empty() or command.size() > kMessageHeaderCommandLength) return false;
     std::array<uint8_t, kMessageHeaderCommandLength> command_bytes{0};
@@ -0,0 +1,70 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <cstring>
+
+#include <benchmark/benchmark.h>
+
+#include <core/crypto/hash256.hpp>
+
+#include <infra/network/message.hpp>
+#include <infra/network/messages.hpp>
+#include <infra/network/protocol.hpp>
+
+namespace znode::net {
+
+static const std::array<uint8_t, kMessageHeaderMagicLength> kNetworkMagic{0x01, 0x02, 0x03, 0x04};
+
+//! \brief Builds a formally valid header for the definition at given index
+//! \remarks Index of kMissingOrUnknown produces a header with an unknown command
+MessageHeader make_header(size_t definition_index) {
+    MessageHeader header;
+    header.network_magic = kNetworkMagic;
+    const auto& definition{kMessageDefinitions[definition_index]};
+    const char* command{definition.command not_eq nullptr ? definition.command : "foobar"};
+    std::memcpy(header.command.data(), command, std::strlen(command));
+    header.payload_length = static_cast<uint32_t>(definition.min_payload_length.value_or(0U));
+    if (header.payload_length == 0U) {
+        const auto empty_hash{crypto::Hash256::kEmptyHash()};
+        std::memcpy(header.payload_checksum.data(), empty_hash.data(), header.payload_checksum.size());
+    }
+    return header;
+}
+
+void bench_command_lookup(benchmark::State& state) {
+    const auto header{make_header(static_cast<size_t>(state.range(0)))};
+    state.SetLabel(std::string(header.command.begin(), header.command.end()).c_str());
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(message_type_from_command(header.command));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void bench_header_validation(benchmark::State& state) {
+    auto header{make_header(static_cast<size_t>(state.range(0)))};
+    state.SetLabel(std::string(header.command.begin(), header.command.end()).c_str());
+    for ([[maybe_unused]] auto _ : state) {
+        auto result{header.validate(kDefaultProtocolVersion, kNetworkMagic)};
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// One run per each known command plus an unknown one
+BENCHMARK(bench_command_lookup)->DenseRange(0, static_cast<int64_t>(MessageType::kMissingOrUnknown));
+BENCHMARK(bench_header_validation)->DenseRange(0, static_cast<int64_t>(MessageType::kMissingOrUnknown));
+
+}  // namespace znode::net
@@ -0,0 +1,59 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <cstring>
+
+#include <catch2/catch.hpp>
+
+#include <infra/network/messages.hpp>
+#include <infra/network/protocol.hpp>
+
+namespace znode::net {
+
+TEST_CASE("Command lookup", "[net]") {
+    SECTION("Known commands") {
+        for (const auto& definition : kMessageDefinitions) {
+            if (definition.command == nullptr) continue;
+            INFO(definition.command)
+            std::array<uint8_t, kMessageHeaderCommandLength> command{};
+            std::memcpy(command.data(), definition.command, std::strlen(definition.command));
+            CHECK(message_type_from_command(command) == definition.message_type);
+            CHECK(std::string(command_from_message_type(definition.message_type).c_str()) == definition.command);
+            CHECK(is_known_command(definition.command));
+        }
+    }
+
+    SECTION("Unknown commands") {
+        const std::vector<std::string> unknown_commands{"foobar", "VERSION", "versio", "versionn", "getheaderss",
+                                                        "verac"};
+        for (const auto& unknown_command : unknown_commands) {
+            INFO(unknown_command)
+            std::array<uint8_t, kMessageHeaderCommandLength> command{};
+            std::memcpy(command.data(), unknown_command.data(), unknown_command.size());
+            CHECK(message_type_from_command(command) == MessageType::kMissingOrUnknown);
+            CHECK_FALSE(is_known_command(unknown_command));
+        }
+
+        std::array<uint8_t, kMessageHeaderCommandLength> command{};
+        CHECK(message_type_from_command(command) == MessageType::kMissingOrUnknown);
+
+        // Garbage after the null terminator
+        std::memcpy(command.data(), "ping", 4);
+        command.back() = 'x';
+        CHECK(message_type_from_command(command) == MessageType::kMissingOrUnknown);
+    }
+}
+}  // namespace znode::net
@@ -0,0 +1,98 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "headers_server.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <core/common/endian.hpp>
+
+#include <infra/common/log.hpp>
+#include <infra/database/mdbx_tables.hpp>
+
+namespace znode::net {
+
+HeadersServer::HeadersServer(mdbx::env chaindata_env, const db::HeaderIndex& header_index,
+                             std::array<uint8_t, 4> network_magic, uint32_t burst, double requests_per_second)
+    : chaindata_env_{std::move(chaindata_env)},
+      header_index_{header_index},
+      network_magic_{network_magic},
+      burst_{static_cast<double>(std::max(burst, 1U))},
+      requests_per_second_{requests_per_second} {}
+
+bool HeadersServer::admit(int peer_id, std::chrono::steady_clock::time_point now) {
+    std::scoped_lock lock(buckets_mutex_);
+    auto [it, inserted]{buckets_.try_emplace(peer_id, TokenBucket{burst_, now})};
+    auto& bucket{it->second};
+    if (not inserted and now > bucket.last_refill) {
+        const std::chrono::duration<double> elapsed{now - bucket.last_refill};
+        bucket.tokens = std::min(burst_, bucket.tokens + elapsed.count() * requests_per_second_);
+        bucket.last_refill = now;
+    }
+    if (bucket.tokens < 1.0) {
+        ++rejected_requests_;
+        return false;
+    }
+    bucket.tokens -= 1.0;
+    return true;
+}
+
+void HeadersServer::forget(int peer_id) {
+    std::scoped_lock lock(buckets_mutex_);
+    buckets_.erase(peer_id);
+}
+
+std::shared_ptr<const Message> HeadersServer::build_response(const MsgGetHeadersPayload& request,
+                                                             int protocol_version) {
+    // Resolve the range of headers to serve
+    const auto first_block_num{static_cast<BlockNum>(
+        header_index_.find_fork_point(request.block_locator_hashes_).value_or(0U) + 1U)};  // Genesis is never served
+    auto last_block_num{static_cast<BlockNum>(first_block_num + kMaxHeadersItems - 1U)};
+    if (request.hash_stop_ not_eq h256{}) {
+        if (const auto stop_block_num{header_index_.find(request.hash_stop_)};
+            stop_block_num.has_value() and *stop_block_num >= first_block_num) {
+            last_block_num = std::min(last_block_num, *stop_block_num);
+        }
+    }
+
+    // Collect views on stored headers : they stay valid as long as the transaction is open
+    MsgStoredHeadersPayload payload;
+    db::ROTxn txn(chaindata_env_);
+    std::array<uint8_t, sizeof(BlockNum)> key{};
+    endian::store_big_u32(key.data(), first_block_num);
+    db::Cursor headers(*txn, db::tables::kHeaders);
+    auto data{headers.lower_bound(db::to_slice(ByteView{key.data(), key.size()}), /*throw_notfound=*/false)};
+    for (auto expected_block_num{first_block_num}; data and expected_block_num <= last_block_num;
+         ++expected_block_num) {
+        const auto block_num{endian::load_big_u32(static_cast<const uint8_t*>(data.key.data()))};
+        if (block_num not_eq expected_block_num) break;  // Gap (e.g. an unwind in progress) : serve what's linked
+        payload.stored_headers_.push_back(db::from_slice(data.value));
+        data = headers.to_next(/*throw_notfound=*/false);
+    }
+
+    // Serialize into a frame sized upfront
+    auto message{std::make_shared<Message>(protocol_version, network_magic_)};
+    if (const auto result{message->push(payload)}; result.has_error()) {
+        log::Error("Service", {"name", "Headers Server", "action", __func__, "reason", result.error().message()});
+        return nullptr;
+    }
+    ++served_requests_;
+    served_headers_ += payload.stored_headers_.size();
+    return message;
+}
+
+}  // namespace znode::net
@@ -0,0 +1,90 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <infra/database/header_index.hpp>
+#include <infra/database/mdbx.hpp>
+#include <infra/network/message.hpp>
+#include <infra/network/payloads.hpp>
+
+namespace znode::net {
+
+//! \brief Answers getheaders requests with the headers persisted in chaindata
+//! \details The locator is resolved against the in memory HeaderIndex and up to kMaxHeadersItems headers are streamed
+//! from a read-only cursor on Headers table straight into the frame of the reply : no BlockHeader is built.
+//! Each peer is granted a budget of requests (token bucket) so that a single peer can't keep the threads serving
+//! requests busy
+//! \remarks Is thread safe
+//! \attention The index is never reloaded : writers of headers must keep it in sync (see db::HeadersWriter)
+class HeadersServer {
+  public:
+    static constexpr uint32_t kDefaultBurst{32};              // Max number of requests served back to back
+    static constexpr double kDefaultRequestsPerSecond{20.0};  // Sustained requests rate per peer
+
+    HeadersServer(mdbx::env chaindata_env, const db::HeaderIndex& header_index, std::array<uint8_t, 4> network_magic,
+                  uint32_t burst = kDefaultBurst, double requests_per_second = kDefaultRequestsPerSecond);
+    ~HeadersServer() = default;
+
+    // Not copyable nor movable
+    HeadersServer(const HeadersServer&) = delete;
+    HeadersServer& operator=(const HeadersServer&) = delete;
+
+    //! \brief Returns whether a request from the provided peer can be served now (consumes one token if so)
+    [[nodiscard]] bool admit(int peer_id, std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    //! \brief Drops the rate limiting state of the provided peer (e.g. on disconnection)
+    void forget(int peer_id);
+
+    //! \brief Builds the headers message answering the provided request
+    //! \details Headers served are the ones following the first locator hash found in the index (or genesis) up to
+    //! either the stop hash (when provided and found) or kMaxHeadersItems. An empty headers message means there's
+    //! nothing newer to serve
+    //! \returns The frame ready to be queued (nullptr on serialization errors)
+    //! \remarks Should the database not be readable an exception is thrown
+    [[nodiscard]] std::shared_ptr<const Message> build_response(const MsgGetHeadersPayload& request,
+                                                                int protocol_version);
+
+    [[nodiscard]] size_t served_requests() const noexcept { return served_requests_.load(); }
+    [[nodiscard]] size_t served_headers() const noexcept { return served_headers_.load(); }
+    [[nodiscard]] size_t rejected_requests() const noexcept { return rejected_requests_.load(); }
+
+  private:
+    struct TokenBucket {
+        double tokens{0.0};
+        std::chrono::steady_clock::time_point last_refill{};
+    };
+
+    mdbx::env chaindata_env_;
+    const db::HeaderIndex& header_index_;
+    const std::array<uint8_t, 4> network_magic_;
+    const double burst_;
+    const double requests_per_second_;
+
+    std::mutex buckets_mutex_;                 // Guards access to buckets_
+    std::map<int, TokenBucket> buckets_;       // Rate limiting state by peer id
+    std::atomic_size_t served_requests_{0};    // Number of requests answered
+    std::atomic_size_t served_headers_{0};     // Number of headers served
+    std::atomic_size_t rejected_requests_{0};  // Number of requests rejected by rate limiting
+};
+
+}  // namespace znode::net
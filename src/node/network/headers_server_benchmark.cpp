@@ -0,0 +1,91 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <chrono>
+
+#include <benchmark/benchmark.h>
+
+#include <core/common/random.hpp>
+
+#include <infra/database/access_layer.hpp>
+#include <infra/database/header_index.hpp>
+#include <infra/filesystem/directories.hpp>
+
+#include <node/network/headers_server.hpp>
+
+namespace znode::net {
+
+static constexpr BlockNum kBenchHeadersCount{200'000};
+static constexpr size_t kBenchSolutionSize{1344};  // Equihash 200,9
+
+//! \brief Serves getheaders requests with locators pointing at random heights of a stored chain
+void bench_headers_server(benchmark::State& state) {
+    const TempDirectory tmp_dir{};
+    db::EnvConfig db_config{tmp_dir.path().string(), /*create=*/true};
+    db_config.exclusive = true;
+    auto env{db::open_env(db_config)};
+    const h256 genesis_hash{0x1234};
+    {
+        db::RWTxn txn(env);
+        db::tables::deploy_tables(*txn, db::tables::kChainDataTables);
+        BlockHeader header;
+        header.version = 4;
+        header.bits = 0x1f07ffff;
+        header.solution = Bytes(kBenchSolutionSize, 0x5a);
+        header.parent_hash = genesis_hash;
+        db::HeadersWriter writer(txn, /*batch_size=*/512_MiB);
+        for (BlockNum block_num{1}; block_num <= kBenchHeadersCount; ++block_num) {
+            header.time = block_num;
+            header.parent_hash = writer.write(block_num, header);
+        }
+        writer.flush();
+        txn.commit(/*renew=*/false);
+    }
+
+    db::HeaderIndex header_index(tmp_dir.path() / "headers.idx");
+    {
+        db::ROTxn txn(env);
+        header_index.load(*txn, genesis_hash);
+    }
+    HeadersServer server(env, header_index, {0x01, 0x02, 0x03, 0x04});
+
+    MsgGetHeadersPayload request;
+    request.block_locator_hashes_.resize(1);
+    size_t responses{0};
+    size_t bytes{0};
+    const auto start{std::chrono::steady_clock::now()};
+    for ([[maybe_unused]] auto _ : state) {
+        const auto block_num{randomize<BlockNum>(0U, kBenchHeadersCount - BlockNum{kMaxHeadersItems})};
+        request.block_locator_hashes_[0] = header_index.at(block_num)->header_hash();
+        const auto response{server.build_response(request, kDefaultProtocolVersion)};
+        if (response == nullptr) {
+            state.SkipWithError("Unable to build response");
+            break;
+        }
+        bytes += response->size();
+        ++responses;
+    }
+    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+    state.counters["responses_per_sec"] = static_cast<double>(responses) / elapsed.count();
+    state.counters["headers_per_sec"] = static_cast<double>(server.served_headers()) / elapsed.count();
+    state.counters["avg_response_bytes"] =
+        static_cast<double>(bytes) / static_cast<double>(std::max(responses, size_t{1}));
+}
+
+BENCHMARK(bench_headers_server)->Unit(benchmark::kMicrosecond);
+
+}  // namespace znode::net
@@ -0,0 +1,48 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <infra/network/payloads.hpp>
+
+namespace znode::net {
+
+//! \brief Abstraction over the set of peers block headers can be requested to
+//! \details Decouples the consumers of headers (e.g. the headers stage) from NodeHub so they can be driven
+//! by other (e.g. in-process) peers
+class HeadersSource {
+  public:
+    //! \brief Handler of headers messages received from peers (peer id and payload)
+    using HeadersHandler = std::function<void(int, std::shared_ptr<MsgHeadersPayload>)>;
+
+    virtual ~HeadersSource() = default;
+
+    //! \brief Returns the ids of the peers currently able to serve headers
+    [[nodiscard]] virtual std::vector<int> headers_peers() = 0;
+
+    //! \brief Queues a getheaders request for delivery to the peer with the given id
+    //! \returns Whether the request has been queued
+    [[nodiscard]] virtual bool request_headers(int peer_id, MsgGetHeadersPayload& request) = 0;
+
+    //! \brief Sets the handler of headers messages received from peers (an empty handler detaches the previous one)
+    //! \remarks The handler is invoked from network threads and never from within request_headers. On return the
+    //! previous handler is no longer running (hence its owner can be safely destroyed)
+    virtual void set_headers_handler(HeadersHandler handler) = 0;
+};
+}  // namespace znode::net
@@ -16,6 +16,7 @@
 
 #include "node.hpp"
 
+#include <algorithm>
 #include <list>
 
 #include <absl/strings/str_cat.h>
@@ -38,6 +39,7 @@ using namespace boost;
 using asio::ip::tcp;
 
 std::atomic_int Node::next_node_id_{1};  // Start from 1 for user-friendliness
+ObjectPoolMetrics Node::inbound_messages_pool_metrics_{};
 
 Node::Node(AppSettings& app_settings, std::shared_ptr<Connection> connection_ptr, boost::asio::io_context& io_context,
            boost::asio::ssl::context* ssl_context,                                                  //
@@ -239,36 +241,26 @@ void Node::start_write() {
         return;  // Already writing - the queue will cause this to re-enter automatically
     }
 
-    if (outbound_message_ not_eq nullptr and outbound_message_->data().eof()) {
-        // Don't time ping pong messages
-        if (outbound_message_->get_type() not_eq MessageType::kPing and
-            outbound_message_->get_type() not_eq MessageType::kPong) {
-            last_message_sent_time_.store(std::chrono::steady_clock::now());
-        }
-        outbound_message_start_time_.store(std::chrono::steady_clock::time_point::min());
-        outbound_message_.reset();
-    }
-
-    while (outbound_message_ == nullptr) {
-        // Try to get a new message from the queue
-        const std::scoped_lock lock{outbound_messages_mutex_};
-        if (outbound_messages_queue_.empty()) {
-            is_writing_.exchange(false);
-            return;  // Eventually next message submission to the queue will trigger a new write cycle
+    // Gather as many ready messages as allowed by the limits (in order of priority)
+    // A single message exceeding kMaxBytesPerWrite is sent alone
+    ASSERT(outbound_messages_.empty() and outbound_buffers_.empty());
+    size_t batch_bytes{0};
+    while (outbound_messages_.size() < kMaxMessagesPerWrite and batch_bytes < kMaxBytesPerWrite) {
+        std::shared_ptr<const Message> message{nullptr};
+        for (auto& queue : outbound_messages_queues_) {
+            if (auto item{queue.pop()}; item.has_value()) {
+                message = std::move(*item);
+                break;
+            }
         }
-        outbound_message_ = outbound_messages_queue_.top().first;
-        outbound_messages_queue_.pop();
-        outbound_message_->data().seekg(0);
-    }
+        if (message == nullptr) break;  // No more messages ready
 
-    // If message has been just loaded into the barrel then we must check its validity
-    // against protocol handshake rules
-    if (outbound_message_->data().tellg() == 0) {
-        const auto msg_type{outbound_message_->header().get_type()};
+        // Every message must be checked for validity against protocol handshake rules
+        const auto msg_type{message->header().get_type()};
         const auto command{command_from_message_type(msg_type)};
         if (log::test_verbosity(log::Level::kTrace)) {
             const std::list<std::string> log_params{
-                "action", __func__, "command", command, "size", to_human_bytes(outbound_message_->data().size())};
+                "action", __func__, "command", command, "size", to_human_bytes(message->size())};
             print_log(log::Level::kTrace, log_params);
         }
 
@@ -282,50 +274,52 @@ void Node::start_write() {
                                                         "status", "failure", "reason",  result.error().message()};
                 print_log(log::Level::kError, log_params, "Disconnecting peer but is local fault ...");
             }
-            outbound_message_.reset();
-            is_writing_.exchange(false);
+            end_write();
             asio::post(io_strand_, [self{shared_from_this()}]() { self->stop(); });
             return;
         }
 
+        // Point the buffer sequence directly to the serialized message (no copy)
+        // Note ! Message might be shared among nodes (broadcast) hence we must not alter it
+        const auto data{message->bytes()};
+        ASSERT_POST(not data.empty() and "Must have data to write");
+        outbound_buffers_.emplace_back(data.data(), data.size());
+        batch_bytes += data.size();
+
         // Post actions to take on begin of outgoing message
-        const auto now{std::chrono::steady_clock::now()};
         outbound_message_metrics_[msg_type].count_++;
-        outbound_message_metrics_[msg_type].bytes_ += outbound_message_->data().size();
-        switch (msg_type) {
-            using enum MessageType;
-            case kPing:
-                ping_meter_.start_sample();
-                [[fallthrough]];
-            default:
-                outbound_message_start_time_.store(now);
-                break;
-        }
+        outbound_message_metrics_[msg_type].bytes_ += data.size();
+        if (msg_type == MessageType::kPing) ping_meter_.start_sample();
+        outbound_messages_.push_back(std::move(message));
     }
 
-    // Push remaining data from the current message to the socket
-    const auto bytes_to_write{std::min(kMaxBytesPerIO, outbound_message_->data().avail())};
-    const auto data{outbound_message_->data().read(bytes_to_write)};
-    ASSERT_POST(data and "Must have data to write");
-    send_buffer_.sputn(reinterpret_cast<const char*>(data.value().data()),
-                       static_cast<std::streamsize>(data.value().size()));
+    if (outbound_messages_.empty()) {
+        is_writing_.exchange(false);
+        return;  // Eventually next message submission to the queue will trigger a new write cycle
+    }
 
+    outbound_message_start_time_.store(std::chrono::steady_clock::now());
     auto write_handler{
         [self{shared_from_this()}](const boost::system::error_code& error_code, const size_t bytes_transferred) {
             self->handle_write(error_code, bytes_transferred);
         }};
     if (ssl_stream_ not_eq nullptr) {
-        ssl_stream_->async_write_some(send_buffer_.data(), write_handler);
+        asio::async_write(*ssl_stream_, outbound_buffers_, write_handler);
     } else {
-        connection_ptr_->socket_ptr_->async_write_some(send_buffer_.data(), write_handler);
+        asio::async_write(*connection_ptr_->socket_ptr_, outbound_buffers_, write_handler);
     }
 
     // We let handle_write to deal with re-entering the write cycle
 }
 
 void Node::handle_write(const boost::system::error_code& error_code, size_t bytes_transferred) {
+    if (bytes_transferred > 0U) {
+        traffic_meter_.update_outbound(bytes_transferred);
+        on_data_(DataDirectionMode::kOutbound, bytes_transferred);
+    }
+
     if (not is_running()) {
-        is_writing_.exchange(false);
+        end_write();
         return;
     }
 
@@ -335,32 +329,31 @@ void Node::handle_write(const boost::system::error_code& error_code, size_t byte
                                                     "failure", "reason", error_code.message()};
             print_log(log::Level::kError, log_params, "Disconnecting ...");
         }
-        is_writing_.exchange(false);
+        end_write();
         asio::post(io_strand_, [self{shared_from_this()}]() { self->stop(); });
         return;
     }
 
-    if (bytes_transferred > 0U) {
-        send_buffer_.consume(bytes_transferred);
-        traffic_meter_.update_outbound(bytes_transferred);
-        on_data_(DataDirectionMode::kOutbound, bytes_transferred);
+    // The whole batch has been sent
+    const bool only_ping_pong{std::ranges::all_of(outbound_messages_, [](const auto& message) {
+        const auto msg_type{message->get_type()};
+        return msg_type == MessageType::kPing or msg_type == MessageType::kPong;
+    })};
+    if (not only_ping_pong) {
+        // Don't time ping pong messages
+        last_message_sent_time_.store(std::chrono::steady_clock::now());
     }
+    end_write();
+    asio::post(io_strand_, [self{shared_from_this()}]() { self->start_write(); });
+}
 
-    // If we have sent the whole message then we can start sending the next chunk
-    if (send_buffer_.size() not_eq 0U) {
-        auto write_handler{
-            [self{shared_from_this()}](const boost::system::error_code& _error_code, const size_t _bytes_transferred) {
-                self->handle_write(_error_code, _bytes_transferred);
-            }};
-        if (ssl_stream_ not_eq nullptr) {
-            ssl_stream_->async_write_some(send_buffer_.data(), write_handler);
-        } else {
-            connection_ptr_->socket_ptr_->async_write_some(send_buffer_.data(), write_handler);
-        }
-    } else {
-        is_writing_.exchange(false);
-        asio::post(io_strand_, [self{shared_from_this()}]() { self->start_write(); });
-    }
+void Node::end_write() {
+    // Every exit path of a write cycle must leave the batch empty: a start_write already posted on the strand
+    // might win the is_writing_ exchange right after
+    outbound_message_start_time_.store(std::chrono::steady_clock::time_point::min());
+    outbound_messages_.clear();
+    outbound_buffers_.clear();
+    is_writing_.exchange(false);
 }
 
 outcome::result<void> Node::push_message(MessagePayload& payload, MessagePriority priority) {
@@ -377,12 +370,14 @@ outcome::result<void> Node::push_message(MessagePayload& payload, MessagePriorit
         }
         return result.error();
     }
-    std::unique_lock lock(outbound_messages_mutex_);
-    outbound_messages_queue_.emplace(std::move(new_message), priority);
-    lock.unlock();
+    push_message(std::shared_ptr<const Message>(std::move(new_message)), priority);
+    return outcome::success();
+}
 
+void Node::push_message(std::shared_ptr<const Message> message, MessagePriority priority) {
+    ASSERT_PRE(message not_eq nullptr and "Message must be valid");
+    outbound_messages_queues_[static_cast<size_t>(priority)].push(std::move(message));
     boost::asio::post(io_strand_, [self{shared_from_this()}]() { self->start_write(); });
-    return outcome::success();
 }
 
 outcome::result<void> Node::push_message(const MessageType message_type, MessagePriority priority) {
@@ -397,20 +392,29 @@ outcome::result<void> Node::parse_messages(const size_t bytes_transferred) {
     ByteView data{boost::asio::buffer_cast<const uint8_t*>(receive_buffer_.data()), bytes_transferred};
 
     while (!data.empty()) {
-        if (inbound_message_ == nullptr) {
+        if (inbound_message_start_time_.load() == std::chrono::steady_clock::time_point::min()) {
+            // Beginning of a new message
             inbound_message_start_time_.exchange(std::chrono::steady_clock::now());
-            inbound_message_ = std::make_unique<Message>(version_, app_settings_.chain_config.value().magic_);
+            if (inbound_message_ == nullptr) {
+                inbound_message_ = std::make_unique<Message>(version_, app_settings_.chain_config.value().magic_);
+                ++inbound_messages_pool_metrics_.misses_;
+            } else {
+                inbound_message_->set_version(version_);
+                ++inbound_messages_pool_metrics_.hits_;
+            }
         }
 
         try {
-            success_or_throw(inbound_message_->write(data));  // Note! data is consumed here
+            // Note! data is consumed here and complete frames are parsed in place (no copy)
+            // This is safe as receive_buffer_ is consumed only after all messages have been processed
+            success_or_throw(inbound_message_->write(data, /*in_place=*/true));
 
             msg_type = inbound_message_->get_type();
             success_or_throw(validate_message_for_protocol_handshake(DataDirectionMode::kInbound, msg_type));
             ASSERT(msg_type not_eq MessageType::kMissingOrUnknown and "Must have a valid message type");
 
             StopWatch deserialization_timer(/*auto_start=*/true);
-            auto payload_ptr{MessagePayload::from_type(msg_type)};
+            auto payload_ptr{MessagePayload::acquire(msg_type)};
             if (not payload_ptr) success_or_throw(Error::kMessagePayLoadUnhandleable);
             success_or_throw(payload_ptr->deserialize(inbound_message_->data()));
             const auto deserialization_duration{deserialization_timer.stop()};
@@ -436,8 +440,7 @@ outcome::result<void> Node::parse_messages(const size_t bytes_transferred) {
             success_or_throw(process_inbound_message(std::move(payload_ptr)));
             inbound_message_metrics_[msg_type].count_++;
             inbound_message_metrics_[msg_type].bytes_ += inbound_message_->data().size();
-            inbound_message_.reset();
-            inbound_message_start_time_.exchange(std::chrono::steady_clock::time_point::min());
+            recycle_inbound_message();
 
         } catch (const boost::system::system_error& error) {
             if (error.code() == Error::kMessageHeaderIncomplete or error.code() == Error::kMessageBodyIncomplete) {
@@ -450,8 +453,7 @@ outcome::result<void> Node::parse_messages(const size_t bytes_transferred) {
                          {"id", std::to_string(node_id_), "remote", to_string(), "action", __func__, "command",
                           command_from_message_type(msg_type, false), "status", "failure", "reason", error.what()});
             result = error.code();
-            inbound_message_.reset();
-            inbound_message_start_time_.exchange(std::chrono::steady_clock::time_point::min());
+            recycle_inbound_message();
             break;
         }
     }
@@ -459,6 +461,17 @@ outcome::result<void> Node::parse_messages(const size_t bytes_transferred) {
     return result;
 }
 
+void Node::recycle_inbound_message() noexcept {
+    if (inbound_message_ not_eq nullptr) {
+        if (inbound_message_->size() > kMaxRecycledMessageSize) {
+            inbound_message_.reset(nullptr);
+        } else {
+            inbound_message_->reset();
+        }
+    }
+    inbound_message_start_time_.exchange(std::chrono::steady_clock::time_point::min());
+}
+
 outcome::result<void> Node::process_inbound_message(std::shared_ptr<MessagePayload> payload_ptr) {
     outcome::result<void> result{outcome::success()};
     std::string err_extended_reason{};
@@ -16,12 +16,12 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <functional>
 #include <list>
 #include <map>
 #include <memory>
-#include <queue>
 #include <utility>
 #include <vector>
 
@@ -31,6 +31,8 @@
 #include <openssl/ssl.h>
 
 #include <core/common/base.hpp>
+#include <core/common/mpsc_queue.hpp>
+#include <core/common/object_pool.hpp>
 
 #include <infra/common/settings.hpp>
 #include <infra/concurrency/timer.hpp>
@@ -63,6 +65,16 @@ static constexpr size_t kMaxMessagesPerRead = 32;
 //! \brief Maximum number of bytes to read/write in a single operation
 static constexpr size_t kMaxBytesPerIO = 16_KiB;
 
+//! \brief Maximum number of queued messages gathered into a single write operation
+static constexpr size_t kMaxMessagesPerWrite = 32;
+
+//! \brief Maximum number of bytes gathered into a single write operation
+//! \remarks A single message larger than this is written alone
+static constexpr size_t kMaxBytesPerWrite = 64_KiB;
+
+//! \brief Maximum size of an inbound message whose buffer is retained for reuse by the next message
+static constexpr size_t kMaxRecycledMessageSize = 256_KiB;
+
 //! \brief A node holds a connection (and related session) to a remote peer
 class Node : public con::Stoppable, public std::enable_shared_from_this<Node> {
   public:
@@ -142,9 +154,17 @@ class Node : public con::Stoppable, public std::enable_shared_from_this<Node> {
     //! \return The string representation of the remote endpoint
     [[nodiscard]] std::string to_string() const noexcept;
 
+    //! \return The protocol version negotiated with the remote node
+    [[nodiscard]] int protocol_version() const noexcept { return version_.load(); }
+
     //! \return The next available node id
     [[nodiscard]] static int next_node_id() noexcept { return next_node_id_.fetch_add(1); }
 
+    //! \return The metrics of inbound messages recycling (across all nodes)
+    [[nodiscard]] static const ObjectPoolMetrics& inbound_messages_pool_metrics() noexcept {
+        return inbound_messages_pool_metrics_;
+    }
+
     //! \brief Creates a new network message to be queued for delivery to the remote node
     outcome::result<void> push_message(MessagePayload& payload, MessagePriority priority = MessagePriority::kNormal);
 
@@ -152,7 +172,14 @@ class Node : public con::Stoppable, public std::enable_shared_from_this<Node> {
     //! \remarks This a handy overload used to async_send messages with a null payload
     outcome::result<void> push_message(MessageType message_type, MessagePriority priority = MessagePriority::kNormal);
 
+    //! \brief Queues an already serialized network message for delivery to the remote node
+    //! \remarks The message is not altered hence it can be shared among many nodes (see NodeHub::broadcast)
+    //! \attention The message MUST have been serialized with the protocol version negotiated by this node
+    void push_message(std::shared_ptr<const Message> message, MessagePriority priority = MessagePriority::kNormal);
+
   private:
+    friend struct NodeInspector;  // Unit tests access to the internal data structures
+
     void start_ssl_handshake();
     void handle_ssl_handshake(const boost::system::error_code& error_code);
 
@@ -165,6 +192,10 @@ class Node : public con::Stoppable, public std::enable_shared_from_this<Node> {
     outcome::result<void> parse_messages(
         size_t bytes_transferred);  // Reads messages from the receiving buffer and consumes buffered data
 
+    //! \brief Resets the inbound message for reuse by the next one
+    //! \remarks Messages which have grown beyond kMaxRecycledMessageSize are released instead
+    void recycle_inbound_message() noexcept;
+
     outcome::result<void> process_inbound_message(
         std::shared_ptr<MessagePayload> payload_ptr);  // Local processing (when possible) of inbound message
 
@@ -180,6 +211,7 @@ class Node : public con::Stoppable, public std::enable_shared_from_this<Node> {
 
     void start_write();  // Begin writing to the socket asynchronously
     void handle_write(const boost::system::error_code& error_code, size_t bytes_transferred);  // Async write handler
+    void end_write();  // Releases the current batch and ends the write cycle
 
     void on_stop_completed() noexcept;  // Called when the node is stopped
 
@@ -215,27 +247,22 @@ class Node : public con::Stoppable, public std::enable_shared_from_this<Node> {
         on_disconnected_;  // Called when node gets disconnected (either by us or by the remote peer)
 
     boost::asio::streambuf receive_buffer_;  // Socket async_receive buffer
-    boost::asio::streambuf send_buffer_;     // Socket async_send buffer
 
     std::atomic<std::chrono::steady_clock::time_point> inbound_message_start_time_{
         std::chrono::steady_clock::time_point::min()};   // Start time of inbound msg
-    std::unique_ptr<Message> inbound_message_{nullptr};  // The "next" message being received
+    std::unique_ptr<Message> inbound_message_{nullptr};  // The "next" message being received (recycled)
 
     std::atomic_bool is_writing_{false};  // Whether a write operation is in progress
     std::atomic<std::chrono::steady_clock::time_point> outbound_message_start_time_{
         std::chrono::steady_clock::time_point::min()};  // Start time of outbound msg
 
-    using message_queue_item = std::pair<std::shared_ptr<Message>, MessagePriority>;
-    struct MessageQueueItemComparator {
-        bool operator()(const message_queue_item& lhs, const message_queue_item& rhs) const {
-            return static_cast<int>(lhs.second) < static_cast<int>(rhs.second);
-        }
-    };
-    std::priority_queue<message_queue_item, std::vector<message_queue_item>, MessageQueueItemComparator>
-        outbound_messages_queue_{};  // Queue of messages awaiting to be sent
+    //! \brief Queues of messages awaiting to be sent (one per priority level, drained in order of priority)
+    //! \remarks Messages with same priority are sent in FIFO order
+    std::array<MpscQueue<std::shared_ptr<const Message>>, static_cast<size_t>(MessagePriority::kLow) + 1>
+        outbound_messages_queues_{};
 
-    std::shared_ptr<Message> outbound_message_{nullptr};  // The "next" message being sent
-    std::mutex outbound_messages_mutex_{};                // Lock guard for messages to be sent
+    std::vector<std::shared_ptr<const Message>> outbound_messages_{};  // The batch of messages being sent
+    std::vector<boost::asio::const_buffer> outbound_buffers_{};         // Gathered views over outbound_messages_ data
 
     MsgVersionPayload local_version_{};   // Local protocol version
     MsgVersionPayload remote_version_{};  // Remote protocol version
@@ -247,5 +274,6 @@ class Node : public con::Stoppable, public std::enable_shared_from_this<Node> {
 
     std::map<MessageType, MessageMetrics> inbound_message_metrics_{};   // Stats for each message type
     std::map<MessageType, MessageMetrics> outbound_message_metrics_{};  // Stats for each message type
+    static ObjectPoolMetrics inbound_messages_pool_metrics_;            // Stats for inbound messages recycling
 };
 }  // namespace znode::net
@@ -0,0 +1,128 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <core/common/mpsc_queue.hpp>
+
+#include <infra/network/message.hpp>
+
+namespace znode::net {
+
+static constexpr size_t kItemsPerProducer{20'000};
+static constexpr size_t kPriorities{static_cast<size_t>(MessagePriority::kLow) + 1};
+
+//! \brief The outbound queue as it used to be: a priority queue guarded by a mutex
+class LockedOutboundQueue {
+  public:
+    void push(std::shared_ptr<Message> message, MessagePriority priority) {
+        const std::scoped_lock lock{mutex_};
+        queue_.emplace(std::move(message), priority);
+    }
+    std::shared_ptr<Message> pop() {
+        const std::scoped_lock lock{mutex_};
+        if (queue_.empty()) return nullptr;
+        auto ret{queue_.top().first};
+        queue_.pop();
+        return ret;
+    }
+
+  private:
+    using item_type = std::pair<std::shared_ptr<Message>, MessagePriority>;
+    struct Comparator {
+        bool operator()(const item_type& lhs, const item_type& rhs) const {
+            return static_cast<int>(lhs.second) < static_cast<int>(rhs.second);
+        }
+    };
+    std::mutex mutex_;
+    std::priority_queue<item_type, std::vector<item_type>, Comparator> queue_;
+};
+
+//! \brief The outbound queues as in Node: one lock-free MPSC queue per priority
+class LockFreeOutboundQueue {
+  public:
+    void push(std::shared_ptr<Message> message, MessagePriority priority) {
+        queues_[static_cast<size_t>(priority)].push(std::move(message));
+    }
+    std::shared_ptr<Message> pop() {
+        for (auto& queue : queues_) {
+            if (auto item{queue.pop()}; item.has_value()) return std::move(*item);
+        }
+        return nullptr;
+    }
+
+  private:
+    std::array<MpscQueue<std::shared_ptr<Message>>, kPriorities> queues_;
+};
+
+//! \brief Many producers (range(0) threads) push messages while a single consumer drains them
+template <typename Queue>
+void bench_outbound_queue(benchmark::State& state) {
+    using namespace std::chrono;
+    const auto producers_count{static_cast<size_t>(state.range(0))};
+    const auto total_items{producers_count * kItemsPerProducer};
+
+    // Messages are shared among pushes: we're measuring the queue not the allocation of messages
+    std::array<std::shared_ptr<Message>, kPriorities> messages{};
+    for (auto& message : messages) message = std::make_shared<Message>();
+
+    std::vector<int64_t> latencies(total_items);  // Enqueue latencies in ns
+    std::vector<int64_t> p99_latencies;
+    for ([[maybe_unused]] auto _ : state) {
+        Queue queue;
+        std::vector<std::thread> producers;
+        const auto start{steady_clock::now()};
+        for (size_t producer{0}; producer < producers_count; ++producer) {
+            producers.emplace_back([&, producer]() {
+                for (size_t i{0}; i < kItemsPerProducer; ++i) {
+                    const auto priority_index{i % kPriorities};
+                    const auto push_start{steady_clock::now()};
+                    queue.push(messages[priority_index], static_cast<MessagePriority>(priority_index));
+                    latencies[producer * kItemsPerProducer + i] =
+                        duration_cast<nanoseconds>(steady_clock::now() - push_start).count();
+                }
+            });
+        }
+        size_t popped{0};
+        while (popped < total_items) {
+            if (queue.pop() not_eq nullptr) ++popped;
+        }
+        for (auto& producer : producers) producer.join();
+        state.SetIterationTime(duration<double>(steady_clock::now() - start).count());
+
+        const auto p99_it{latencies.begin() + static_cast<std::ptrdiff_t>(total_items * 99 / 100)};
+        std::nth_element(latencies.begin(), p99_it, latencies.end());
+        p99_latencies.push_back(*p99_it);
+    }
+
+    std::ranges::sort(p99_latencies);
+    state.counters["p99_enqueue_ns"] = static_cast<double>(p99_latencies[p99_latencies.size() / 2]);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(total_items));
+}
+
+BENCHMARK_TEMPLATE(bench_outbound_queue, LockedOutboundQueue)->RangeMultiplier(2)->Range(1, 16)->UseManualTime();
+BENCHMARK_TEMPLATE(bench_outbound_queue, LockFreeOutboundQueue)->RangeMultiplier(2)->Range(1, 16)->UseManualTime();
+
+}  // namespace znode::net
@@ -16,6 +16,10 @@
 
 #include "node_hub.hpp"
 
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <map>
 #include <utility>
 
 #include <absl/strings/str_cat.h>
@@ -55,6 +59,19 @@ bool NodeHub::start() noexcept {
         tls_client_context_ = std::make_unique<asio::ssl::context>(ctx);
     }
 
+    // Open the node data environment : it stays open till stop
+    try {
+        auto& env_config{app_settings_.nodedata_env_config};
+        env_config.path = (*app_settings_.data_directory)[DataDirectory::kNodesName].path().string();
+        env_config.create = !std::filesystem::exists(db::get_datafile_path(env_config.path));
+        env_config.exclusive = true;
+        log::Info("Opening database", {"path", env_config.path});
+        node_data_env_ = db::open_env(env_config);
+    } catch (const std::exception& ex) {
+        log::Error("NodeHub", {"action", "start", "error", ex.what()});
+        return false;
+    }
+
     // Load address book
     address_book_.start();
     address_book_.load();
@@ -71,6 +88,7 @@ bool NodeHub::start() noexcept {
     asio::co_spawn(asio_context_, connector_work(), asio::detached);
     asio::co_spawn(asio_context_, address_book_selector_work(), asio::detached);
     asio::co_spawn(asio_context_, address_book_processor_work(), asio::detached);
+    asio::co_spawn(asio_context_, headers_server_work(), asio::detached);
 
     resolve_task.wait();
     log::Info("Service", {"name", "Node Hub", "action", "start", "advertising address",
@@ -90,6 +108,7 @@ bool NodeHub::stop() noexcept {
         connector_feed_.close();
         need_connections_.close();
         address_book_processor_feed_.close();
+        headers_server_feed_.close();
 
         // We MUST wait for all nodes to stop before returning otherwise
         // this instance falls out of scope and the nodes call a callback
@@ -104,8 +123,9 @@ bool NodeHub::stop() noexcept {
 
         service_timer_.stop();
         info_timer_.stop();
-        address_book_.stop();
-        address_book_.save();
+        address_book_.stop();  // Also saves the address book
+        log::Info("Closing database", {"path", app_settings_.nodedata_env_config.path});
+        node_data_env_.close();
 
         set_stopped();
     }
@@ -119,6 +139,43 @@ NodeService NodeHub::get_local_service() const {
     return ret;
 }
 
+size_t NodeHub::broadcast(MessagePayload& payload, MessagePriority priority) {
+    std::vector<std::shared_ptr<Node>> nodes;
+    std::unique_lock lock(nodes_mutex_);
+    nodes.reserve(nodes_.size());
+    std::ranges::copy_if(nodes_, std::back_inserter(nodes),
+                         [](const auto& node_ptr) { return node_ptr->fully_connected(); });
+    lock.unlock();
+    return broadcast(payload, nodes, priority);
+}
+
+size_t NodeHub::broadcast(MessagePayload& payload, const std::vector<std::shared_ptr<Node>>& nodes,
+                          MessagePriority priority) {
+    // Network magic is the same for all nodes (it's given by the chain) hence frames only vary by protocol version
+    // A nullptr frame marks a version the payload failed to be serialized for
+    std::map<int, std::shared_ptr<const Message>> frames;
+    size_t ret{0};
+    for (const auto& node_ptr : nodes) {
+        if (node_ptr == nullptr or not node_ptr->fully_connected()) continue;
+        const auto version{node_ptr->protocol_version()};
+        auto frame_it{frames.find(version)};
+        if (frame_it == frames.end()) {
+            auto message{std::make_shared<Message>(version, app_settings_.chain_config->magic_)};
+            if (const auto result{message->push(payload)}; result.has_error()) {
+                log::Error("Service", {"name", "Node Hub", "action", __func__, "message",
+                                       std::string(magic_enum::enum_name(payload.type())), "version",
+                                       std::to_string(version), "reason", result.error().message()});
+                message.reset();
+            }
+            frame_it = frames.emplace(version, std::move(message)).first;
+        }
+        if (frame_it->second == nullptr) continue;
+        node_ptr->push_message(frame_it->second, priority);
+        ++ret;
+    }
+    return ret;
+}
+
 Task<void> NodeHub::node_factory_work() {
     std::ignore = log::Trace("Service", {"name", "Node Hub", "component", "node_factory", "status", "started"});
 
@@ -271,7 +328,7 @@ Task<void> NodeHub::address_book_processor_work() {
     using namespace std::chrono_literals;
     std::ignore = log::Trace("Service", {"name", "Node Hub", "component", "address book", "status", "started"});
     while (is_running()) {
-        // Poll channel for any queued address to connect to
+        // Poll channel for any queued message
         boost::system::error_code error;
         NodeAndPayload item{nullptr, nullptr};
         if (not address_book_processor_feed_.try_receive(item)) {
@@ -280,42 +337,79 @@ Task<void> NodeHub::address_book_processor_work() {
             item = result.value();
         }
         if (!is_running()) break;
-        auto [node_ptr, payload_ptr] = std::move(item);
-        if (node_ptr == nullptr or payload_ptr == nullptr) continue;
 
-        try {
-            switch (payload_ptr->type()) {
-                case MessageType::kAddr: {
-                    auto& payload = dynamic_cast<MsgAddrPayload&>(*payload_ptr);
-                    payload.shuffle();
-                    std::ignore =
-                        address_book_.insert_or_update(payload.identifiers_, node_ptr->remote_endpoint().address_, 2h);
-                } break;
-                case MessageType::kGetAddr: {
-                    auto services{address_book_.get_random_services(kMaxAddrItems, 25)};
-                    if (services.empty()) {
-                        std::ignore = node_ptr->push_message(MessageType::kNotFound);
-                    } else {
-                        log::Info("Service", {"name", "Node Hub", "action", "address book", "remote",
-                                              node_ptr->to_string(), "count", std::to_string(services.size())})
-                            << "Sending ...";
-                        MsgAddrPayload payload{};
-                        payload.identifiers_.swap(services);
-                        std::ignore = node_ptr->push_message(payload);
-                    }
-                } break;
-                default:
-                    ASSERT(false and "Should not happen");
+        // Drain whatever else is already queued : addr messages are ingested all at once so that the address book
+        // is exclusively locked only once
+        std::vector<NodeAndPayload> items{std::move(item)};
+        while (items.size() < kAddressBookBatchSize and address_book_processor_feed_.try_receive(item)) {
+            items.push_back(std::move(item));
+        }
+
+        std::vector<AddressBook::Advertisement> advertisements;
+        for (auto& [node_ptr, payload_ptr] : items) {
+            if (node_ptr == nullptr or payload_ptr == nullptr) continue;
+            try {
+                switch (payload_ptr->type()) {
+                    case MessageType::kAddr: {
+                        auto& payload = dynamic_cast<MsgAddrPayload&>(*payload_ptr);
+                        payload.shuffle();
+                        advertisements.push_back({payload.identifiers_, node_ptr->remote_endpoint().address_});
+                    } break;
+                    case MessageType::kGetAddr: {
+                        auto services{address_book_.get_random_services(kMaxAddrItems, 25)};
+                        if (services.empty()) {
+                            std::ignore = node_ptr->push_message(MessageType::kNotFound);
+                        } else {
+                            log::Info("Service", {"name", "Node Hub", "action", "address book", "remote",
+                                                  node_ptr->to_string(), "count", std::to_string(services.size())})
+                                << "Sending ...";
+                            MsgAddrPayload payload{};
+                            payload.identifiers_.swap(services);
+                            std::ignore = node_ptr->push_message(payload);
+                        }
+                    } break;
+                    default:
+                        ASSERT(false and "Should not happen");
+                }
+            } catch (const std::invalid_argument& ex) {
+                log::Warning("Service", {"name", "Node Hub", "action", "address book", "error", ex.what()});
+                node_ptr->stop();
             }
-        } catch (const std::invalid_argument& ex) {
-            log::Warning("Service", {"name", "Node Hub", "action", "address book", "error", ex.what()});
-            node_ptr->stop();
+        }
+        if (not advertisements.empty()) {
+            std::ignore = address_book_.insert_or_update(advertisements, 2h);
         }
     }
     std::ignore = log::Trace("Service", {"name", "Node Hub", "component", "address book", "status", "stopped"});
     co_return;
 }
 
+Task<void> NodeHub::headers_server_work() {
+    std::ignore = log::Trace("Service", {"name", "Node Hub", "component", "headers server", "status", "started"});
+    while (is_running()) {
+        boost::system::error_code error;
+        NodeAndPayload item{nullptr, nullptr};
+        if (not headers_server_feed_.try_receive(item)) {
+            const auto result = co_await headers_server_feed_.async_receive(error);
+            if (error or not result.has_value()) continue;
+            item = result.value();
+        }
+        if (!is_running()) break;
+        auto [node_ptr, payload_ptr] = std::move(item);
+        if (node_ptr == nullptr or payload_ptr == nullptr or not node_ptr->is_running()) continue;
+
+        try {
+            const auto& payload = dynamic_cast<const MsgGetHeadersPayload&>(*payload_ptr);
+            auto response{headers_server_->build_response(payload, node_ptr->protocol_version())};
+            if (response not_eq nullptr) node_ptr->push_message(std::move(response));
+        } catch (const std::exception& ex) {
+            log::Error("Service", {"name", "Node Hub", "action", "headers server", "error", ex.what()});
+        }
+    }
+    std::ignore = log::Trace("Service", {"name", "Node Hub", "component", "headers server", "status", "stopped"});
+    co_return;
+}
+
 Task<void> NodeHub::async_connect(Connection& connection) {
     const auto protocol = connection.endpoint_.address_.get_type() == IPAddressType::kIPv4 ? tcp::v4() : tcp::v6();
     connection.socket_ptr_ = std::make_shared<tcp::socket>(asio_context_);
@@ -428,6 +522,7 @@ void NodeHub::on_service_timer_expired(con::Timer::duration& interval) {
         self_advertise.emplace();
         self_advertise->identifiers_.push_back(get_local_service());
     }
+    std::vector<std::shared_ptr<Node>> self_advertise_targets;
 
     for (auto iterator{nodes_.begin()}; iterator not_eq nodes_.end(); /* !!! no increment !!! */) {
         if ((*iterator)->status() == ComponentStatus::kNotStarted and (*iterator).use_count() == 1) {
@@ -451,7 +546,7 @@ void NodeHub::on_service_timer_expired(con::Timer::duration& interval) {
             (*iterator)->stop();
             if (--shutdown_count == 0) break;
         } else if (self_advertise.has_value() && (*iterator)->connection_duration() > 15min) {
-            std::ignore = (*iterator)->push_message(self_advertise.value());
+            self_advertise_targets.push_back(*iterator);
         }
         ++iterator;
         ++it_index;
@@ -463,6 +558,10 @@ void NodeHub::on_service_timer_expired(con::Timer::duration& interval) {
     }
     lock.unlock();
 
+    if (self_advertise.has_value() and not self_advertise_targets.empty()) {
+        std::ignore = broadcast(self_advertise.value(), self_advertise_targets);
+    }
+
     // Check whether we need to establish new connections
     if (const auto outbounds{current_active_outbound_connections_.load()};
         outbounds < app_settings_.network.min_outgoing_connections and not address_book_.empty()) {
@@ -492,6 +591,12 @@ void NodeHub::on_info_timer_expired(con::Timer::duration& /*interval*/) {
     info_data.insert(info_data.end(), {"speed i/o", absl::StrCat(to_human_bytes(instant_speed_in, true), "s ",
                                                                  to_human_bytes(instant_speed_out, true), "s")});
 
+    const auto& messages_pool{Node::inbound_messages_pool_metrics()};
+    const auto& payloads_pool{MessagePayload::pool_metrics()};
+    info_data.insert(info_data.end(), {"pool hit/miss msg payload",
+                                       absl::StrCat(messages_pool.hits_.load(), "/", messages_pool.misses_.load(), " ",
+                                                    payloads_pool.hits_.load(), "/", payloads_pool.misses_.load())});
+
     std::ignore = log::Info("Network usage", info_data);
 }
 
@@ -613,6 +718,8 @@ void NodeHub::on_node_connected(std::shared_ptr<Node> node_ptr) {
 }
 
 void NodeHub::on_node_disconnected(const Node& node) {
+    if (headers_server_ not_eq nullptr) headers_server_->forget(node.id());
+
     std::unique_lock lock(connected_addresses_mutex_);
     if (auto item{connected_addresses_.find(*node.remote_endpoint().address_)};
         item not_eq connected_addresses_.end()) {
@@ -690,6 +797,19 @@ void NodeHub::on_node_received_message(std::shared_ptr<Node> node_ptr, std::shar
         case kGetHeaders: {
             auto& payload = dynamic_cast<MsgGetHeadersPayload&>(*payload_ptr);
             logger << "items=" << std::to_string(payload.block_locator_hashes_.size());
+            if (headers_server_ == nullptr) break;
+            if (not headers_server_->admit(node_ptr->id())) {
+                logger << " rate limited";
+                break;
+            }
+            std::ignore = headers_server_feed_.try_send(std::make_pair(std::move(node_ptr), std::move(payload_ptr)));
+        } break;
+        case kHeaders: {
+            auto headers_payload_ptr{std::dynamic_pointer_cast<MsgHeadersPayload>(std::move(payload_ptr))};
+            logger << "items=" << std::to_string(headers_payload_ptr->headers_.size());
+            // Invoked under the lock so that a detached handler is guaranteed not to be running anymore
+            std::scoped_lock lock(headers_handler_mutex_);
+            if (headers_handler_) headers_handler_(node_ptr->id(), std::move(headers_payload_ptr));
         } break;
         case kInv: {
             auto& payload = dynamic_cast<MsgInventoryPayload&>(*payload_ptr);
@@ -700,6 +820,40 @@ void NodeHub::on_node_received_message(std::shared_ptr<Node> node_ptr, std::shar
     }
 }
 
+std::vector<int> NodeHub::headers_peers() {
+    std::vector<int> ret;
+    std::scoped_lock lock(nodes_mutex_);
+    for (const auto& node_ptr : nodes_) {
+        if (not node_ptr->fully_connected()) continue;
+        if ((node_ptr->version_info().services_ bitand static_cast<uint64_t>(NodeServicesType::kNodeNetwork)) == 0U)
+            continue;
+        ret.push_back(node_ptr->id());
+    }
+    return ret;
+}
+
+bool NodeHub::request_headers(int peer_id, MsgGetHeadersPayload& request) {
+    std::shared_ptr<Node> target{nullptr};
+    {
+        std::scoped_lock lock(nodes_mutex_);
+        const auto it{
+            std::ranges::find_if(nodes_, [peer_id](const auto& node_ptr) { return node_ptr->id() == peer_id; })};
+        if (it not_eq nodes_.end()) target = *it;
+    }
+    if (target == nullptr or not target->fully_connected()) return false;
+    return not target->push_message(request).has_error();
+}
+
+void NodeHub::set_headers_handler(HeadersHandler handler) {
+    std::scoped_lock lock(headers_handler_mutex_);
+    headers_handler_ = std::move(handler);
+}
+
+void NodeHub::set_headers_server(std::unique_ptr<HeadersServer> server) {
+    ASSERT_PRE(not is_running() and "Must be set before start");
+    headers_server_ = std::move(server);
+}
+
 size_t NodeHub::size() const { return current_active_connections_.load(); }
 
 void NodeHub::set_common_socket_options(tcp::socket& socket) {
@@ -31,12 +31,14 @@
 #include <infra/network/traffic_meter.hpp>
 
 #include <node/network/connection.hpp>
+#include <node/network/headers_server.hpp>
+#include <node/network/headers_source.hpp>
 #include <node/network/node.hpp>
 #include <node/network/secure.hpp>
 
 namespace znode::net {
 
-class NodeHub : public con::Stoppable {
+class NodeHub : public con::Stoppable, public HeadersSource {
   public:
     explicit NodeHub(AppSettings& settings, boost::asio::io_context& io_context)
         : app_settings_{settings},
@@ -49,7 +51,8 @@ class NodeHub : public con::Stoppable {
           node_factory_feed_(io_context.get_executor(), settings.network.max_active_connections),
           connector_feed_(io_context.get_executor(), settings.network.max_active_connections),
           address_book_processor_feed_(io_context.get_executor(), 500),
-          address_book_{settings, io_context} {
+          headers_server_feed_(io_context.get_executor(), 100),
+          address_book_{settings, io_context, node_data_env_} {
         if (app_settings_.network.nonce == 0U) {
             app_settings_.network.nonce = randomize<uint64_t>(/*min=*/1U);
         }
@@ -68,6 +71,35 @@ class NodeHub : public con::Stoppable {
 
     NodeService get_local_service() const;  // Returns a reference to the node service
 
+    //! \brief Queues a message for delivery to all the fully connected nodes
+    //! \returns The number of nodes the message has been queued to
+    size_t broadcast(MessagePayload& payload, MessagePriority priority = MessagePriority::kNormal);
+
+    //! \brief Queues a message for delivery to the provided nodes (those not fully connected are skipped)
+    //! \details The payload is serialized only once for each distinct negotiated protocol version and the resulting
+    //! immutable frame (checksum included) is shared among the queues of all the nodes
+    //! \returns The number of nodes the message has been queued to
+    size_t broadcast(MessagePayload& payload, const std::vector<std::shared_ptr<Node>>& nodes,
+                     MessagePriority priority = MessagePriority::kNormal);
+
+    //! \brief Returns the node data environment for the components in need of small persistent state (e.g. address
+    //! book, ban lists, peer stats)
+    //! \remarks Is open from start() to stop()
+    [[nodiscard]] mdbx::env& node_data_env() noexcept { return node_data_env_; }
+
+    //! \brief Returns the ids of the fully connected nodes serving the full chain
+    [[nodiscard]] std::vector<int> headers_peers() override;
+
+    //! \brief Queues a getheaders request for delivery to the node with the given id
+    [[nodiscard]] bool request_headers(int peer_id, MsgGetHeadersPayload& request) override;
+
+    //! \brief Sets the handler receiving the headers messages from nodes
+    void set_headers_handler(HeadersHandler handler) override;
+
+    //! \brief Sets the server answering getheaders requests from nodes (requests are ignored if none)
+    //! \remarks Must be invoked before start()
+    void set_headers_server(std::unique_ptr<HeadersServer> server);
+
   private:
     void initialize_acceptor();  // Initialize the socket acceptor with local endpoint
 
@@ -85,6 +117,10 @@ class NodeHub : public con::Stoppable {
     //! \details This function will process messages targeting the address book
     Task<void> address_book_processor_work();
 
+    //! \brief Executes the headers server work loop asynchronously
+    //! \details Requests are served one at a time so that answering getheaders never takes more than one thread
+    Task<void> headers_server_work();
+
     //! \brief Asynchronously connects to a remoote endpoint
     Task<void> async_connect(Connection& connection);  // Connects to a remote endpoint
 
@@ -145,8 +181,12 @@ class NodeHub : public con::Stoppable {
     con::Channel<std::shared_ptr<Connection>> connector_feed_;     // Channel for new outgoing connections
 
     using NodeAndPayload = std::pair<std::shared_ptr<Node>, std::shared_ptr<MessagePayload>>;
+    static constexpr size_t kAddressBookBatchSize{16};          // Max messages processed by the address book at once
     con::Channel<NodeAndPayload> address_book_processor_feed_;  // Channel for messages targeting the address book
+    con::Channel<NodeAndPayload> headers_server_feed_;          // Channel for getheaders requests
+    std::unique_ptr<HeadersServer> headers_server_{nullptr};    // Serves getheaders requests
 
+    mdbx::env_managed node_data_env_{};                                 // The node data environment
     net::AddressBook address_book_;                                     // The address book
     mutable std::mutex nodes_mutex_;                                    // Guards access to nodes_
     std::list<std::shared_ptr<Node>> nodes_;                            // All the connected nodes
@@ -160,5 +200,8 @@ class NodeHub : public con::Stoppable {
     size_t total_rejected_connections_{0};
 
     net::TrafficMeter traffic_meter_{};  // Account network traffic
+
+    std::mutex headers_handler_mutex_;  // Guards access to and invocations of headers_handler_
+    HeadersHandler headers_handler_{};  // Consumer of headers messages
 };
 }  // namespace znode::net
@@ -0,0 +1,104 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <catch2/catch.hpp>
+
+#include <core/chain/config.hpp>
+
+#include <node/network/node_hub.hpp>
+
+namespace znode::net {
+
+struct NodeInspector {
+    //! \brief Marks the node as fully connected with the given negotiated protocol version (no I/O involved)
+    static void set_fully_connected(Node& node, int protocol_version) {
+        REQUIRE(node.con::Stoppable::start());
+        node.version_.store(protocol_version);
+        node.protocol_handshake_status_.store(Node::ProtocolHandShakeStatus::kCompleted);
+    }
+
+    //! \brief Pops all the messages queued for delivery
+    static std::vector<std::shared_ptr<const Message>> pop_outbound_messages(Node& node) {
+        std::vector<std::shared_ptr<const Message>> ret;
+        for (auto& queue : node.outbound_messages_queues_) {
+            while (auto message{queue.pop()}) ret.push_back(std::move(*message));
+        }
+        return ret;
+    }
+};
+
+TEST_CASE("NodeHub broadcast", "[network]") {
+    using boost::asio::ip::tcp;
+    AppSettings settings;
+    settings.chain_config = kMainNetConfig;
+    boost::asio::io_context io_context;
+    NodeHub node_hub(settings, io_context);
+
+    // Nodes need connected sockets : remote ends are accepted locally
+    tcp::acceptor acceptor(io_context, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    std::vector<std::shared_ptr<tcp::socket>> remote_sockets;
+    const auto make_node{[&]() {
+        auto connection_ptr{std::make_shared<Connection>(acceptor.local_endpoint(), ConnectionType::kOutbound)};
+        connection_ptr->socket_ptr_ = std::make_shared<tcp::socket>(io_context);
+        connection_ptr->socket_ptr_->connect(acceptor.local_endpoint());
+        remote_sockets.push_back(std::make_shared<tcp::socket>(acceptor.accept()));
+        return std::make_shared<Node>(settings, connection_ptr, io_context, nullptr, nullptr, nullptr, nullptr);
+    }};
+
+    const int other_version{kDefaultProtocolVersion + 1};
+    std::vector<std::shared_ptr<Node>> nodes;
+    for (const auto version : {kDefaultProtocolVersion, other_version, kDefaultProtocolVersion, other_version}) {
+        nodes.push_back(make_node());
+        NodeInspector::set_fully_connected(*nodes.back(), version);
+    }
+    nodes.push_back(make_node());  // Protocol handshake not completed
+    REQUIRE_FALSE(nodes.back()->fully_connected());
+
+    MsgInventoryPayload payload{MessageType::kInv};
+    for (uint64_t i{1}; i <= 20; ++i) {
+        InventoryItem item;
+        item.type_ = InventoryItem::Type::kTx;
+        item.identifier_ = h256(i);
+        payload.items_.push_back(item);
+    }
+    CHECK(node_hub.broadcast(payload, nodes) == 4U);
+
+    // One frame per protocol version shared among the nodes which negotiated it
+    std::map<int, std::set<const Message*>> frames;
+    for (size_t i{0}; i < 4U; ++i) {
+        const auto messages{NodeInspector::pop_outbound_messages(*nodes[i])};
+        REQUIRE(messages.size() == 1U);
+        CHECK(messages[0]->get_version() == nodes[i]->protocol_version());
+        CHECK(messages[0]->get_type() == MessageType::kInv);
+        frames[nodes[i]->protocol_version()].insert(messages[0].get());
+    }
+    CHECK(frames.size() == 2U);
+    CHECK(frames[kDefaultProtocolVersion].size() == 1U);
+    CHECK(frames[other_version].size() == 1U);
+    CHECK(NodeInspector::pop_outbound_messages(*nodes.back()).empty());
+
+    // Release the nodes held by the pending writes
+    for (const auto& node_ptr : nodes) node_ptr->connection().socket_ptr_->close();
+    io_context.run();
+}
+}  // namespace znode::net
@@ -0,0 +1,399 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "headers.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include <core/common/assert.hpp>
+
+#include <infra/common/log.hpp>
+#include <infra/database/stages.hpp>
+
+namespace znode::stages {
+
+using namespace std::chrono_literals;
+
+HeadersStage::HeadersStage(SyncContext* sync_context, AppSettings* node_settings, net::HeadersSource& headers_source,
+                           db::HeaderIndex* header_index)
+    : Stage(sync_context, db::stages::kHeadersKey, node_settings),
+      headers_source_{headers_source},
+      header_index_{header_index} {
+    if (not node_settings_->fake_pow and node_settings_->chain_config.has_value()) {
+        pow_verifier_ = std::make_unique<PowVerifier>(*node_settings_->chain_config);
+    }
+    headers_source_.set_headers_handler([this](int peer_id, std::shared_ptr<net::MsgHeadersPayload> payload) {
+        on_headers(peer_id, std::move(payload));
+    });
+}
+
+HeadersStage::~HeadersStage() { headers_source_.set_headers_handler(nullptr); }
+
+Stage::Result HeadersStage::forward(db::RWTxn& txn) {
+    Stage::Result ret{Stage::Result::kSuccess};
+    operation_ = OperationType::Forward;
+
+    try {
+        throw_if_stopping();
+        if (not node_settings_->chain_config.has_value()) {
+            throw StageError(Stage::Result::kUnknownError, "missing chain config");
+        }
+
+        // Locate the tip we start from
+        const auto genesis_hash{h256::from_hex(node_settings_->chain_config->genesis_hash_, /*reverse=*/true)};
+        if (not genesis_hash) throw StageError(Stage::Result::kBadBlockHash, "invalid genesis hash");
+        const BlockNum previous_progress{get_progress(txn)};
+        BlockNum tip_block_num{previous_progress};
+        h256 tip_hash{};
+        if (tip_block_num == 0U) {
+            tip_hash = genesis_hash.value();
+        } else {
+            const auto tip_header{db::read_header(*txn, tip_block_num)};
+            if (not tip_header) {
+                throw StageError(Stage::Result::kInvalidProgress, "missing header " + std::to_string(tip_block_num));
+            }
+            tip_hash = tip_header->hash();
+        }
+
+        current_block_num_ = tip_block_num;
+        processed_headers_ = 0;
+        {
+            std::scoped_lock log_lock(log_mutex_);
+            last_log_time_ = std::chrono::steady_clock::now();
+            last_log_processed_headers_ = 0;
+        }
+        {
+            std::scoped_lock lock(mutex_);
+            excluded_peers_.clear();
+            reset_pipeline(build_locator(txn, tip_hash, tip_block_num, genesis_hash.value()));
+        }
+
+        db::HeadersWriter writer(txn, node_settings_->batch_size, header_index_);
+        std::optional<BlockNum> fork_point;
+        while (not fork_point.has_value()) {
+            throw_if_stopping();
+            std::deque<HeadersBatch> batches;
+            {
+                std::unique_lock lock(mutex_);
+                expire_requests();
+                if (pending_requests_.empty() and not peers_synced_) dispatch_requests();
+                if (ready_batches_.empty() and not peers_synced_) {
+                    // No peers to request to unless some are busy replying to superseded requests
+                    if (pending_requests_.empty() and superseded_requests_.empty()) break;
+                    batches_cv_.wait_for(lock, 500ms);  // Replies wake us up
+                }
+                batches.swap(ready_batches_);
+                if (batches.empty() and peers_synced_) break;  // Peers have nothing more to serve
+            }
+
+            // Verify proofs of work and linkage then write
+            for (auto& batch : batches) {
+                if (batch.first_block_num <= tip_block_num) {
+                    fork_point = process_rooted_batch(txn, batch, tip_block_num);
+                    if (fork_point.has_value()) break;
+                    continue;
+                }
+                if (batch.first_block_num not_eq tip_block_num + 1U) continue;  // Stale (pipeline has been reset)
+                auto& headers{batch.payload->headers_};
+                std::vector<PowVerifier::Result> pow_results;
+                if (pow_verifier_) pow_results = pow_verifier_->verify(headers);
+
+                std::string_view failure{};
+                for (size_t i{0}; i < headers.size(); ++i) {
+                    if (not pow_results.empty() and pow_results[i] not_eq PowVerifier::Result::kValid) {
+                        failure = "Invalid proof of work";
+                        break;
+                    }
+                    if (headers[i].parent_hash not_eq tip_hash) {
+                        failure = "Unlinked header";
+                        break;
+                    }
+                    tip_hash = writer.write(++tip_block_num, headers[i]);
+                    ++processed_headers_;
+                }
+                current_block_num_ = tip_block_num;
+                update_progress(txn, tip_block_num);
+
+                if (not failure.empty()) {
+                    log::Warning(log_prefix_, {"op", "forward", "peer", std::to_string(batch.peer_id), "block",
+                                               std::to_string(tip_block_num + 1U)})
+                        << failure;
+                    auto locator{build_locator(txn, tip_hash, tip_block_num, genesis_hash.value())};
+                    std::scoped_lock lock(mutex_);
+                    excluded_peers_.insert(batch.peer_id);
+                    reset_pipeline(std::move(locator));
+                    break;  // All following batches are stale
+                }
+            }
+        }
+
+        writer.flush();  // Written headers get indexed once committed
+
+        log::Info(log_prefix_, {"op", "forward", "from", std::to_string(previous_progress), "to",
+                                std::to_string(tip_block_num)});
+        if (fork_point.has_value()) {
+            log::Warning(log_prefix_, {"op", "forward", "fork point", std::to_string(*fork_point)})
+                << "Peers serve a fork of the local chain : requesting unwind";
+            sync_context_->unwind_point = *fork_point;
+        }
+
+    } catch (const StageError& ex) {
+        log::Error(log_prefix_, {"op", "forward", "error", std::string(ex.what())});
+        ret = static_cast<Stage::Result>(ex.err());
+    } catch (const mdbx::exception& ex) {
+        log::Error(log_prefix_, {"op", "forward", "error", std::string(ex.what())});
+        ret = Stage::Result::kDbError;
+    } catch (const std::exception& ex) {
+        log::Error(log_prefix_, {"op", "forward", "error", std::string(ex.what())});
+        ret = Stage::Result::kUnknownError;
+    }
+
+    {
+        std::scoped_lock lock(mutex_);
+        supersede_requests();
+        ready_batches_.clear();
+    }
+    operation_ = OperationType::None;
+    return ret;
+}
+
+Stage::Result HeadersStage::unwind(db::RWTxn& txn) {
+    if (not sync_context_->unwind_point.has_value()) return Stage::Result::kSuccess;
+    const BlockNum to{sync_context_->unwind_point.value()};
+
+    Stage::Result ret{Stage::Result::kSuccess};
+    operation_ = OperationType::Unwind;
+    try {
+        throw_if_stopping();
+        const BlockNum previous_progress{get_progress(txn)};
+        if (to < previous_progress) {
+            db::HeadersWriter writer(txn, node_settings_->batch_size, header_index_);
+            const auto erased{writer.erase(to + 1U)};
+            update_progress(txn, to);
+            writer.flush();  // Erased headers are dropped from the index once committed
+            current_block_num_ = to;
+            log::Info(log_prefix_, {"op", "unwind", "from", std::to_string(previous_progress), "to",
+                                    std::to_string(to), "erased", std::to_string(erased)});
+        }
+    } catch (const StageError& ex) {
+        log::Error(log_prefix_, {"op", "unwind", "error", std::string(ex.what())});
+        ret = static_cast<Stage::Result>(ex.err());
+    } catch (const mdbx::exception& ex) {
+        log::Error(log_prefix_, {"op", "unwind", "error", std::string(ex.what())});
+        ret = Stage::Result::kDbError;
+    } catch (const std::exception& ex) {
+        log::Error(log_prefix_, {"op", "unwind", "error", std::string(ex.what())});
+        ret = Stage::Result::kUnknownError;
+    }
+    operation_ = OperationType::None;
+    return ret;
+}
+
+Stage::Result HeadersStage::prune(db::RWTxn& /*txn*/) {
+    return Stage::Result::kSuccess;  // Headers are never pruned
+}
+
+std::vector<std::string> HeadersStage::get_log_progress() {
+    std::scoped_lock lock(log_mutex_);
+    const auto now{std::chrono::steady_clock::now()};
+    const auto processed_headers{processed_headers_.load()};
+    if (processed_headers < last_log_processed_headers_) last_log_processed_headers_ = 0;  // New cycle
+
+    double headers_per_second{0.0};
+    const std::chrono::duration<double> elapsed{now - last_log_time_};
+    if (elapsed.count() > 0.0) {
+        headers_per_second = static_cast<double>(processed_headers - last_log_processed_headers_) / elapsed.count();
+    }
+    last_log_time_ = now;
+    last_log_processed_headers_ = processed_headers;
+    return {"block", std::to_string(current_block_num_.load()), "headers/s",
+            std::to_string(static_cast<uint64_t>(headers_per_second))};
+}
+
+void HeadersStage::on_headers(int peer_id, std::shared_ptr<net::MsgHeadersPayload> payload) {
+    if (operation_ not_eq OperationType::Forward or payload == nullptr) return;
+
+    std::scoped_lock lock(mutex_);
+    if (superseded_requests_.erase(peer_id) not_eq 0U) {
+        // Reply to a request somebody else has answered : the peer can be requested again
+        batches_cv_.notify_one();
+        return;
+    }
+    if (not pending_requests_.contains(peer_id)) return;  // Unsolicited or late reply
+    pending_requests_.erase(peer_id);
+
+    const auto& headers{payload->headers_};
+    if (headers.empty()) {
+        // Peer has nothing newer than the requested tip
+        if (pending_requests_.empty()) peers_synced_ = true;
+        batches_cv_.notify_one();
+        return;
+    }
+    if (headers.front().parent_hash not_eq request_tip_hash_) {
+        // Peers reply from the most recent locator item on their chain : the stage tells a lagging peer from a fork
+        const auto it{std::ranges::find(locator_, headers.front().parent_hash, &Locator::value_type::first)};
+        if (it not_eq locator_.end()) {
+            ready_batches_.push_back(HeadersBatch{peer_id, it->second + 1U, payload});
+            batches_cv_.notify_one();
+            return;
+        }
+        log::Warning(log_prefix_, {"op", "forward", "peer", std::to_string(peer_id)}) << "Unlinked headers";
+        excluded_peers_.insert(peer_id);
+        batches_cv_.notify_one();  // Requests go to other peers once the stage has processed pending batches
+        return;
+    }
+
+    // Optimistically move the tip of requests : full linkage is verified by the stage while writing
+    const HeadersBatch batch{peer_id, request_tip_block_num_ + 1U, payload};
+    const bool more_available{headers.size() == net::kMaxHeadersItems};
+    request_tip_hash_ = headers.back().hash();
+    request_tip_block_num_ += static_cast<BlockNum>(headers.size());
+    locator_.assign(1, {request_tip_hash_, request_tip_block_num_});
+    ready_batches_.push_back(batch);
+
+    // First reply wins : replies from other peers won't link anymore
+    supersede_requests();
+    if (more_available) {
+        dispatch_requests();
+    } else {
+        peers_synced_ = true;
+    }
+    batches_cv_.notify_one();
+}
+
+HeadersStage::Locator HeadersStage::build_locator(db::RWTxn& txn, const h256& tip_hash, BlockNum tip_block_num,
+                                                  const h256& genesis_hash) {
+    Locator ret{{tip_hash, tip_block_num}};
+    BlockNum step{1};
+    for (BlockNum block_num{tip_block_num - std::min(step, tip_block_num)}; block_num > 0U;
+         block_num -= std::min(step, block_num)) {
+        const auto header{db::read_header(*txn, block_num)};
+        if (not header) {
+            throw StageError(Stage::Result::kInvalidProgress, "missing header " + std::to_string(block_num));
+        }
+        ret.emplace_back(header->hash(), block_num);
+        if (ret.size() >= 10U) step *= 2U;
+    }
+    if (tip_block_num not_eq 0U) ret.emplace_back(genesis_hash, 0U);
+    return ret;
+}
+
+std::optional<BlockNum> HeadersStage::process_rooted_batch(db::RWTxn& txn, const HeadersBatch& batch,
+                                                           BlockNum tip_block_num) {
+    const auto& headers{batch.payload->headers_};
+    {
+        std::scoped_lock lock(mutex_);
+        if (locator_.size() == 1U) return std::nullopt;  // Meanwhile other peers have extended our tip
+    }
+
+    // Skip the headers we already have
+    size_t known{0};
+    while (known < headers.size() and batch.first_block_num + known <= tip_block_num and
+           db::read_header_number(*txn, headers[known].hash()) == batch.first_block_num + known) {
+        ++known;
+    }
+    const auto next_block_num{static_cast<BlockNum>(batch.first_block_num + known)};
+
+    if (known == headers.size()) {
+        std::scoped_lock lock(mutex_);
+        if (headers.size() == net::kMaxHeadersItems and locator_.size() > 1U) {
+            // Peer's chain departs from ours further than a batch past the locator item : walk it from here
+            const auto below{[next_block_num](const auto& item) { return item.second < next_block_num; }};
+            locator_.emplace(std::ranges::find_if(locator_, below), headers.back().hash(), next_block_num - 1U);
+        } else {
+            excluded_peers_.insert(batch.peer_id);  // Lagging behind : nothing to download from this peer
+        }
+        return std::nullopt;
+    }
+
+    std::string_view failure{};
+    if (next_block_num > tip_block_num) {
+        failure = "Unlinked header";  // Extends our tip without replying from it
+    } else {
+        std::vector<PowVerifier::Result> pow_results;
+        if (pow_verifier_) pow_results = pow_verifier_->verify(headers);
+        for (size_t i{known}; i < headers.size() and failure.empty(); ++i) {
+            if (not pow_results.empty() and pow_results[i] not_eq PowVerifier::Result::kValid) {
+                failure = "Invalid proof of work";
+            } else if (i not_eq 0U and headers[i].parent_hash not_eq headers[i - 1U].hash()) {
+                failure = "Unlinked header";
+            }
+        }
+    }
+    if (failure.empty()) return next_block_num - 1U;
+
+    log::Warning(log_prefix_, {"op", "forward", "peer", std::to_string(batch.peer_id), "block",
+                               std::to_string(next_block_num)})
+        << failure;
+    std::scoped_lock lock(mutex_);
+    excluded_peers_.insert(batch.peer_id);
+    return std::nullopt;
+}
+
+void HeadersStage::dispatch_requests() {
+    auto peers{headers_source_.headers_peers()};
+    std::erase_if(peers, [this](int peer_id) {
+        return excluded_peers_.contains(peer_id) or pending_requests_.contains(peer_id) or
+               superseded_requests_.contains(peer_id);
+    });
+    if (peers.empty()) return;
+
+    net::MsgGetHeadersPayload request;
+    std::ranges::transform(locator_, std::back_inserter(request.block_locator_hashes_),
+                           [](const auto& item) { return item.first; });
+    const auto now{std::chrono::steady_clock::now()};
+    for (size_t i{0}; i < peers.size() and pending_requests_.size() < kMaxPeersPerRequest; ++i) {
+        const auto peer_id{peers[(next_peer_index_ + i) % peers.size()]};
+        if (headers_source_.request_headers(peer_id, request)) pending_requests_.emplace(peer_id, now);
+    }
+    ++next_peer_index_;  // Spread subsequent requests among peers
+}
+
+void HeadersStage::reset_pipeline(Locator locator) {
+    ASSERT_PRE(not locator.empty());
+    request_tip_hash_ = locator.front().first;
+    request_tip_block_num_ = locator.front().second;
+    locator_ = std::move(locator);
+    supersede_requests();
+    ready_batches_.clear();
+    peers_synced_ = false;
+}
+
+void HeadersStage::expire_requests() {
+    const auto now{std::chrono::steady_clock::now()};
+    // Stale replies never arrived : peers can be requested again
+    std::erase_if(superseded_requests_, [&now](const auto& item) { return now - item.second > kRequestTimeout; });
+    bool expired{false};
+    for (auto it{pending_requests_.begin()}; it not_eq pending_requests_.end();) {
+        if (now - it->second <= kRequestTimeout) {
+            ++it;
+            continue;
+        }
+        superseded_requests_.insert_or_assign(it->first, now);
+        it = pending_requests_.erase(it);
+        expired = true;
+    }
+    if (expired) dispatch_requests();
+}
+
+void HeadersStage::supersede_requests() {
+    const auto now{std::chrono::steady_clock::now()};
+    for (const auto& item : pending_requests_) superseded_requests_.insert_or_assign(item.first, now);
+    pending_requests_.clear();
+}
+
+}  // namespace znode::stages
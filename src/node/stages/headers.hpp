@@ -0,0 +1,131 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <core/chain/pow.hpp>
+#include <core/types/hash.hpp>
+
+#include <infra/database/access_layer.hpp>
+
+#include <node/network/headers_source.hpp>
+#include <node/stages/stage.hpp>
+
+namespace znode::stages {
+
+//! \brief Downloads block headers from peers, verifies their linkage and persists them
+//! \details Requests are pipelined : as soon as a batch of headers links to the requested tip the request for the
+//! next batch is dispatched (from the network thread) while previous batches are verified and written by the stage.
+//! Each request is sent to up to kMaxPeersPerRequest peers at once and the first reply which links wins.
+//! Peers not replying in time are skipped while peers serving headers which don't link are excluded for the rest of
+//! the cycle. The first request carries a locator of the local chain : when peers serve a fork of it the cycle stops
+//! and an unwind to the fork point is requested through SyncContext::unwind_point
+//! \attention Library only : the node binary doesn't run a staged sync loop yet hence nothing instantiates this stage
+//! but tests. Whoever drives it must keep a single instance per HeadersSource (the stage owns its headers handler)
+class HeadersStage final : public Stage {
+  public:
+    static constexpr size_t kMaxPeersPerRequest{2};             // Number of peers the same request is sent to
+    static constexpr std::chrono::seconds kRequestTimeout{10};  // Time after which a pending request is re-issued
+
+    //! \param header_index When provided it's kept in sync with written and unwound headers (e.g. the one a
+    //! HeadersServer resolves locators against)
+    HeadersStage(SyncContext* sync_context, AppSettings* node_settings, net::HeadersSource& headers_source,
+                 db::HeaderIndex* header_index = nullptr);
+    ~HeadersStage() override;
+
+    // Not copyable nor movable
+    HeadersStage(const HeadersStage&) = delete;
+    HeadersStage& operator=(const HeadersStage&) = delete;
+
+    [[nodiscard]] Stage::Result forward(db::RWTxn& txn) final;
+    [[nodiscard]] Stage::Result unwind(db::RWTxn& txn) final;
+    [[nodiscard]] Stage::Result prune(db::RWTxn& txn) final;
+    [[nodiscard]] std::vector<std::string> get_log_progress() final;
+
+  private:
+    //! \brief Hashes and block numbers of headers of the local chain (most recent first)
+    using Locator = std::vector<std::pair<h256, BlockNum>>;
+
+    //! \brief A batch of headers received from a peer and linked to the tip of the request or to a locator item
+    struct HeadersBatch {
+        int peer_id{0};                                   // Id of the peer which served the batch
+        BlockNum first_block_num{0};                      // Block number of the first header in the batch
+        std::shared_ptr<net::MsgHeadersPayload> payload;  // The payload holding the headers
+    };
+
+    //! \brief Builds the locator of the local chain from the provided tip (dense at first then exponentially sparse)
+    [[nodiscard]] static Locator build_locator(db::RWTxn& txn, const h256& tip_hash, BlockNum tip_block_num,
+                                               const h256& genesis_hash);
+
+    //! \brief Handles a batch rooted below the tip of the local chain telling a lagging peer from a fork
+    //! \returns The fork point if the batch holds a valid fork of the local chain
+    [[nodiscard]] std::optional<BlockNum> process_rooted_batch(db::RWTxn& txn, const HeadersBatch& batch,
+                                                               BlockNum tip_block_num);
+
+    //! \brief Handles a headers message received from a peer
+    //! \remarks Invoked from network threads
+    void on_headers(int peer_id, std::shared_ptr<net::MsgHeadersPayload> payload);
+
+    //! \brief Sends the request of headers following locator_ to available peers
+    //! \remarks Requires a lock on mutex_ to be held
+    void dispatch_requests();
+
+    //! \brief Restarts the pipeline of requests from the provided locator discarding all pending data
+    //! \remarks Requires a lock on mutex_ to be held
+    void reset_pipeline(Locator locator);
+
+    //! \brief Re-issues the requests pending for too long to other peers
+    //! \remarks Requires a lock on mutex_ to be held
+    void expire_requests();
+
+    //! \brief Moves all pending requests to the superseded ones (their replies, if any, are to be ignored)
+    //! \remarks Requires a lock on mutex_ to be held
+    void supersede_requests();
+
+    net::HeadersSource& headers_source_;         // Where headers are requested to
+    db::HeaderIndex* header_index_;              // In memory index to keep in sync (if any)
+    std::unique_ptr<PowVerifier> pow_verifier_;  // Verifies proofs of work (unless faked)
+
+    std::mutex mutex_;                        // Guards access to the pipeline state below
+    std::condition_variable batches_cv_;      // Signals the stage about replies (new batches or end of sync)
+    h256 request_tip_hash_{};                 // Hash of the last header received (next request starts from here)
+    BlockNum request_tip_block_num_{0};       // Block number of the last header received
+    Locator locator_;                         // Sent with requests (only the request tip once a reply has linked)
+    std::map<int, std::chrono::steady_clock::time_point> pending_requests_;     // Peer ids with a pending request
+    std::map<int, std::chrono::steady_clock::time_point> superseded_requests_;  // Peer ids owing a stale reply
+    std::deque<HeadersBatch> ready_batches_;  // Batches received and waiting to be written
+    std::set<int> excluded_peers_;            // Peers excluded from requests during this cycle
+    size_t next_peer_index_{0};               // Round-robin index among available peers
+    bool peers_synced_{false};                // Whether a peer has signaled there is nothing more to download
+
+    std::atomic<BlockNum> current_block_num_{0};             // Highest header written
+    std::atomic<size_t> processed_headers_{0};               // Headers written in current cycle
+    std::mutex log_mutex_;                                   // Guards access to log rate computation
+    std::chrono::steady_clock::time_point last_log_time_{};  // Time of last log progress
+    size_t last_log_processed_headers_{0};                   // Processed headers at last log progress
+};
+
+}  // namespace znode::stages
@@ -0,0 +1,280 @@
+/*
+   Copyright 2023 The Znode Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <infra/database/stages.hpp>
+#include <infra/filesystem/directories.hpp>
+
+#include <node/stages/headers.hpp>
+
+namespace znode::stages {
+
+namespace {
+    //! \brief Builds a chain of linked headers following the provided parent
+    //! \remarks Solutions are left empty hence they only pass verification when proofs of work are faked
+    std::vector<BlockHeader> make_chain(const h256& parent_hash, size_t count, uint32_t salt = 0) {
+        std::vector<BlockHeader> ret(count);
+        h256 previous_hash{parent_hash};
+        for (uint32_t i{0}; auto& header : ret) {
+            header.version = 4;
+            header.parent_hash = previous_hash;
+            header.merkle_root = h256(salt);
+            header.time = 1'500'000'000U + i++;
+            header.bits = 0x1f07ffff;
+            previous_hash = header.hash();
+        }
+        return ret;
+    }
+
+    //! \brief Serves headers from a chain per peer replying asynchronously (like network threads do)
+    class FakeHeadersSource : public net::HeadersSource {
+      public:
+        explicit FakeHeadersSource(std::map<int, std::vector<BlockHeader>> chains) { set_chains(std::move(chains)); }
+        ~FakeHeadersSource() override { join(); }
+
+        [[nodiscard]] std::vector<int> headers_peers() override {
+            std::scoped_lock lock(mutex_);
+            std::vector<int> ret;
+            for (const auto& [peer_id, chain] : chains_) ret.push_back(peer_id);
+            return ret;
+        }
+
+        [[nodiscard]] bool request_headers(int peer_id, net::MsgGetHeadersPayload& request) override {
+            std::scoped_lock lock(mutex_);
+            if (not chains_.contains(peer_id) or request.block_locator_hashes_.empty()) return false;
+            ++requests_[peer_id];
+            replies_.emplace_back([this, peer_id, locator{request.block_locator_hashes_}] { reply(peer_id, locator); });
+            return true;
+        }
+
+        void set_headers_handler(HeadersHandler handler) override {
+            std::scoped_lock lock(handler_mutex_);
+            handler_ = std::move(handler);
+        }
+
+        //! \brief Replaces the chains served by peers (e.g. to simulate a reorg)
+        void set_chains(std::map<int, std::vector<BlockHeader>> chains) {
+            join();
+            std::scoped_lock lock(mutex_);
+            chains_ = std::move(chains);
+            hashes_.clear();
+            for (const auto& [peer_id, chain] : chains_) {
+                auto& hashes{hashes_[peer_id]};
+                std::ranges::transform(chain, std::back_inserter(hashes), [](const auto& item) { return item.hash(); });
+            }
+        }
+
+        //! \brief Waits for all pending replies to be delivered
+        void join() {
+            while (true) {
+                std::vector<std::thread> replies;
+                {
+                    std::scoped_lock lock(mutex_);
+                    replies.swap(replies_);
+                }
+                if (replies.empty()) break;
+                for (auto& thread : replies) thread.join();
+            }
+        }
+
+        [[nodiscard]] size_t requests(int peer_id) {
+            std::scoped_lock lock(mutex_);
+            return requests_[peer_id];
+        }
+
+      private:
+        //! \brief Like zend serves the headers following the most recent locator hash on the chain (genesis otherwise)
+        void reply(int peer_id, const std::vector<h256>& locator) {
+            auto payload{std::make_shared<net::MsgHeadersPayload>()};
+            {
+                std::scoped_lock lock(mutex_);
+                const auto& chain{chains_[peer_id]};
+                const auto& hashes{hashes_[peer_id]};
+                size_t first{0};
+                for (const auto& hash : locator) {
+                    if (const auto it{std::ranges::find(hashes, hash)}; it not_eq hashes.end()) {
+                        first = static_cast<size_t>(it - hashes.begin()) + 1U;
+                        break;
+                    }
+                }
+                const auto last{std::min(chain.size(), first + net::kMaxHeadersItems)};
+                payload->headers_.assign(std::next(chain.begin(), static_cast<std::ptrdiff_t>(first)),
+                                         std::next(chain.begin(), static_cast<std::ptrdiff_t>(last)));
+            }
+            // Invoked under its own lock (the handler issues requests) so that a detached handler is not running
+            std::scoped_lock lock(handler_mutex_);
+            if (handler_) handler_(peer_id, std::move(payload));
+        }
+
+        std::mutex mutex_;
+        std::map<int, std::vector<BlockHeader>> chains_;
+        std::map<int, std::vector<h256>> hashes_;
+        std::map<int, size_t> requests_;
+        std::vector<std::thread> replies_;
+        std::mutex handler_mutex_;
+        HeadersHandler handler_;
+    };
+}  // namespace
+
+TEST_CASE("Headers stage", "[stages]") {
+    const TempDirectory tmp_dir{};
+    db::EnvConfig db_config{tmp_dir.path().string(), /*create=*/true};
+    db_config.inmemory = true;
+    auto env{db::open_env(db_config)};
+    db::RWTxn txn(env);
+    db::tables::deploy_tables(*txn, db::tables::kChainDataTables);
+
+    AppSettings settings;
+    settings.chain_config = kMainNetConfig;
+    settings.batch_size = 64_KiB;
+    settings.fake_pow = true;
+    SyncContext sync_context;
+
+    const auto genesis_hash{h256::from_hex(kMainNetConfig.genesis_hash_, /*reverse=*/true)};
+    REQUIRE(genesis_hash);
+    const size_t chain_length{net::kMaxHeadersItems * 2 + 80};
+    const auto chain{make_chain(genesis_hash.value(), chain_length)};
+
+    SECTION("Pipelined download and reorg") {
+        db::HeaderIndex header_index(tmp_dir.path() / "headers.idx");
+        header_index.load(*txn, genesis_hash.value());
+        FakeHeadersSource source({{1, chain}, {2, chain}});
+        HeadersStage stage(&sync_context, &settings, source, &header_index);
+        REQUIRE(stage.start());
+
+        CHECK(stage.forward(txn) == Stage::Result::kSuccess);
+        source.join();
+        CHECK(stage.get_progress(txn) == chain_length);
+        CHECK(header_index.find(chain.back().hash()) == chain_length);
+        CHECK(source.requests(1) + source.requests(2) >= 3U);  // One request per batch at least
+        CHECK(db::read_header_number(*txn, chain.back().hash()) == chain_length);
+        const auto last_header{db::read_header(*txn, chain_length)};
+        REQUIRE(last_header.has_value());
+        CHECK(last_header->hash() == chain.back().hash());
+
+        // Peers switch to a fork of the chain past block 200 : they reply from a locator item below the fork point
+        const BlockNum fork_block_num{200};
+        auto fork{std::vector<BlockHeader>(chain.begin(), std::next(chain.begin(), fork_block_num))};
+        const auto fork_tail{make_chain(fork.back().hash(), 250, /*salt=*/1)};
+        fork.insert(fork.end(), fork_tail.begin(), fork_tail.end());
+        source.set_chains({{1, fork}, {2, fork}});
+
+        CHECK(stage.forward(txn) == Stage::Result::kSuccess);
+        source.join();
+        CHECK(sync_context.unwind_point == fork_block_num);
+        CHECK(stage.get_progress(txn) == chain_length);
+        CHECK(stage.unwind(txn) == Stage::Result::kSuccess);
+        CHECK(stage.get_progress(txn) == fork_block_num);
+        CHECK(db::read_max_header_number(*txn) == fork_block_num);
+        CHECK_FALSE(db::read_header(*txn, fork_block_num + 1).has_value());
+        CHECK_FALSE(db::read_header_number(*txn, chain[fork_block_num].hash()).has_value());
+        CHECK(db::read_header_number(*txn, chain[fork_block_num - 1].hash()) == fork_block_num);
+        CHECK(header_index.size() == fork_block_num + 1);
+        sync_context.unwind_point.reset();
+
+        CHECK(stage.forward(txn) == Stage::Result::kSuccess);
+        source.join();
+        CHECK(stage.get_progress(txn) == fork.size());
+        CHECK(db::read_header_number(*txn, fork_tail.front().hash()) == fork_block_num + 1);
+        CHECK(db::read_header_number(*txn, fork.back().hash()) == fork.size());
+        CHECK_FALSE(db::read_header_number(*txn, chain.back().hash()).has_value());
+        CHECK(header_index.find(fork.back().hash()) == fork.size());
+        CHECK_FALSE(header_index.find(chain.back().hash()).has_value());
+    }
+
+    SECTION("Fork deeper than a batch past a locator item") {
+        // Locator items of a 1200 blocks chain skip from 681 to 169 : peers walk from there to the fork point
+        const auto long_chain{make_chain(genesis_hash.value(), 1'200)};
+        FakeHeadersSource source({{1, long_chain}});
+        HeadersStage stage(&sync_context, &settings, source);
+        REQUIRE(stage.start());
+        CHECK(stage.forward(txn) == Stage::Result::kSuccess);
+        source.join();
+        REQUIRE(stage.get_progress(txn) == 1'200U);
+
+        const BlockNum fork_block_num{500};
+        auto fork{std::vector<BlockHeader>(long_chain.begin(), std::next(long_chain.begin(), fork_block_num))};
+        const auto fork_tail{make_chain(fork.back().hash(), 800, /*salt=*/1)};
+        fork.insert(fork.end(), fork_tail.begin(), fork_tail.end());
+        source.set_chains({{1, fork}});
+
+        CHECK(stage.forward(txn) == Stage::Result::kSuccess);
+        source.join();
+        CHECK(sync_context.unwind_point == fork_block_num);
+        CHECK(stage.get_progress(txn) == 1'200U);
+        CHECK(source.requests(1) >= 3U);
+    }
+
+    SECTION("Lagging and foreign peers") {
+        // Peer 1 is far behind while peer 2 serves the chain of another network : none of them has anything for us
+        FakeHeadersSource seeder({{1, chain}});
+        HeadersStage seeding_stage(&sync_context, &settings, seeder);
+        REQUIRE(seeding_stage.start());
+        CHECK(seeding_stage.forward(txn) == Stage::Result::kSuccess);
+        seeder.join();
+        REQUIRE(seeding_stage.get_progress(txn) == chain_length);
+
+        const auto lagging_chain{std::vector<BlockHeader>(chain.begin(), std::next(chain.begin(), 20))};
+        const auto foreign_chain{make_chain(h256(7), chain_length, /*salt=*/2)};
+        FakeHeadersSource source({{1, lagging_chain}, {2, foreign_chain}});
+        HeadersStage stage(&sync_context, &settings, source);
+        REQUIRE(stage.start());
+
+        CHECK(stage.forward(txn) == Stage::Result::kSuccess);
+        source.join();
+        CHECK_FALSE(sync_context.unwind_point.has_value());
+        CHECK(stage.get_progress(txn) == chain_length);
+        CHECK(source.requests(1) == 1U);  // Excluded once known to be lagging
+        CHECK(source.requests(2) == 1U);  // Excluded for serving unlinked headers
+    }
+
+    SECTION("Unlinked headers") {
+        // Peer 1 serves a chain broken past block 10 : whoever wins the requests the stage ends up on the good chain
+        auto broken_chain{chain};
+        broken_chain[10].parent_hash = h256(1);
+        FakeHeadersSource source({{1, broken_chain}, {2, chain}});
+        HeadersStage stage(&sync_context, &settings, source);
+        REQUIRE(stage.start());
+
+        CHECK(stage.forward(txn) == Stage::Result::kSuccess);
+        source.join();
+        CHECK(stage.get_progress(txn) == chain_length);
+        CHECK(db::read_header_number(*txn, chain[10].hash()) == 11U);
+        CHECK(db::read_header_number(*txn, chain.back().hash()) == chain_length);
+    }
+
+    SECTION("Invalid proof of work") {
+        settings.fake_pow = false;
+        FakeHeadersSource source({{1, chain}});
+        HeadersStage stage(&sync_context, &settings, source);
+        REQUIRE(stage.start());
+
+        CHECK(stage.forward(txn) == Stage::Result::kSuccess);
+        source.join();
+        CHECK(stage.get_progress(txn) == 0U);
+        CHECK_FALSE(db::read_header(*txn, 1).has_value());
+        CHECK(source.requests(1) >= 1U);
+    }
+}
+}  // namespace znode::stages